@@ -0,0 +1,284 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file mta_hal_replay.c
+*
+* mta_hal backend serving the responses of a recording made with --hal-record on a device.
+*
+* Built in place of skeletons/src with "make HAL=replay", or as a libhal_mta.so for an agent with
+* "make replay". The recording is named by MTA_HAL_REPLAY_FILE and loaded on the first call.
+*
+* Calls are matched on the API and its scalar arguments (index, line number, flag, array size). The
+* recorded calls of each match are served in the order they were recorded, starting over after the
+* last one. A call without any match returns RETURN_ERR, and is reported once per API on stderr.
+* With MTA_HAL_REPLAY_LATENCY=1 each call also takes the time the recorded call took.
+*
+* The callback given to mta_hal_LineRegisterStatus_callback_register() is accepted and never called.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mta_hal.h"
+#include "test_probe.h"
+#include "test_record.h"
+
+#define REPLAY_SPIN_NS          (50000ULL)      /*!< Latencies below are waited for by spinning */
+
+/* Recorded calls of one API with the same scalar arguments */
+typedef struct
+{
+    int api;
+    uint64_t key[TEST_RECORD_MAX_ARGS];
+    size_t *pOffsets;
+    uint32_t count;
+    uint32_t size;
+    volatile uint32_t next;
+} replay_group_t;
+
+static struct
+{
+    const uint8_t *pData;
+    size_t size;
+    replay_group_t *pGroups;
+    int numGroups;
+    int firstGroup[TEST_PROBE_API_COUNT];   /*!< Groups of an API are contiguous, -1 when there are none */
+    int numApiGroups[TEST_PROBE_API_COUNT];
+    volatile int reported[TEST_PROBE_API_COUNT];
+    bool latency;
+} gReplay;
+
+static pthread_once_t gLoadOnce = PTHREAD_ONCE_INIT;
+
+static uint64_t replay_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static replay_group_t *replay_group_add(int api, const uint64_t *pKey)
+{
+    replay_group_t *pGroups;
+    int i;
+
+    for (i = 0; i < gReplay.numGroups; i++)
+    {
+        if ((gReplay.pGroups[i].api == api) && (memcmp(gReplay.pGroups[i].key, pKey, sizeof(gReplay.pGroups[i].key)) == 0))
+        {
+            return &gReplay.pGroups[i];
+        }
+    }
+    pGroups = realloc(gReplay.pGroups, sizeof(replay_group_t) * (size_t)(gReplay.numGroups + 1));
+    if (pGroups == NULL)
+    {
+        return NULL;
+    }
+    gReplay.pGroups = pGroups;
+    memset(&pGroups[gReplay.numGroups], 0, sizeof(replay_group_t));
+    pGroups[gReplay.numGroups].api = api;
+    memcpy(pGroups[gReplay.numGroups].key, pKey, sizeof(pGroups[gReplay.numGroups].key));
+    return &pGroups[gReplay.numGroups++];
+}
+
+static int replay_group_compare(const void *pLeft, const void *pRight)
+{
+    return ((const replay_group_t *)pLeft)->api - ((const replay_group_t *)pRight)->api;
+}
+
+static void replay_load(void)
+{
+    const char *pPath = getenv("MTA_HAL_REPLAY_FILE");
+    const char *pLatency = getenv("MTA_HAL_REPLAY_LATENCY");
+    int apiMap[TEST_PROBE_API_COUNT];
+    test_record_header_t header;
+    replay_group_t *pGroup;
+    size_t *pOffsets;
+    struct stat info;
+    size_t offset;
+    int apiCount = 0;
+    int records = 0;
+    int fd;
+    int i;
+
+    for (i = 0; i < TEST_PROBE_API_COUNT; i++)
+    {
+        gReplay.firstGroup[i] = -1;
+    }
+    gReplay.latency = ((pLatency != NULL) && (strcmp(pLatency, "1") == 0));
+    if (pPath == NULL)
+    {
+        fprintf(stderr, "mta_hal_replay: MTA_HAL_REPLAY_FILE not set, every call fails\n");
+        return;
+    }
+    fd = open(pPath, O_RDONLY | O_CLOEXEC);
+    if ((fd < 0) || (fstat(fd, &info) != 0) || (info.st_size == 0))
+    {
+        fprintf(stderr, "mta_hal_replay: unable to read %s, every call fails\n", pPath);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return;
+    }
+    gReplay.size = (size_t)info.st_size;
+    gReplay.pData = mmap(NULL, gReplay.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (gReplay.pData == MAP_FAILED)
+    {
+        gReplay.pData = NULL;
+        fprintf(stderr, "mta_hal_replay: unable to map %s, every call fails\n", pPath);
+        return;
+    }
+
+    offset = test_record_map(gReplay.pData, gReplay.size, apiMap, &apiCount);
+    if (offset == 0)
+    {
+        fprintf(stderr, "mta_hal_replay: %s is not a recording of this version and byte order, every call fails\n", pPath);
+        return;
+    }
+    while ((offset + sizeof(header)) <= gReplay.size)
+    {
+        memcpy(&header, &gReplay.pData[offset], sizeof(header));
+        if ((header.length < sizeof(header)) || ((offset + header.length) > gReplay.size))
+        {
+            /* Truncated by a process killed while writing */
+            break;
+        }
+        if ((header.api < apiCount) && (apiMap[header.api] != TEST_PROBE_API_NONE))
+        {
+            pGroup = replay_group_add(apiMap[header.api], header.key);
+            if (pGroup == NULL)
+            {
+                break;
+            }
+            if (pGroup->count == pGroup->size)
+            {
+                pOffsets = realloc(pGroup->pOffsets, sizeof(size_t) * ((pGroup->size > 0) ? (pGroup->size * 2) : 16));
+                if (pOffsets == NULL)
+                {
+                    break;
+                }
+                pGroup->pOffsets = pOffsets;
+                pGroup->size = (pGroup->size > 0) ? (pGroup->size * 2) : 16;
+            }
+            pGroup->pOffsets[pGroup->count++] = offset;
+            records++;
+        }
+        offset += header.length;
+    }
+
+    /* Place the argument combinations of each API next to each other */
+    qsort(gReplay.pGroups, (size_t)gReplay.numGroups, sizeof(replay_group_t), replay_group_compare);
+    for (i = gReplay.numGroups - 1; i >= 0; i--)
+    {
+        gReplay.firstGroup[gReplay.pGroups[i].api] = i;
+        gReplay.numApiGroups[gReplay.pGroups[i].api]++;
+    }
+    fprintf(stderr, "mta_hal_replay: %d calls of %d argument combinations loaded from %s%s\n", records, gReplay.numGroups,
+            pPath, (gReplay.latency == true) ? ", with their latency" : "");
+}
+
+static void replay_wait_until(uint64_t deadlineNs)
+{
+    struct timespec ts;
+    uint64_t nowNs = replay_now_ns();
+
+    if ((deadlineNs > nowNs) && ((deadlineNs - nowNs) > REPLAY_SPIN_NS))
+    {
+        deadlineNs -= REPLAY_SPIN_NS;
+        ts.tv_sec = (time_t)(deadlineNs / 1000000000ULL);
+        ts.tv_nsec = (long)(deadlineNs % 1000000000ULL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+        {
+        }
+        deadlineNs += REPLAY_SPIN_NS;
+    }
+    while (replay_now_ns() < deadlineNs)
+    {
+    }
+}
+
+static int64_t replay_call(int api, const uintptr_t *pArgs)
+{
+    test_record_header_t header;
+    replay_group_t *pGroup = NULL;
+    uint64_t key[TEST_RECORD_MAX_ARGS];
+    uint64_t startNs = replay_now_ns();
+    size_t offset;
+    uint32_t next;
+    int i;
+
+    pthread_once(&gLoadOnce, replay_load);
+    test_record_key(api, pArgs, key);
+    for (i = 0; i < gReplay.numApiGroups[api]; i++)
+    {
+        if (memcmp(gReplay.pGroups[gReplay.firstGroup[api] + i].key, key, sizeof(key)) == 0)
+        {
+            pGroup = &gReplay.pGroups[gReplay.firstGroup[api] + i];
+            break;
+        }
+    }
+    if (pGroup == NULL)
+    {
+        if (__sync_bool_compare_and_swap(&gReplay.reported[api], 0, 1) != 0)
+        {
+            fprintf(stderr, "mta_hal_replay: %s called with arguments never recorded, returning RETURN_ERR\n",
+                    test_record_api_name(api));
+        }
+        return RETURN_ERR;
+    }
+
+    next = __sync_fetch_and_add(&pGroup->next, 1);
+    offset = pGroup->pOffsets[next % pGroup->count];
+    memcpy(&header, &gReplay.pData[offset], sizeof(header));
+    if (test_record_decode(api, &gReplay.pData[offset + sizeof(header)], header.length - sizeof(header), pArgs) != 0)
+    {
+        return RETURN_ERR;
+    }
+    if (gReplay.latency == true)
+    {
+        replay_wait_until(startNs + header.latencyNs);
+    }
+    return header.result;
+}
+
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    returnType name parameters \
+    { \
+        uintptr_t args[] = { TEST_RECORD_ARGS(arguments) 0 }; \
+        return (returnType)replay_call(TEST_PROBE_ID(name), args); \
+    }
+/* The void APIs register callbacks, written out below */
+#define MTA_HAL_API_VOID(name, parameters, arguments)
+#include "mta_hal_api_list.h"
+
+void mta_hal_LineRegisterStatus_callback_register(mta_hal_getLineRegisterStatus_callback callback_proc)
+{
+    (void)callback_proc;
+}
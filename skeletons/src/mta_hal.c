@@ -19,8 +19,84 @@
 #include <string.h>
 #include <stdlib.h>
 #include <setjmp.h>
+#include <time.h>
 #include "mta_hal.h"
+#include "mta_hal_snapshot.h"
 
+/* The string and buffer APIs are implemented, they are the subject of the fuzz targets of tools/fuzz */
+#define SKELETON_PIN_SIZE (64)
+
+static char gDectPIN[SKELETON_PIN_SIZE] = "0000";
+
+/* After mta_hal_start_provisioning() the first query reports MTA_START and the next MTA_COMPLETE, as a device being polled */
+static MTAMGMT_MTA_STATUS gOperationalStatus = MTA_INIT;
+static MTAMGMT_MTA_PROVISION_STATUS gProvisionStatus = MTA_NON_PROVISIONED;
+
+#define SKELETON_BATTERY_POWER_STATUS "AC"
+#define SKELETON_BATTERY_CONDITION "Good"
+#define SKELETON_BATTERY_STATUS "Idle"
+#define SKELETON_BATTERY_LIFE "Good"
+
+/* Round trip to the MTA daemon emulated by each read of mta_hal_snapshot.h, and once by mta_hal_GetSnapshot(),
+ * in microseconds from MTA_HAL_SKELETON_ROUND_TRIP_US; none by default */
+static long gRoundTripUs = -1;
+
+static void skeleton_round_trip(void)
+{
+  struct timespec delay;
+  const char* pValue;
+
+  if (gRoundTripUs < 0)
+  {
+    pValue = getenv("MTA_HAL_SKELETON_ROUND_TRIP_US");
+    gRoundTripUs = (pValue != NULL) ? atol(pValue) : 0;
+  }
+  if (gRoundTripUs > 0)
+  {
+    delay.tv_sec = gRoundTripUs / 1000000;
+    delay.tv_nsec = (gRoundTripUs % 1000000) * 1000;
+    nanosleep(&delay, NULL);
+  }
+}
+
+/* Copy a value to Val, len is an output only and returns its length */
+static INT skeleton_copy_string(const char* value, CHAR* Val, ULONG* len)
+{
+  size_t length;
+
+  if ((Val == NULL) || (len == NULL))
+  {
+    return RETURN_ERR;
+  }
+  length = strlen(value);
+  memcpy(Val, value, length + 1);
+  *len = (ULONG)length;
+  return RETURN_OK;
+}
+
+/* skeleton_copy_string() behind a round trip, the arguments checked first */
+static INT skeleton_read_string(const char* value, CHAR* Val, ULONG* len)
+{
+  if ((Val == NULL) || (len == NULL))
+  {
+    return RETURN_ERR;
+  }
+  skeleton_round_trip();
+  return skeleton_copy_string(value, Val, len);
+}
+
+/* Reported by mta_hal_getMtaOperationalStatus(), a poll of which completes the provisioning started */
+static MTAMGMT_MTA_STATUS skeleton_operational_status(void)
+{
+  MTAMGMT_MTA_STATUS status = gOperationalStatus;
+
+  if (gOperationalStatus == MTA_START)
+  {
+    gOperationalStatus = MTA_COMPLETE;
+    gProvisionStatus = MTA_PROVISIONED;
+  }
+  return status;
+}
 
 INT mta_hal_InitDB(void)
 {
@@ -31,6 +107,7 @@ INT mta_hal_InitDB(void)
 INT mta_hal_GetDHCPInfo(PMTAMGMT_MTA_DHCP_INFO pInfo)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)pInfo;
   return (INT)0;
 }
@@ -38,6 +115,7 @@ INT mta_hal_GetDHCPInfo(PMTAMGMT_MTA_DHCP_INFO pInfo)
 INT mta_hal_GetDHCPV6Info(PMTAMGMT_MTA_DHCPv6_INFO pInfo)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)pInfo;
   return (INT)0;
 }
@@ -45,6 +123,7 @@ INT mta_hal_GetDHCPV6Info(PMTAMGMT_MTA_DHCPv6_INFO pInfo)
 ULONG mta_hal_LineTableGetNumberOfEntries(void)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   return (ULONG)0;
 }
 
@@ -115,16 +194,29 @@ INT mta_hal_GetDect(PMTAMGMT_MTA_DECT pDect)
 
 INT mta_hal_GetDectPIN(char* pPINString)
 {
-  /*TODO: Implement Me!*/
-  (void)pPINString;
-  return (INT)0;
+  if (pPINString == NULL)
+  {
+    return RETURN_ERR;
+  }
+  memcpy(pPINString, gDectPIN, strlen(gDectPIN) + 1);
+  return RETURN_OK;
 }
 
 INT mta_hal_SetDectPIN(char* pPINString)
 {
-  /*TODO: Implement Me!*/
-  (void)pPINString;
-  return (INT)0;
+  size_t length;
+
+  if (pPINString == NULL)
+  {
+    return RETURN_ERR;
+  }
+  length = strnlen(pPINString, SKELETON_PIN_SIZE);
+  if ((length == 0) || (length == SKELETON_PIN_SIZE) || (strspn(pPINString, "0123456789") != length))
+  {
+    return RETURN_ERR;
+  }
+  memcpy(gDectPIN, pPINString, length + 1);
+  return RETURN_OK;
 }
 
 INT mta_hal_GetHandsets(ULONG* pulCount, PMTAMGMT_MTA_HANDSETS_INFO* ppHandsets)
@@ -213,6 +305,7 @@ INT mta_hal_GetMtaLog(ULONG* Count, PMTAMGMT_MTA_MTALOG_FULL* ppCfg)
 INT mta_hal_BatteryGetInstalled(BOOLEAN* Val)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)Val;
   return (INT)0;
 }
@@ -220,6 +313,7 @@ INT mta_hal_BatteryGetInstalled(BOOLEAN* Val)
 INT mta_hal_BatteryGetTotalCapacity(ULONG* Val)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)Val;
   return (INT)0;
 }
@@ -227,6 +321,7 @@ INT mta_hal_BatteryGetTotalCapacity(ULONG* Val)
 INT mta_hal_BatteryGetActualCapacity(ULONG* Val)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)Val;
   return (INT)0;
 }
@@ -234,6 +329,7 @@ INT mta_hal_BatteryGetActualCapacity(ULONG* Val)
 INT mta_hal_BatteryGetRemainingCharge(ULONG* Val)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)Val;
   return (INT)0;
 }
@@ -241,6 +337,7 @@ INT mta_hal_BatteryGetRemainingCharge(ULONG* Val)
 INT mta_hal_BatteryGetRemainingTime(ULONG* Val)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)Val;
   return (INT)0;
 }
@@ -248,45 +345,35 @@ INT mta_hal_BatteryGetRemainingTime(ULONG* Val)
 INT mta_hal_BatteryGetNumberofCycles(ULONG* Val)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)Val;
   return (INT)0;
 }
 
 INT mta_hal_BatteryGetPowerStatus(CHAR* Val, ULONG* len)
 {
-  /*TODO: Implement Me!*/
-  (void)Val;
-  (void)len;
-  return (INT)0;
+  return skeleton_read_string(SKELETON_BATTERY_POWER_STATUS, Val, len);
 }
 
 INT mta_hal_BatteryGetCondition(CHAR* Val, ULONG* len)
 {
-  /*TODO: Implement Me!*/
-  (void)Val;
-  (void)len;
-  return (INT)0;
+  return skeleton_read_string(SKELETON_BATTERY_CONDITION, Val, len);
 }
 
 INT mta_hal_BatteryGetStatus(CHAR* Val, ULONG* len)
 {
-  /*TODO: Implement Me!*/
-  (void)Val;
-  (void)len;
-  return (INT)0;
+  return skeleton_read_string(SKELETON_BATTERY_STATUS, Val, len);
 }
 
 INT mta_hal_BatteryGetLife(CHAR* Val, ULONG* len)
 {
-  /*TODO: Implement Me!*/
-  (void)Val;
-  (void)len;
-  return (INT)0;
+  return skeleton_read_string(SKELETON_BATTERY_LIFE, Val, len);
 }
 
 INT mta_hal_BatteryGetInfo(PMTAMGMT_MTA_BATTERY_INFO pInfo)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)pInfo;
   return (INT)0;
 }
@@ -322,6 +409,7 @@ INT mta_hal_ClearCalls(ULONG InstanceNumber)
 INT mta_hal_getDhcpStatus(MTAMGMT_MTA_STATUS* output_pIpv4status, MTAMGMT_MTA_STATUS* output_pIpv6status)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)output_pIpv4status;
   (void)output_pIpv6status;
   return (INT)0;
@@ -330,6 +418,7 @@ INT mta_hal_getDhcpStatus(MTAMGMT_MTA_STATUS* output_pIpv4status, MTAMGMT_MTA_ST
 INT mta_hal_getConfigFileStatus(MTAMGMT_MTA_STATUS* poutput_status)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)poutput_status;
   return (INT)0;
 }
@@ -337,6 +426,7 @@ INT mta_hal_getConfigFileStatus(MTAMGMT_MTA_STATUS* poutput_status)
 INT mta_hal_getLineRegisterStatus(MTAMGMT_MTA_STATUS* output_status_array, int array_size)
 {
   /*TODO: Implement Me!*/
+  skeleton_round_trip();
   (void)output_status_array;
   (void)array_size;
   return (INT)0;
@@ -351,23 +441,56 @@ INT mta_hal_devResetNow(BOOLEAN bResetValue)
 
 INT mta_hal_getMtaOperationalStatus(MTAMGMT_MTA_STATUS* operationalStatus)
 {
-  /*TODO: Implement Me!*/
-  (void)operationalStatus;
-  return (INT)0;
+  if (operationalStatus == NULL)
+  {
+    return RETURN_ERR;
+  }
+  skeleton_round_trip();
+  *operationalStatus = skeleton_operational_status();
+  return RETURN_OK;
 }
 
 INT mta_hal_getMtaProvisioningStatus(MTAMGMT_MTA_PROVISION_STATUS* provisionStatus)
 {
-  /*TODO: Implement Me!*/
-  (void)provisionStatus;
-  return (INT)0;
+  if (provisionStatus == NULL)
+  {
+    return RETURN_ERR;
+  }
+  skeleton_round_trip();
+  *provisionStatus = gProvisionStatus;
+  return RETURN_OK;
 }
 
 INT mta_hal_start_provisioning(PMTAMGMT_MTA_PROVISIONING_PARAMS pParameters)
 {
-  /*TODO: Implement Me!*/
-  (void)pParameters;
-  return (INT)0;
+  if ((pParameters == NULL) || ((unsigned int)pParameters->MtaIPMode > (unsigned int)MTA_DUAL_STACK))
+  {
+    return RETURN_ERR;
+  }
+  gOperationalStatus = MTA_START;
+  gProvisionStatus = MTA_NON_PROVISIONED;
+  return RETURN_OK;
+}
+
+/* Prototype of mta_hal_snapshot.h: the values of the individual reads for a single round trip */
+INT mta_hal_GetSnapshot(PMTAMGMT_MTA_SNAPSHOT pSnapshot)
+{
+  ULONG len;
+
+  if (pSnapshot == NULL)
+  {
+    return RETURN_ERR;
+  }
+  skeleton_round_trip();
+  memset(pSnapshot, 0, sizeof(*pSnapshot));
+  /* A read does not advance the provisioning, unlike mta_hal_getMtaOperationalStatus() */
+  pSnapshot->OperationalStatus = gOperationalStatus;
+  pSnapshot->ProvisioningStatus = gProvisionStatus;
+  (void)skeleton_copy_string(SKELETON_BATTERY_POWER_STATUS, pSnapshot->BatteryPowerStatus, &len);
+  (void)skeleton_copy_string(SKELETON_BATTERY_CONDITION, pSnapshot->BatteryCondition, &len);
+  (void)skeleton_copy_string(SKELETON_BATTERY_STATUS, pSnapshot->BatteryStatus, &len);
+  (void)skeleton_copy_string(SKELETON_BATTERY_LIFE, pSnapshot->BatteryLife, &len);
+  return RETURN_OK;
 }
 
 void mta_hal_LineRegisterStatus_callback_register(mta_hal_getLineRegisterStatus_callback callback_proc)
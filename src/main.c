@@ -20,9 +20,12 @@
 #include <ut_log.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include "mta_hal.h"
+#include "test_runner.h"
 
 extern int register_hal_l1_tests( void );
+extern int test_perf_mta_hal_concurrency_client(int argc, char **argv);
 
 int init_mta_hal_init(void)
 {
@@ -43,13 +46,25 @@ int init_mta_hal_init(void)
 
 int main(int argc, char** argv)
 {
+    /* A client process of the concurrency benchmark, which starts the test binary again in this mode */
+    if ((argc > 1) && (strcmp(argv[1], "--concurrency-client") == 0))
+    {
+        return test_perf_mta_hal_concurrency_client(argc - 2, argv + 2);
+    }
+
     printf("In main");
     int registerReturn = 0;
 
+    /* Take the test runner switches off the command line, the remaining switches are for UT_init() */
+    if (test_runner_parse_args(&argc, argv) != 0)
+    {
+        return 1;
+    }
+
     /* Register tests as required, then call the UT-main to support switches and triggering */
     UT_init( argc, argv );
-    /* Check if tests are registered successfully */
-    registerReturn = register_hal_l1_tests();
+    /* Register the tests through the test runner and begin test executions */
+    registerReturn = test_runner_run(register_hal_l1_tests);
     if (registerReturn == 0)
     {
         printf("register_hal_l1_tests() returned success");
@@ -59,9 +74,6 @@ int main(int argc, char** argv)
         printf("register_hal_l1_tests() returned failure");
         return 1;
     }
-
-    /* Begin test executions */
-    UT_run_tests();
     printf("END main");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file mta_hal_api_list.h
+*
+* List of every API declared in mta_hal.h, for expansion with X-macros.
+*
+* The includer defines the macros below before including this file; the file deliberately has no
+* include guard and undefines both macros at the end.
+*
+* - MTA_HAL_API(returnType, name, parameters, arguments) for APIs returning a value
+* - MTA_HAL_API_VOID(name, parameters, arguments) for APIs returning void
+*
+* The Makefile links every API listed here through the call probes in test_probe.c
+* (-Wl,--wrap=name), tools/trace/mta_hal_trace.c interposes every API listed here and
+* replay/src/mta_hal_replay.c implements them; src/test_record.c describes the arguments of each and
+* mta_hal_api_spec.h their valid values, from which src/test_api.c generates tests. Keep one entry per
+* line, starting with the macro name.
+*/
+
+MTA_HAL_API(INT, mta_hal_InitDB, (void), ())
+MTA_HAL_API(INT, mta_hal_GetDHCPInfo, (PMTAMGMT_MTA_DHCP_INFO pInfo), (pInfo))
+MTA_HAL_API(INT, mta_hal_GetDHCPV6Info, (PMTAMGMT_MTA_DHCPv6_INFO pInfo), (pInfo))
+MTA_HAL_API(ULONG, mta_hal_LineTableGetNumberOfEntries, (void), ())
+MTA_HAL_API(INT, mta_hal_LineTableGetEntry, (ULONG Index, PMTAMGMT_MTA_LINETABLE_INFO pEntry), (Index, pEntry))
+MTA_HAL_API(INT, mta_hal_TriggerDiagnostics, (ULONG Index), (Index))
+MTA_HAL_API(INT, mta_hal_GetServiceFlow, (ULONG* Count, PMTAMGMT_MTA_SERVICE_FLOW* ppCfg), (Count, ppCfg))
+MTA_HAL_API(INT, mta_hal_DectGetEnable, (BOOLEAN* pBool), (pBool))
+MTA_HAL_API(INT, mta_hal_DectSetEnable, (BOOLEAN bBool), (bBool))
+MTA_HAL_API(INT, mta_hal_DectGetRegistrationMode, (BOOLEAN* pBool), (pBool))
+MTA_HAL_API(INT, mta_hal_DectSetRegistrationMode, (BOOLEAN bBool), (bBool))
+MTA_HAL_API(INT, mta_hal_DectDeregisterDectHandset, (ULONG uValue), (uValue))
+MTA_HAL_API(INT, mta_hal_GetDect, (PMTAMGMT_MTA_DECT pDect), (pDect))
+MTA_HAL_API(INT, mta_hal_GetDectPIN, (char* pPINString), (pPINString))
+MTA_HAL_API(INT, mta_hal_SetDectPIN, (char* pPINString), (pPINString))
+MTA_HAL_API(INT, mta_hal_GetHandsets, (ULONG* pulCount, PMTAMGMT_MTA_HANDSETS_INFO* ppHandsets), (pulCount, ppHandsets))
+MTA_HAL_API(INT, mta_hal_GetCalls, (ULONG InstanceNumber, ULONG* Count, PMTAMGMT_MTA_CALLS* ppCfg), (InstanceNumber, Count, ppCfg))
+MTA_HAL_API(INT, mta_hal_GetCALLP, (ULONG LineNumber, PMTAMGMT_MTA_CALLP pCallp), (LineNumber, pCallp))
+MTA_HAL_API(INT, mta_hal_GetDSXLogs, (ULONG* Count, PMTAMGMT_MTA_DSXLOG* ppDSXLog), (Count, ppDSXLog))
+MTA_HAL_API(INT, mta_hal_GetDSXLogEnable, (BOOLEAN* pBool), (pBool))
+MTA_HAL_API(INT, mta_hal_SetDSXLogEnable, (BOOLEAN Bool), (Bool))
+MTA_HAL_API(INT, mta_hal_ClearDSXLog, (BOOLEAN Bool), (Bool))
+MTA_HAL_API(INT, mta_hal_GetCallSignallingLogEnable, (BOOLEAN* pBool), (pBool))
+MTA_HAL_API(INT, mta_hal_SetCallSignallingLogEnable, (BOOLEAN Bool), (Bool))
+MTA_HAL_API(INT, mta_hal_ClearCallSignallingLog, (BOOLEAN Bool), (Bool))
+MTA_HAL_API(INT, mta_hal_GetMtaLog, (ULONG* Count, PMTAMGMT_MTA_MTALOG_FULL* ppCfg), (Count, ppCfg))
+MTA_HAL_API(INT, mta_hal_BatteryGetInstalled, (BOOLEAN* Val), (Val))
+MTA_HAL_API(INT, mta_hal_BatteryGetTotalCapacity, (ULONG* Val), (Val))
+MTA_HAL_API(INT, mta_hal_BatteryGetActualCapacity, (ULONG* Val), (Val))
+MTA_HAL_API(INT, mta_hal_BatteryGetRemainingCharge, (ULONG* Val), (Val))
+MTA_HAL_API(INT, mta_hal_BatteryGetRemainingTime, (ULONG* Val), (Val))
+MTA_HAL_API(INT, mta_hal_BatteryGetNumberofCycles, (ULONG* Val), (Val))
+MTA_HAL_API(INT, mta_hal_BatteryGetPowerStatus, (CHAR* Val, ULONG* len), (Val, len))
+MTA_HAL_API(INT, mta_hal_BatteryGetCondition, (CHAR* Val, ULONG* len), (Val, len))
+MTA_HAL_API(INT, mta_hal_BatteryGetStatus, (CHAR* Val, ULONG* len), (Val, len))
+MTA_HAL_API(INT, mta_hal_BatteryGetLife, (CHAR* Val, ULONG* len), (Val, len))
+MTA_HAL_API(INT, mta_hal_BatteryGetInfo, (PMTAMGMT_MTA_BATTERY_INFO pInfo), (pInfo))
+MTA_HAL_API(INT, mta_hal_BatteryGetPowerSavingModeStatus, (ULONG* pValue), (pValue))
+MTA_HAL_API(INT, mta_hal_Get_MTAResetCount, (ULONG* resetcnt), (resetcnt))
+MTA_HAL_API(INT, mta_hal_Get_LineResetCount, (ULONG* resetcnt), (resetcnt))
+MTA_HAL_API(INT, mta_hal_ClearCalls, (ULONG InstanceNumber), (InstanceNumber))
+MTA_HAL_API(INT, mta_hal_getDhcpStatus, (MTAMGMT_MTA_STATUS* output_pIpv4status, MTAMGMT_MTA_STATUS* output_pIpv6status), (output_pIpv4status, output_pIpv6status))
+MTA_HAL_API(INT, mta_hal_getConfigFileStatus, (MTAMGMT_MTA_STATUS* poutput_status), (poutput_status))
+MTA_HAL_API(INT, mta_hal_getLineRegisterStatus, (MTAMGMT_MTA_STATUS* output_status_array, int array_size), (output_status_array, array_size))
+MTA_HAL_API(INT, mta_hal_devResetNow, (BOOLEAN bResetValue), (bResetValue))
+MTA_HAL_API(INT, mta_hal_getMtaOperationalStatus, (MTAMGMT_MTA_STATUS* operationalStatus), (operationalStatus))
+MTA_HAL_API(INT, mta_hal_getMtaProvisioningStatus, (MTAMGMT_MTA_PROVISION_STATUS* provisionStatus), (provisionStatus))
+MTA_HAL_API(INT, mta_hal_start_provisioning, (PMTAMGMT_MTA_PROVISIONING_PARAMS pParameters), (pParameters))
+MTA_HAL_API_VOID(mta_hal_LineRegisterStatus_callback_register, (mta_hal_getLineRegisterStatus_callback callback_proc), (callback_proc))
+
+#undef MTA_HAL_API
+#undef MTA_HAL_API_VOID
@@ -0,0 +1,119 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file mta_hal_api_spec.h
+*
+* Valid and invalid arguments and output ranges of the APIs of mta_hal_api_list.h, for expansion with
+* X-macros. The signatures come from mta_hal_api_list.h and the argument kinds from src/test_record.c;
+* this file only holds what the header cannot tell. test_api.c builds its rule table from it, and the
+* generated conformance tests, the latency benchmark and the index sweep take their arguments from there.
+*
+* The includer defines the macros it uses before including this file, the others default to nothing;
+* the file deliberately has no include guard and undefines every macro at the end. Arguments are
+* numbered from 0 in the order of the signature.
+*
+* - MTA_HAL_SPEC_VALUES(name, arg, first, last, invalid): a scalar argument is valid from first to last,
+*   and invalid is rejected with RETURN_ERR; TEST_API_NO_INVALID when every value is accepted
+* - MTA_HAL_SPEC_INDEX(name, arg, base, count): a scalar argument indexes a table of count entries
+*   (test_api_count_t) numbered from base; base + count is rejected with RETURN_ERR
+* - MTA_HAL_SPEC_RANGE(name, arg, type, first, last): an integer output of type is between first and
+*   last; for an array output, every element up to the length argument
+* - MTA_HAL_SPEC_FIELD(name, arg, type, member, first, last): an integer member of a structure output is
+*   between first and last
+* - MTA_HAL_SPEC_OPTIONAL(name, key): the API is tested only when the boolean profile key is true
+* - MTA_HAL_SPEC_DESTRUCTIVE(name): a valid call changes the device for good, only invalid calls are made
+* - MTA_HAL_SPEC_SKIP(name, reason): no test is generated, the hand written L1 tests cover the API
+*
+* An API without a rule is called with outputs allocated by test_record_args_alloc() and its scalar
+* arguments 0. Keep one rule per line, starting with the macro name.
+*/
+
+#ifndef MTA_HAL_SPEC_VALUES
+#define MTA_HAL_SPEC_VALUES(name, arg, first, last, invalid)
+#endif
+#ifndef MTA_HAL_SPEC_INDEX
+#define MTA_HAL_SPEC_INDEX(name, arg, base, count)
+#endif
+#ifndef MTA_HAL_SPEC_RANGE
+#define MTA_HAL_SPEC_RANGE(name, arg, type, first, last)
+#endif
+#ifndef MTA_HAL_SPEC_FIELD
+#define MTA_HAL_SPEC_FIELD(name, arg, type, member, first, last)
+#endif
+#ifndef MTA_HAL_SPEC_OPTIONAL
+#define MTA_HAL_SPEC_OPTIONAL(name, key)
+#endif
+#ifndef MTA_HAL_SPEC_DESTRUCTIVE
+#define MTA_HAL_SPEC_DESTRUCTIVE(name)
+#endif
+#ifndef MTA_HAL_SPEC_SKIP
+#define MTA_HAL_SPEC_SKIP(name, reason)
+#endif
+
+MTA_HAL_SPEC_INDEX(mta_hal_LineTableGetEntry, 0, 0, TEST_API_COUNT_LINES)
+MTA_HAL_SPEC_FIELD(mta_hal_LineTableGetEntry, 1, MTAMGMT_MTA_LINETABLE_INFO, MWD, 0, 1)
+MTA_HAL_SPEC_INDEX(mta_hal_TriggerDiagnostics, 0, 0, TEST_API_COUNT_LINES)
+MTA_HAL_SPEC_RANGE(mta_hal_DectGetEnable, 0, BOOLEAN, 0, 1)
+MTA_HAL_SPEC_VALUES(mta_hal_DectSetEnable, 0, 0, 1, 2)
+MTA_HAL_SPEC_RANGE(mta_hal_DectGetRegistrationMode, 0, BOOLEAN, 0, 1)
+MTA_HAL_SPEC_VALUES(mta_hal_DectSetRegistrationMode, 0, 0, 1, 2)
+MTA_HAL_SPEC_INDEX(mta_hal_DectDeregisterDectHandset, 0, 1, TEST_API_COUNT_HANDSETS)
+MTA_HAL_SPEC_DESTRUCTIVE(mta_hal_DectDeregisterDectHandset)
+MTA_HAL_SPEC_SKIP(mta_hal_SetDectPIN, "input buffer")
+MTA_HAL_SPEC_INDEX(mta_hal_GetCalls, 0, 1, TEST_API_COUNT_LINES)
+MTA_HAL_SPEC_INDEX(mta_hal_GetCALLP, 0, 1, TEST_API_COUNT_LINES)
+MTA_HAL_SPEC_RANGE(mta_hal_GetDSXLogEnable, 0, BOOLEAN, 0, 1)
+MTA_HAL_SPEC_VALUES(mta_hal_SetDSXLogEnable, 0, 0, 1, 2)
+MTA_HAL_SPEC_VALUES(mta_hal_ClearDSXLog, 0, 0, 1, 2)
+MTA_HAL_SPEC_RANGE(mta_hal_GetCallSignallingLogEnable, 0, BOOLEAN, 0, 1)
+MTA_HAL_SPEC_VALUES(mta_hal_SetCallSignallingLogEnable, 0, 0, 1, 2)
+MTA_HAL_SPEC_VALUES(mta_hal_ClearCallSignallingLog, 0, 0, 1, 2)
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetInstalled, "mta.batterySupported")
+MTA_HAL_SPEC_RANGE(mta_hal_BatteryGetInstalled, 0, BOOLEAN, 0, 1)
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetTotalCapacity, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetActualCapacity, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetRemainingCharge, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetRemainingTime, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetNumberofCycles, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetPowerStatus, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetCondition, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetStatus, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetLife, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetInfo, "mta.batterySupported")
+MTA_HAL_SPEC_OPTIONAL(mta_hal_BatteryGetPowerSavingModeStatus, "mta.batterySupported")
+MTA_HAL_SPEC_VALUES(mta_hal_ClearCalls, 0, 0, 0xFFFFFFFFULL, TEST_API_NO_INVALID)
+MTA_HAL_SPEC_RANGE(mta_hal_getDhcpStatus, 0, MTAMGMT_MTA_STATUS, MTA_INIT, MTA_REJECTED)
+MTA_HAL_SPEC_RANGE(mta_hal_getDhcpStatus, 1, MTAMGMT_MTA_STATUS, MTA_INIT, MTA_REJECTED)
+MTA_HAL_SPEC_RANGE(mta_hal_getConfigFileStatus, 0, MTAMGMT_MTA_STATUS, MTA_INIT, MTA_REJECTED)
+MTA_HAL_SPEC_RANGE(mta_hal_getLineRegisterStatus, 0, MTAMGMT_MTA_STATUS, MTA_INIT, MTA_REJECTED)
+MTA_HAL_SPEC_VALUES(mta_hal_getLineRegisterStatus, 1, 1, 256, TEST_API_NO_INVALID)
+MTA_HAL_SPEC_VALUES(mta_hal_devResetNow, 0, 0, 1, 2)
+MTA_HAL_SPEC_DESTRUCTIVE(mta_hal_devResetNow)
+MTA_HAL_SPEC_RANGE(mta_hal_getMtaOperationalStatus, 0, MTAMGMT_MTA_STATUS, MTA_INIT, MTA_REJECTED)
+MTA_HAL_SPEC_RANGE(mta_hal_getMtaProvisioningStatus, 0, MTAMGMT_MTA_PROVISION_STATUS, MTA_PROVISIONED, MTA_NON_PROVISIONED)
+MTA_HAL_SPEC_SKIP(mta_hal_start_provisioning, "input structure")
+MTA_HAL_SPEC_SKIP(mta_hal_LineRegisterStatus_callback_register, "callback registration")
+
+#undef MTA_HAL_SPEC_VALUES
+#undef MTA_HAL_SPEC_INDEX
+#undef MTA_HAL_SPEC_RANGE
+#undef MTA_HAL_SPEC_FIELD
+#undef MTA_HAL_SPEC_OPTIONAL
+#undef MTA_HAL_SPEC_DESTRUCTIVE
+#undef MTA_HAL_SPEC_SKIP
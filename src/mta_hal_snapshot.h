@@ -0,0 +1,80 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file mta_hal_snapshot.h
+*
+* Prototype of a bulk read of the MTA status, not part of mta_hal.h.
+*
+* The MTA agent refreshes its status with about twenty calls: the DHCPv4 and DHCPv6 information, the
+* DHCP, operational, provisioning and configuration file status, the line register status and the
+* battery. On a device each call is a round trip to the MTA daemon. mta_hal_GetSnapshot() returns the
+* same values in one call, which the HAL can read under one lock and in one request.
+*
+* The skeleton implements it, and the [PERF mta_hal snapshot] suite (test_perf_mta_hal_snapshot.c)
+* times it against the individual calls. A vendor library providing the symbol is measured the same way.
+*/
+
+#ifndef MTA_HAL_SNAPSHOT_H
+#define MTA_HAL_SNAPSHOT_H
+
+#include "mta_hal.h"
+
+#define MTA_HAL_SNAPSHOT_MAX_LINES      (16)
+#define MTA_HAL_SNAPSHOT_STRING_SIZE    (64)
+
+/**
+ * @brief Status of the MTA, each member as returned by the API named in its comment
+ */
+typedef struct _MTAMGMT_MTA_SNAPSHOT
+{
+    MTAMGMT_MTA_DHCP_INFO DhcpInfo;                     /*!< mta_hal_GetDHCPInfo() */
+    MTAMGMT_MTA_DHCPv6_INFO DhcpV6Info;                 /*!< mta_hal_GetDHCPV6Info() */
+    MTAMGMT_MTA_STATUS Ipv4Status;                      /*!< mta_hal_getDhcpStatus() */
+    MTAMGMT_MTA_STATUS Ipv6Status;
+    MTAMGMT_MTA_STATUS OperationalStatus;               /*!< mta_hal_getMtaOperationalStatus() */
+    MTAMGMT_MTA_PROVISION_STATUS ProvisioningStatus;    /*!< mta_hal_getMtaProvisioningStatus() */
+    MTAMGMT_MTA_STATUS ConfigFileStatus;                /*!< mta_hal_getConfigFileStatus() */
+    ULONG NumberOfLines;                                /*!< mta_hal_LineTableGetNumberOfEntries(), at most MTA_HAL_SNAPSHOT_MAX_LINES */
+    MTAMGMT_MTA_STATUS LineRegisterStatus[MTA_HAL_SNAPSHOT_MAX_LINES]; /*!< mta_hal_getLineRegisterStatus() */
+    BOOLEAN BatteryInstalled;                           /*!< mta_hal_BatteryGetInstalled() */
+    ULONG BatteryTotalCapacity;                         /*!< mta_hal_BatteryGetTotalCapacity() */
+    ULONG BatteryActualCapacity;                        /*!< mta_hal_BatteryGetActualCapacity() */
+    ULONG BatteryRemainingCharge;                       /*!< mta_hal_BatteryGetRemainingCharge() */
+    ULONG BatteryRemainingTime;                         /*!< mta_hal_BatteryGetRemainingTime() */
+    ULONG BatteryNumberofCycles;                        /*!< mta_hal_BatteryGetNumberofCycles() */
+    CHAR BatteryPowerStatus[MTA_HAL_SNAPSHOT_STRING_SIZE]; /*!< mta_hal_BatteryGetPowerStatus() */
+    CHAR BatteryCondition[MTA_HAL_SNAPSHOT_STRING_SIZE];   /*!< mta_hal_BatteryGetCondition() */
+    CHAR BatteryStatus[MTA_HAL_SNAPSHOT_STRING_SIZE];      /*!< mta_hal_BatteryGetStatus() */
+    CHAR BatteryLife[MTA_HAL_SNAPSHOT_STRING_SIZE];        /*!< mta_hal_BatteryGetLife() */
+    MTAMGMT_MTA_BATTERY_INFO BatteryInfo;               /*!< mta_hal_BatteryGetInfo() */
+} MTAMGMT_MTA_SNAPSHOT, *PMTAMGMT_MTA_SNAPSHOT;
+
+/**
+ * @brief Read the status of the MTA in one call
+ *
+ * The members are those the individual APIs would return at the time of the call. Members the HAL does
+ * not fill, such as the battery of a device without one, are 0.
+ *
+ * @param[out] pSnapshot - status, must not be NULL
+ *
+ * @return INT - RETURN_OK on success, RETURN_ERR on failure
+ */
+INT mta_hal_GetSnapshot(PMTAMGMT_MTA_SNAPSHOT pSnapshot);
+
+#endif /* MTA_HAL_SNAPSHOT_H */
@@ -0,0 +1,423 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include <errno.h>
+#include <stddef.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "test_alloc.h"
+#include "test_probe.h"
+
+/* Blocks charged to an API are tracked in an open addressing table keyed by address */
+#define TEST_ALLOC_TABLE_BITS   (16)
+#define TEST_ALLOC_TABLE_SIZE   (1U << TEST_ALLOC_TABLE_BITS)
+#define TEST_ALLOC_TABLE_MASK   (TEST_ALLOC_TABLE_SIZE - 1U)
+#define TEST_ALLOC_TABLE_LIMIT  ((TEST_ALLOC_TABLE_SIZE / 4U) * 3U)
+#define TEST_ALLOC_KEY_SIZE     (128)
+
+typedef struct
+{
+    void *ptr;
+    size_t size;
+    int api;
+} alloc_block_t;
+
+typedef struct
+{
+    bool set;
+    uint64_t allocs;                /*!< Allocations allowed per call */
+    uint64_t bytes;                 /*!< Bytes allowed per call */
+    bool reported;                  /*!< A violation has failed the current test */
+} alloc_budget_t;
+
+static alloc_block_t gBlocks[TEST_ALLOC_TABLE_SIZE];
+static uint32_t gNumBlocks;
+static test_alloc_stats_t gStats[TEST_PROBE_API_COUNT];
+static alloc_budget_t gBudgets[TEST_PROBE_API_COUNT];
+static volatile int gLock;
+
+/* API whose call the thread is executing; allocations by other threads are never charged */
+static __thread int tApi __attribute__((tls_model("initial-exec"))) = TEST_PROBE_API_NONE;
+static __thread uint64_t tCallAllocs __attribute__((tls_model("initial-exec")));
+static __thread uint64_t tCallBytes __attribute__((tls_model("initial-exec")));
+
+static void alloc_lock(void)
+{
+    while (__sync_lock_test_and_set(&gLock, 1) != 0)
+    {
+        /* Spin, the critical sections are a few instructions long */
+    }
+}
+
+static void alloc_unlock(void)
+{
+    __sync_lock_release(&gLock);
+}
+
+static uint32_t alloc_hash(const void *ptr)
+{
+    return (uint32_t)((((uint64_t)(uintptr_t)ptr >> 4) * 0x9E3779B97F4A7C15ULL) >> (64 - TEST_ALLOC_TABLE_BITS));
+}
+
+/* Called with the lock held */
+static void alloc_track(void *ptr, size_t size, int api)
+{
+    uint32_t i;
+
+    if (gNumBlocks >= TEST_ALLOC_TABLE_LIMIT)
+    {
+        gStats[api].untracked++;
+        return;
+    }
+    for (i = alloc_hash(ptr); gBlocks[i].ptr != NULL; i = (i + 1U) & TEST_ALLOC_TABLE_MASK)
+    {
+    }
+    gBlocks[i].ptr = ptr;
+    gBlocks[i].size = size;
+    gBlocks[i].api = api;
+    gNumBlocks++;
+    gStats[api].outstandingBlocks++;
+    gStats[api].outstandingBytes += size;
+}
+
+/* Called with the lock held, backward shift deletion keeps the probe sequences intact */
+static void alloc_untrack(void *ptr)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t home;
+
+    for (i = alloc_hash(ptr); gBlocks[i].ptr != ptr; i = (i + 1U) & TEST_ALLOC_TABLE_MASK)
+    {
+        if (gBlocks[i].ptr == NULL)
+        {
+            return;
+        }
+    }
+    gStats[gBlocks[i].api].outstandingBlocks--;
+    gStats[gBlocks[i].api].outstandingBytes -= gBlocks[i].size;
+    gNumBlocks--;
+
+    j = i;
+    for (;;)
+    {
+        j = (j + 1U) & TEST_ALLOC_TABLE_MASK;
+        if (gBlocks[j].ptr == NULL)
+        {
+            break;
+        }
+        home = alloc_hash(gBlocks[j].ptr);
+        if ((i <= j) ? ((i < home) && (home <= j)) : ((i < home) || (home <= j)))
+        {
+            continue;
+        }
+        gBlocks[i] = gBlocks[j];
+        i = j;
+    }
+    gBlocks[i].ptr = NULL;
+}
+
+#if defined(__GLIBC__)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+bool test_alloc_available(void)
+{
+    return true;
+}
+
+/* Charge a new block to the API the thread is executing, if any */
+static void *alloc_charge(void *ptr, size_t size)
+{
+    int api = tApi;
+
+    if ((api != TEST_PROBE_API_NONE) && (ptr != NULL))
+    {
+        alloc_lock();
+        gStats[api].allocs++;
+        gStats[api].bytes += size;
+        alloc_track(ptr, size, api);
+        tCallAllocs++;
+        tCallBytes += size;
+        alloc_unlock();
+    }
+    return ptr;
+}
+
+void *malloc(size_t size)
+{
+    return alloc_charge(__libc_malloc(size), size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    return alloc_charge(__libc_calloc(count, size), count * size);
+}
+
+/* The aligned allocators of glibc do not go through malloc(), their blocks are charged here */
+void *memalign(size_t alignment, size_t size)
+{
+    return alloc_charge(__libc_memalign(alignment, size), size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return alloc_charge(__libc_memalign(alignment, size), size);
+}
+
+int posix_memalign(void **pPtr, size_t alignment, size_t size)
+{
+    void *ptr;
+
+    if ((alignment < sizeof(void *)) || ((alignment & (alignment - 1U)) != 0))
+    {
+        return EINVAL;
+    }
+    ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL)
+    {
+        return ENOMEM;
+    }
+    *pPtr = alloc_charge(ptr, size);
+    return 0;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    size_t oldSize = ((ptr != NULL) && (tApi != TEST_PROBE_API_NONE)) ? malloc_usable_size(ptr) : 0;
+    void *newPtr = __libc_realloc(ptr, size);
+    int api = tApi;
+
+    if ((newPtr == NULL) && (size != 0))
+    {
+        /* Failed, the original block is untouched */
+        return NULL;
+    }
+    if ((api != TEST_PROBE_API_NONE) || (gNumBlocks > 0))
+    {
+        alloc_lock();
+        if (ptr != NULL)
+        {
+            alloc_untrack(ptr);
+        }
+        if (api != TEST_PROBE_API_NONE)
+        {
+            gStats[api].reallocs++;
+            if ((ptr != NULL) && (newPtr != NULL) && (newPtr != ptr))
+            {
+                /* Moved, the contents were copied */
+                gStats[api].reallocCopyBytes += (oldSize < size) ? oldSize : size;
+            }
+            if (newPtr != NULL)
+            {
+                gStats[api].allocs++;
+                gStats[api].bytes += size;
+                alloc_track(newPtr, size, api);
+                tCallAllocs++;
+                tCallBytes += size;
+            }
+        }
+        alloc_unlock();
+    }
+    return newPtr;
+}
+
+void free(void *ptr)
+{
+    int api = tApi;
+
+    if ((ptr != NULL) && ((api != TEST_PROBE_API_NONE) || (gNumBlocks > 0)))
+    {
+        alloc_lock();
+        if (api != TEST_PROBE_API_NONE)
+        {
+            gStats[api].frees++;
+        }
+        alloc_untrack(ptr);
+        alloc_unlock();
+    }
+    __libc_free(ptr);
+}
+
+#else
+
+bool test_alloc_available(void)
+{
+    return false;
+}
+
+#endif /* __GLIBC__ */
+
+void test_alloc_enter(int api)
+{
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT))
+    {
+        return;
+    }
+    __sync_fetch_and_add(&gStats[api].calls, 1);
+    tCallAllocs = 0;
+    tCallBytes = 0;
+    tApi = api;
+}
+
+static void alloc_budget_text(char *pText, size_t size, uint64_t limit)
+{
+    if (limit == UINT64_MAX)
+    {
+        snprintf(pText, size, "unlimited");
+    }
+    else
+    {
+        snprintf(pText, size, "%llu", (unsigned long long)limit);
+    }
+}
+
+void test_alloc_exit(int api)
+{
+    alloc_budget_t *pBudget;
+    char allocsText[24];
+    char bytesText[24];
+
+    tApi = TEST_PROBE_API_NONE;
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT) || (gBudgets[api].set == false))
+    {
+        return;
+    }
+    pBudget = &gBudgets[api];
+    if ((tCallAllocs <= pBudget->allocs) && (tCallBytes <= pBudget->bytes))
+    {
+        return;
+    }
+    __sync_fetch_and_add(&gStats[api].overBudget, 1);
+    if (pBudget->reported == false)
+    {
+        pBudget->reported = true;
+        alloc_budget_text(allocsText, sizeof(allocsText), pBudget->allocs);
+        alloc_budget_text(bytesText, sizeof(bytesText), pBudget->bytes);
+        UT_LOG_ERROR("%s exceeded its allocation budget: %llu allocations, %llu bytes in one call (budget %s allocations, %s bytes)",
+                     test_probe_api_name(api), (unsigned long long)tCallAllocs, (unsigned long long)tCallBytes,
+                     allocsText, bytesText);
+        UT_FAIL("HAL call exceeded its allocation budget");
+    }
+}
+
+/* Read an optional numeric profile value, returns false when the key is absent or empty */
+static bool alloc_profile_value(const char *pKey, uint64_t *pValue)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    if ((UT_KVP_PROFILE_GET_STRING(pKey, value) != UT_KVP_STATUS_SUCCESS) || (value[0] == '\0'))
+    {
+        return false;
+    }
+    *pValue = strtoull(value, NULL, 0);
+    return true;
+}
+
+void test_alloc_load_budgets(void)
+{
+    char key[TEST_ALLOC_KEY_SIZE];
+    bool allocsSet;
+    bool bytesSet;
+    int api;
+
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        memset(&gBudgets[api], 0, sizeof(alloc_budget_t));
+        snprintf(key, sizeof(key), "mta.allocBudget.%s.allocs", test_probe_api_name(api));
+        allocsSet = alloc_profile_value(key, &gBudgets[api].allocs);
+        snprintf(key, sizeof(key), "mta.allocBudget.%s.bytes", test_probe_api_name(api));
+        bytesSet = alloc_profile_value(key, &gBudgets[api].bytes);
+        if ((allocsSet == false) && (bytesSet == false))
+        {
+            continue;
+        }
+        /* A budget given for only one of the two leaves the other unlimited */
+        if (allocsSet == false)
+        {
+            gBudgets[api].allocs = UINT64_MAX;
+        }
+        if (bytesSet == false)
+        {
+            gBudgets[api].bytes = UINT64_MAX;
+        }
+        gBudgets[api].set = true;
+    }
+}
+
+void test_alloc_begin_test(void)
+{
+    int api;
+
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        gBudgets[api].reported = false;
+    }
+}
+
+void test_alloc_get(int api, test_alloc_stats_t *pStats)
+{
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT))
+    {
+        memset(pStats, 0, sizeof(test_alloc_stats_t));
+        return;
+    }
+    alloc_lock();
+    *pStats = gStats[api];
+    alloc_unlock();
+}
+
+void test_alloc_report(void)
+{
+    test_alloc_stats_t stats;
+    int api;
+    bool header = false;
+
+    if (test_alloc_available() == false)
+    {
+        return;
+    }
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        test_alloc_get(api, &stats);
+        if ((stats.allocs == 0) && (stats.outstandingBlocks == 0) && (stats.overBudget == 0))
+        {
+            continue;
+        }
+        if (header == false)
+        {
+            UT_LOG_INFO("%-40s %8s %10s %10s %12s %12s %12s %12s", "HAL allocations", "calls", "allocs", "reallocs", "bytes", "outstanding", "out bytes",
+                        "over budget");
+            header = true;
+        }
+        UT_LOG_INFO("%-40s %8llu %10llu %10llu %12llu %12llu %12llu %12llu", test_probe_api_name(api),
+                    (unsigned long long)stats.calls, (unsigned long long)stats.allocs,
+                    (unsigned long long)stats.reallocs, (unsigned long long)stats.bytes,
+                    (unsigned long long)stats.outstandingBlocks, (unsigned long long)stats.outstandingBytes,
+                    (unsigned long long)stats.overBudget);
+    }
+}
@@ -0,0 +1,96 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_alloc.h
+*
+* Heap allocation accounting per mta_hal API.
+*
+* The test binary defines malloc(), calloc(), realloc(), free() and the aligned allocators memalign(),
+* aligned_alloc() and posix_memalign(), which take precedence over the C library for the whole process,
+* including the vendor libhal_mta. valloc() and pvalloc(), obsolete, are not tracked. The call probes of test_probe.h mark
+* the thread that is executing a HAL call; every block allocated by that thread during the call is
+* charged to the API and tracked until it is freed, by the HAL or by the caller.
+*
+* The module profile may give an API an allocation budget, the largest number of allocations and bytes a
+* single call may request, under mta.allocBudget.<api>.allocs and mta.allocBudget.<api>.bytes. A call
+* exceeding its budget fails the running test.
+*
+* Accounting needs the glibc __libc_ allocator entry points; on other C libraries the functions
+* below are present but test_alloc_available() returns false and no statistics are collected.
+*/
+
+#ifndef TEST_ALLOC_H
+#define TEST_ALLOC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t calls;                 /*!< HAL calls made */
+    uint64_t allocs;                /*!< Blocks allocated during the calls, including by realloc() */
+    uint64_t reallocs;              /*!< realloc() calls during the calls */
+    uint64_t reallocCopyBytes;      /*!< Bytes copied by realloc() calls that moved a block */
+    uint64_t frees;                 /*!< free() calls during the calls */
+    uint64_t bytes;                 /*!< Bytes requested during the calls */
+    uint64_t outstandingBlocks;     /*!< Blocks allocated during the calls and not freed yet */
+    uint64_t outstandingBytes;      /*!< Bytes of outstandingBlocks */
+    uint64_t untracked;             /*!< Blocks that did not fit in the tracking table */
+    uint64_t overBudget;            /*!< Calls that exceeded the allocation budget of the API */
+} test_alloc_stats_t;
+
+/**
+ * @brief Whether allocations are being accounted
+ */
+bool test_alloc_available(void);
+
+/**
+ * @brief Start charging allocations of the calling thread to an API, called by the probes
+ */
+void test_alloc_enter(int api);
+
+/**
+ * @brief Stop charging allocations of the calling thread, called by the probes
+ */
+void test_alloc_exit(int api);
+
+/**
+ * @brief Load the allocation budgets from the module profile
+ */
+void test_alloc_load_budgets(void);
+
+/**
+ * @brief Mark the start of a test, so that the first budget violation of every API fails it
+ */
+void test_alloc_begin_test(void);
+
+/**
+ * @brief Read the statistics of an API
+ *
+ * @param[in] api - API identifier, see test_probe.h
+ * @param[out] pStats - statistics since the start of the process
+ */
+void test_alloc_get(int api, test_alloc_stats_t *pStats);
+
+/**
+ * @brief Log the statistics of every API that allocated
+ */
+void test_alloc_report(void);
+
+#endif /* TEST_ALLOC_H */
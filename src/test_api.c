@@ -0,0 +1,327 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mta_hal.h"
+#include "test_api.h"
+#include "test_probe.h"
+#include "test_record.h"
+
+#define API_NAME_SIZE       (64)
+
+typedef int64_t (*api_caller_fn_t)(const uintptr_t *pArgs);
+
+#define API_CAT_EXPANDED(a, b)              a##b
+#define API_CAT(a, b)                       API_CAT_EXPANDED(a, b)
+/* The GNU comma elision of API_COUNT_PREPEND drops the comma of an empty "()" list, counting 0 */
+#define API_COUNT_PREPEND(...)              , ##__VA_ARGS__
+#define API_COUNT_SELECT(unused, a, b, c, count, ...) count
+#define API_COUNT_APPLY(...)                API_COUNT_SELECT(__VA_ARGS__, 3, 2, 1, 0)
+#define API_COUNT(arguments)                API_COUNT_APPLY(0 API_COUNT_PREPEND arguments)
+
+#define API_DECLARE_0(...)
+#define API_DECLARE_1(a)                    a;
+#define API_DECLARE_2(a, b)                 a; b;
+#define API_DECLARE_3(a, b, c)              a; b; c;
+#define API_DECLARE(parameters, arguments)  API_CAT(API_DECLARE_, API_COUNT(arguments)) parameters
+
+#define API_ASSIGN_ONE(a, i)                a = (__typeof__(a))pArgs[i];
+#define API_ASSIGN_0()                      (void)pArgs;
+#define API_ASSIGN_1(a)                     API_ASSIGN_ONE(a, 0)
+#define API_ASSIGN_2(a, b)                  API_ASSIGN_ONE(a, 0) API_ASSIGN_ONE(b, 1)
+#define API_ASSIGN_3(a, b, c)               API_ASSIGN_ONE(a, 0) API_ASSIGN_ONE(b, 1) API_ASSIGN_ONE(c, 2)
+#define API_ASSIGN(arguments)               API_CAT(API_ASSIGN_, API_COUNT(arguments)) arguments
+
+/* Typed callers, the call goes through the probes as any other call of the tests */
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    static int64_t api_call_##name(const uintptr_t *pArgs) \
+    { \
+        API_DECLARE(parameters, arguments) \
+        API_ASSIGN(arguments) \
+        return (int64_t)name arguments; \
+    }
+#define MTA_HAL_API_VOID(name, parameters, arguments) \
+    static int64_t api_call_##name(const uintptr_t *pArgs) \
+    { \
+        API_DECLARE(parameters, arguments) \
+        API_ASSIGN(arguments) \
+        name arguments; \
+        return 0; \
+    }
+#include "mta_hal_api_list.h"
+
+static const api_caller_fn_t gCallers[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) api_call_##name,
+#define MTA_HAL_API_VOID(name, parameters, arguments) api_call_##name,
+#include "mta_hal_api_list.h"
+};
+
+/* Flags of mta_hal_api_spec.h are set by api_init() */
+static test_api_desc_t gDescs[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    { #name, API_COUNT(arguments), __builtin_types_compatible_p(returnType, INT), false, NULL, NULL },
+#define MTA_HAL_API_VOID(name, parameters, arguments) { #name, API_COUNT(arguments), false, false, NULL, NULL },
+#include "mta_hal_api_list.h"
+};
+
+/* Argument names of every API, "(Index, pEntry)" */
+static const char *gArgNames[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) #arguments,
+#define MTA_HAL_API_VOID(name, parameters, arguments) #arguments,
+#include "mta_hal_api_list.h"
+};
+
+static const test_api_rule_t gRules[] =
+{
+#define MTA_HAL_SPEC_VALUES(name, arg, first, last, invalid) \
+    { TEST_PROBE_ID(name), TEST_API_RULE_VALUES, (arg), 0, 0, (first), (last), (invalid), 0, NULL },
+#define MTA_HAL_SPEC_INDEX(name, arg, base, count) \
+    { TEST_PROBE_ID(name), TEST_API_RULE_INDEX, (arg), 0, 0, (base), 0, 0, (count), NULL },
+#define MTA_HAL_SPEC_RANGE(name, arg, type, first, last) \
+    { TEST_PROBE_ID(name), TEST_API_RULE_RANGE, (arg), 0, sizeof(type), (first), (last), TEST_API_NO_INVALID, 0, NULL },
+#define MTA_HAL_SPEC_FIELD(name, arg, type, member, first, last) \
+    { TEST_PROBE_ID(name), TEST_API_RULE_FIELD, (arg), offsetof(type, member), sizeof(((type *)0)->member), (first), (last), \
+      TEST_API_NO_INVALID, 0, #member },
+#include "mta_hal_api_spec.h"
+};
+
+#define API_RULE_COUNT      ((int)(sizeof(gRules) / sizeof(gRules[0])))
+
+static pthread_once_t gInitOnce = PTHREAD_ONCE_INIT;
+
+static void api_init(void)
+{
+#define MTA_HAL_SPEC_OPTIONAL(name, key) gDescs[TEST_PROBE_ID(name)].pOptionalKey = (key);
+#define MTA_HAL_SPEC_DESTRUCTIVE(name) gDescs[TEST_PROBE_ID(name)].destructive = true;
+#define MTA_HAL_SPEC_SKIP(name, reason) gDescs[TEST_PROBE_ID(name)].pSkipReason = (reason);
+#include "mta_hal_api_spec.h"
+}
+
+const test_api_desc_t *test_api_desc(int api)
+{
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT))
+    {
+        return NULL;
+    }
+    pthread_once(&gInitOnce, api_init);
+    return &gDescs[api];
+}
+
+int test_api_rule_count(void)
+{
+    return API_RULE_COUNT;
+}
+
+const test_api_rule_t *test_api_rule_at(int index)
+{
+    if ((index < 0) || (index >= API_RULE_COUNT))
+    {
+        return NULL;
+    }
+    return &gRules[index];
+}
+
+uint64_t test_api_count(test_api_count_t source)
+{
+    PMTAMGMT_MTA_HANDSETS_INFO pHandsets = NULL;
+    ULONG count = 0;
+
+    switch (source)
+    {
+        case TEST_API_COUNT_LINES:
+            return (uint64_t)mta_hal_LineTableGetNumberOfEntries();
+        case TEST_API_COUNT_HANDSETS:
+            if (mta_hal_GetHandsets(&count, &pHandsets) != RETURN_OK)
+            {
+                count = 0;
+            }
+            free(pHandsets);
+            return (uint64_t)count;
+        default:
+            return 0;
+    }
+}
+
+bool test_api_arg_bounds(int api, int arg, test_api_bounds_t *pBounds)
+{
+    const test_api_rule_t *pRule;
+    uint64_t count;
+    int i;
+
+    for (i = 0; i < API_RULE_COUNT; i++)
+    {
+        pRule = &gRules[i];
+        if ((pRule->api != api) || (pRule->arg != arg))
+        {
+            continue;
+        }
+        if (pRule->kind == TEST_API_RULE_VALUES)
+        {
+            pBounds->first = pRule->first;
+            pBounds->last = pRule->last;
+            pBounds->invalid = pRule->invalid;
+            pBounds->empty = (pRule->last < pRule->first);
+            return true;
+        }
+        if (pRule->kind == TEST_API_RULE_INDEX)
+        {
+            count = test_api_count((test_api_count_t)pRule->count);
+            pBounds->first = pRule->first;
+            pBounds->last = pRule->first + count - 1;
+            pBounds->invalid = pRule->first + count;
+            pBounds->empty = (count == 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+int test_api_args_valid(int api, uintptr_t *pArgs)
+{
+    test_api_bounds_t bounds;
+    int status = 0;
+    int arg;
+
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT) || (test_record_args_alloc(api, 0, pArgs) != 0))
+    {
+        return -1;
+    }
+    for (arg = 0; arg < test_record_arg_count(api); arg++)
+    {
+        if ((test_record_arg_is_output(api, arg) == true) || (test_api_arg_bounds(api, arg, &bounds) == false))
+        {
+            continue;
+        }
+        if (bounds.empty == true)
+        {
+            pArgs[arg] = (uintptr_t)bounds.invalid;
+            status = 1;
+            continue;
+        }
+        pArgs[arg] = (uintptr_t)bounds.first;
+    }
+    return status;
+}
+
+int64_t test_api_call(int api, const uintptr_t *pArgs)
+{
+    return gCallers[api](pArgs);
+}
+
+static uint64_t api_read_uint(const uint8_t *pValue, size_t size)
+{
+    switch (size)
+    {
+        case sizeof(uint8_t):
+            return *pValue;
+        case sizeof(uint16_t):
+            return *(const uint16_t *)pValue;
+        case sizeof(uint32_t):
+            return *(const uint32_t *)pValue;
+        default:
+            return *(const uint64_t *)pValue;
+    }
+}
+
+static void api_arg_name(char *pOut, size_t size, int api, int arg)
+{
+    const char *pName = gArgNames[api] + 1;
+    size_t length;
+    int i;
+
+    for (i = 0; (i < arg) && (pName != NULL); i++)
+    {
+        pName = strchr(pName, ',');
+        pName = (pName != NULL) ? (pName + 1) : NULL;
+    }
+    if (pName == NULL)
+    {
+        snprintf(pOut, size, "arg%d", arg);
+        return;
+    }
+    pName += strspn(pName, " ");
+    length = strcspn(pName, ",)");
+    snprintf(pOut, size, "%.*s", (int)length, pName);
+}
+
+int test_api_check_outputs(int api, const uintptr_t *pArgs, test_api_violation_fn_t report, void *pContext)
+{
+    const test_api_rule_t *pRule;
+    char name[API_NAME_SIZE];
+    char path[API_NAME_SIZE * 2];
+    uint64_t elements;
+    uint64_t value;
+    uint64_t e;
+    int violations = 0;
+    int i;
+
+    for (i = 0; i < API_RULE_COUNT; i++)
+    {
+        pRule = &gRules[i];
+        if ((pRule->api != api) || (pArgs[pRule->arg] == 0))
+        {
+            continue;
+        }
+        api_arg_name(name, sizeof(name), api, pRule->arg);
+        if (pRule->kind == TEST_API_RULE_RANGE)
+        {
+            elements = test_record_arg_elements(api, pRule->arg, pArgs);
+            for (e = 0; e < elements; e++)
+            {
+                value = api_read_uint((const uint8_t *)pArgs[pRule->arg] + (e * pRule->size), pRule->size);
+                if ((value < pRule->first) || (value > pRule->last))
+                {
+                    if (elements > 1)
+                    {
+                        snprintf(path, sizeof(path), "%s[%llu]", name, (unsigned long long)e);
+                    }
+                    else
+                    {
+                        snprintf(path, sizeof(path), "*%s", name);
+                    }
+                    violations++;
+                    if (report != NULL)
+                    {
+                        report(pContext, path, value, pRule);
+                    }
+                }
+            }
+        }
+        else if (pRule->kind == TEST_API_RULE_FIELD)
+        {
+            value = api_read_uint((const uint8_t *)pArgs[pRule->arg] + pRule->offset, pRule->size);
+            if ((value < pRule->first) || (value > pRule->last))
+            {
+                snprintf(path, sizeof(path), "%s.%s", name, pRule->pMember);
+                violations++;
+                if (report != NULL)
+                {
+                    report(pContext, path, value, pRule);
+                }
+            }
+        }
+    }
+    return violations;
+}
@@ -0,0 +1,168 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_api.h
+*
+* Table driven description of every mta_hal API, for tests that apply the same procedure to each of them.
+*
+* The table is built at compile time from three X-macro lists: the signatures of mta_hal_api_list.h, the
+* argument kinds of src/test_record.c and the valid values and output ranges of mta_hal_api_spec.h. From
+* it, any API can be called with valid or invalid arguments through test_api_call(), without code of its
+* own. The generated conformance tests (test_l1_mta_hal_spec.c) and the latency benchmark are written
+* this way; describing a new API in the three lists is enough to test and time it.
+*
+* The module only depends on the HAL and on test_record.c, so that tools outside the test runner, such
+* as fuzzers, can link it.
+*/
+
+#ifndef TEST_API_H
+#define TEST_API_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TEST_API_NO_INVALID     (UINT64_MAX)    /*!< Every value of the argument is accepted */
+
+/* Tables whose size an index argument depends on, read from the HAL */
+typedef enum
+{
+    TEST_API_COUNT_LINES = 0,       /*!< mta_hal_LineTableGetNumberOfEntries() */
+    TEST_API_COUNT_HANDSETS,        /*!< Count of mta_hal_GetHandsets() */
+    TEST_API_COUNT_SOURCES
+} test_api_count_t;
+
+typedef enum
+{
+    TEST_API_RULE_VALUES = 0,       /*!< Valid range and invalid value of a scalar argument */
+    TEST_API_RULE_INDEX,            /*!< Scalar argument indexing a table of the HAL */
+    TEST_API_RULE_RANGE,            /*!< Range of an integer output */
+    TEST_API_RULE_FIELD             /*!< Range of an integer member of a structure output */
+} test_api_rule_kind_t;
+
+/* One line of mta_hal_api_spec.h */
+typedef struct
+{
+    int api;                        /*!< test_probe_api_t */
+    uint8_t kind;                   /*!< test_api_rule_kind_t */
+    uint8_t arg;
+    uint16_t offset;                /*!< Offset of the member of a TEST_API_RULE_FIELD */
+    uint16_t size;                  /*!< Bytes of the output or member checked */
+    uint64_t first;                 /*!< First valid value, the base of an index */
+    uint64_t last;
+    uint64_t invalid;               /*!< Value rejected with RETURN_ERR, TEST_API_NO_INVALID for none */
+    uint8_t count;                  /*!< test_api_count_t of an index */
+    const char *pMember;            /*!< Member of a TEST_API_RULE_FIELD */
+} test_api_rule_t;
+
+typedef struct
+{
+    const char *pName;
+    int argCount;
+    bool returnsStatus;             /*!< INT return, RETURN_OK or RETURN_ERR */
+    bool destructive;               /*!< Only invalid calls are made */
+    const char *pOptionalKey;       /*!< Boolean profile key enabling the API, NULL if always present */
+    const char *pSkipReason;        /*!< Not described for generated tests, NULL otherwise */
+} test_api_desc_t;
+
+/* Valid values of a scalar argument, resolved against the HAL for an index */
+typedef struct
+{
+    uint64_t first;
+    uint64_t last;
+    uint64_t invalid;               /*!< TEST_API_NO_INVALID for none */
+    bool empty;                     /*!< No valid value, e.g. an index into an empty table */
+} test_api_bounds_t;
+
+/**
+ * @brief Called for each output out of its range
+ *
+ * @param[in] pContext - context given to test_api_check_outputs()
+ * @param[in] pPath - output, e.g. "pEntry.MWD" or "output_status_array[3]"
+ * @param[in] value - value read
+ * @param[in] pRule - range it violates
+ */
+typedef void (*test_api_violation_fn_t)(void *pContext, const char *pPath, uint64_t value, const test_api_rule_t *pRule);
+
+/**
+ * @brief Description of an API, NULL if out of range
+ *
+ * @param[in] api - test_probe_api_t
+ */
+const test_api_desc_t *test_api_desc(int api);
+
+/**
+ * @brief Number of rules of mta_hal_api_spec.h
+ */
+int test_api_rule_count(void);
+
+/**
+ * @brief Rule by position, in the order of mta_hal_api_spec.h; NULL if out of range
+ */
+const test_api_rule_t *test_api_rule_at(int index);
+
+/**
+ * @brief Entries of a table of the HAL, 0 if it cannot be read
+ */
+uint64_t test_api_count(test_api_count_t source);
+
+/**
+ * @brief Valid and invalid values of a scalar argument
+ *
+ * @param[in] api - test_probe_api_t
+ * @param[in] arg - argument
+ * @param[out] pBounds - values
+ *
+ * @return bool - false if the argument has no rule, any value is then valid
+ */
+bool test_api_arg_bounds(int api, int arg, test_api_bounds_t *pBounds);
+
+/**
+ * @brief Arguments of a valid call: outputs allocated as by test_record_args_alloc(), scalar arguments at
+ *        their first valid value, 0 without a rule
+ *
+ * Released with test_record_args_free().
+ *
+ * @param[in] api - test_probe_api_t
+ * @param[out] pArgs - TEST_RECORD_MAX_ARGS + 1 arguments
+ *
+ * @return int - 0 on success, 1 if an argument has no valid value (it is set to its invalid value, the
+ *               storage is allocated), -1 if the API takes an input buffer or memory is short
+ */
+int test_api_args_valid(int api, uintptr_t *pArgs);
+
+/**
+ * @brief Call an API with arguments in the layout of TEST_RECORD_ARGS()
+ *
+ * @return int64_t - return value of the API, 0 for a void API
+ */
+int64_t test_api_call(int api, const uintptr_t *pArgs);
+
+/**
+ * @brief Check the outputs of a call against the ranges of mta_hal_api_spec.h
+ *
+ * @param[in] api - test_probe_api_t
+ * @param[in] pArgs - arguments of the call
+ * @param[in] report - called for each violation, may be NULL
+ * @param[in] pContext - passed to report
+ *
+ * @return int - number of outputs out of range
+ */
+int test_api_check_outputs(int api, const uintptr_t *pArgs, test_api_violation_fn_t report, void *pContext);
+
+#endif /* TEST_API_H */
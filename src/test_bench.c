@@ -0,0 +1,351 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#define _GNU_SOURCE
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp.h>
+#include <ut_kvp_profile.h>
+#include <errno.h>
+#include <math.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "test_bench.h"
+
+#define BENCH_MAX_ITERATIONS    (1U << 20)  /*!< Calibration stops here, whatever the sample length */
+#define BENCH_CHECK_EVERY       (10)        /*!< Samples between two checks of the interval */
+#define BENCH_MAD_TO_SIGMA      (1.4826)    /*!< Standard deviation of a normal distribution over its MAD */
+#define BENCH_MEDIAN_EFFICIENCY (1.2533)    /*!< Standard error of the median over that of the mean, sqrt(pi/2) */
+#define BENCH_Z_95              (1.96)
+
+/* Affinity of the calling thread before test_bench_pin() */
+static __thread cpu_set_t tSavedAffinity;
+static __thread bool tPinned;
+
+uint64_t test_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_compare_u64(const void *pA, const void *pB)
+{
+    uint64_t a = *(const uint64_t *)pA;
+    uint64_t b = *(const uint64_t *)pB;
+
+    return (a > b) - (a < b);
+}
+
+void test_bench_sort(uint64_t *pSamples, uint32_t count)
+{
+    qsort(pSamples, count, sizeof(uint64_t), bench_compare_u64);
+}
+
+uint64_t test_bench_percentile(const uint64_t *pSorted, uint32_t count, double percentile)
+{
+    uint32_t index;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    index = (uint32_t)((percentile / 100.0) * (double)(count - 1) + 0.5);
+    return pSorted[index];
+}
+
+void test_bench_config_default(test_bench_config_t *pConfig)
+{
+    pConfig->warmupIterations = 100;
+    pConfig->minSamples = 20;
+    pConfig->maxSamples = 500;
+    pConfig->minSampleNs = 200000ULL;
+    pConfig->maxRelativeCi = 0.01;
+    pConfig->maxDurationNs = 5000000000ULL;
+    pConfig->cpu = -1;
+    pConfig->bootstrapResamples = 0;
+}
+
+void test_bench_config_load(test_bench_config_t *pConfig)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    uint32_t number;
+
+    test_bench_config_default(pConfig);
+    number = UT_KVP_PROFILE_GET_UINT32("mta.perf.bench.warmupIterations");
+    pConfig->warmupIterations = (number > 0) ? number : pConfig->warmupIterations;
+    number = UT_KVP_PROFILE_GET_UINT32("mta.perf.bench.minSamples");
+    pConfig->minSamples = (number > 0) ? number : pConfig->minSamples;
+    number = UT_KVP_PROFILE_GET_UINT32("mta.perf.bench.maxSamples");
+    pConfig->maxSamples = (number > 0) ? number : pConfig->maxSamples;
+    number = UT_KVP_PROFILE_GET_UINT32("mta.perf.bench.sampleUs");
+    pConfig->minSampleNs = (number > 0) ? ((uint64_t)number * 1000ULL) : pConfig->minSampleNs;
+    number = UT_KVP_PROFILE_GET_UINT32("mta.perf.bench.maxSeconds");
+    pConfig->maxDurationNs = (number > 0) ? ((uint64_t)number * 1000000000ULL) : pConfig->maxDurationNs;
+    pConfig->bootstrapResamples = UT_KVP_PROFILE_GET_UINT32("mta.perf.bench.bootstrapResamples");
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.bench.maxCiPercent", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0') &&
+        (strtod(value, NULL) > 0.0))
+    {
+        pConfig->maxRelativeCi = strtod(value, NULL) / 100.0;
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.bench.cpu", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        pConfig->cpu = atoi(value);
+    }
+    if (pConfig->maxSamples < pConfig->minSamples)
+    {
+        pConfig->maxSamples = pConfig->minSamples;
+    }
+}
+
+bool test_bench_pin(int cpu)
+{
+    cpu_set_t set;
+
+    if ((cpu < 0) || (cpu >= CPU_SETSIZE))
+    {
+        return false;
+    }
+    if (sched_getaffinity(0, sizeof(tSavedAffinity), &tSavedAffinity) != 0)
+    {
+        return false;
+    }
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+        UT_LOG_INFO("Unable to pin to CPU %d (%s), running unpinned", cpu, strerror(errno));
+        return false;
+    }
+    tPinned = true;
+    return true;
+}
+
+void test_bench_unpin(void)
+{
+    if (tPinned == true)
+    {
+        (void)sched_setaffinity(0, sizeof(tSavedAffinity), &tSavedAffinity);
+        tPinned = false;
+    }
+}
+
+static double bench_median_sorted(const uint64_t *pSorted, uint32_t count)
+{
+    if ((count % 2) == 0)
+    {
+        return ((double)pSorted[(count / 2) - 1] + (double)pSorted[count / 2]) / 2.0;
+    }
+    return (double)pSorted[count / 2];
+}
+
+static uint32_t bench_random(uint32_t *pSeed)
+{
+    *pSeed ^= *pSeed << 13;     /* xorshift32 */
+    *pSeed ^= *pSeed >> 17;
+    *pSeed ^= *pSeed << 5;
+    return *pSeed;
+}
+
+/* 95% interval of the median from the 2.5 and 97.5 percentiles of the medians of resamples */
+static void bench_bootstrap(const uint64_t *pSamples, uint32_t count, uint32_t resamples, uint64_t *pScratch,
+                            double *pLowNs, double *pHighNs)
+{
+    uint64_t *pMedians;
+    uint32_t seed = 2463534242U;
+    uint32_t r;
+    uint32_t i;
+
+    pMedians = malloc(sizeof(uint64_t) * resamples);
+    if (pMedians == NULL)
+    {
+        return;
+    }
+    for (r = 0; r < resamples; r++)
+    {
+        for (i = 0; i < count; i++)
+        {
+            pScratch[i] = pSamples[bench_random(&seed) % count];
+        }
+        test_bench_sort(pScratch, count);
+        pMedians[r] = (uint64_t)bench_median_sorted(pScratch, count);
+    }
+    test_bench_sort(pMedians, resamples);
+    *pLowNs = (double)test_bench_percentile(pMedians, resamples, 2.5);
+    *pHighNs = (double)test_bench_percentile(pMedians, resamples, 97.5);
+    free(pMedians);
+}
+
+/* Statistics of the samples, in nanoseconds per sample */
+static void bench_statistics(const test_bench_config_t *pConfig, const uint64_t *pSamples, uint32_t count, uint64_t *pScratch,
+                             test_bench_result_t *pResult)
+{
+    double sigma;
+    double halfWidth;
+    double deviation;
+    double sum = 0.0;
+    uint32_t kept = 0;
+    uint32_t i;
+
+    memcpy(pScratch, pSamples, sizeof(uint64_t) * count);
+    test_bench_sort(pScratch, count);
+    pResult->samples = count;
+    pResult->medianNs = bench_median_sorted(pScratch, count);
+    pResult->minNs = (double)pScratch[0];
+    for (i = 0; i < count; i++)
+    {
+        deviation = fabs((double)pSamples[i] - pResult->medianNs);
+        pScratch[i] = (uint64_t)(deviation + 0.5);
+    }
+    test_bench_sort(pScratch, count);
+    pResult->madNs = bench_median_sorted(pScratch, count);
+    sigma = BENCH_MAD_TO_SIGMA * pResult->madNs;
+
+    pResult->outliers = 0;
+    for (i = 0; i < count; i++)
+    {
+        if ((sigma > 0.0) && (fabs((double)pSamples[i] - pResult->medianNs) > (TEST_BENCH_OUTLIER_MADS * sigma)))
+        {
+            pResult->outliers++;
+            continue;
+        }
+        sum += (double)pSamples[i];
+        kept++;
+    }
+    pResult->meanNs = (kept > 0) ? (sum / (double)kept) : pResult->medianNs;
+
+    halfWidth = BENCH_Z_95 * BENCH_MEDIAN_EFFICIENCY * sigma / sqrt((double)count);
+    pResult->ciLowNs = pResult->medianNs - halfWidth;
+    pResult->ciHighNs = pResult->medianNs + halfWidth;
+    if (pConfig->bootstrapResamples > 0)
+    {
+        bench_bootstrap(pSamples, count, pConfig->bootstrapResamples, pScratch, &pResult->ciLowNs, &pResult->ciHighNs);
+    }
+}
+
+static bool bench_is_stable(const test_bench_config_t *pConfig, const test_bench_result_t *pResult)
+{
+    double halfWidth = (pResult->ciHighNs - pResult->ciLowNs) / 2.0;
+
+    return (pResult->medianNs > 0.0) && ((halfWidth / pResult->medianNs) <= pConfig->maxRelativeCi);
+}
+
+static uint64_t bench_sample(test_bench_fn_t function, void *pContext, uint32_t iterations, uint64_t *pErrors)
+{
+    uint64_t startNs;
+    uint32_t i;
+
+    startNs = test_bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        if (function(pContext) != 0)
+        {
+            (*pErrors)++;
+        }
+    }
+    return test_bench_now_ns() - startNs;
+}
+
+int test_bench_run(const test_bench_config_t *pConfig, test_bench_fn_t function, void *pContext, test_bench_result_t *pResult)
+{
+    uint64_t *pSamples;
+    uint64_t *pScratch;
+    uint64_t startNs;
+    uint32_t iterations = 1;
+    uint32_t count = 0;
+    uint32_t i;
+    double scale;
+
+    memset(pResult, 0, sizeof(test_bench_result_t));
+    pSamples = malloc(sizeof(uint64_t) * pConfig->maxSamples);
+    pScratch = malloc(sizeof(uint64_t) * pConfig->maxSamples);
+    if ((pSamples == NULL) || (pScratch == NULL) || (pConfig->maxSamples == 0))
+    {
+        free(pSamples);
+        free(pScratch);
+        return -1;
+    }
+    pResult->pinned = test_bench_pin(pConfig->cpu);
+
+    for (i = 0; i < pConfig->warmupIterations; i++)
+    {
+        if (function(pContext) != 0)
+        {
+            pResult->errors++;
+        }
+    }
+    while ((iterations < BENCH_MAX_ITERATIONS) &&
+           (bench_sample(function, pContext, iterations, &pResult->errors) < pConfig->minSampleNs))
+    {
+        iterations *= 2;
+    }
+    pResult->iterationsPerSample = iterations;
+
+    startNs = test_bench_now_ns();
+    while (count < pConfig->maxSamples)
+    {
+        pSamples[count++] = bench_sample(function, pContext, iterations, &pResult->errors);
+        if ((count >= pConfig->minSamples) && (((count - pConfig->minSamples) % BENCH_CHECK_EVERY) == 0))
+        {
+            bench_statistics(pConfig, pSamples, count, pScratch, pResult);
+            if (bench_is_stable(pConfig, pResult) == true)
+            {
+                pResult->stable = true;
+                break;
+            }
+        }
+        if ((test_bench_now_ns() - startNs) >= pConfig->maxDurationNs)
+        {
+            break;
+        }
+    }
+    if (pResult->stable == false)
+    {
+        bench_statistics(pConfig, pSamples, count, pScratch, pResult);
+        pResult->stable = bench_is_stable(pConfig, pResult);
+    }
+    test_bench_unpin();
+
+    scale = 1.0 / (double)iterations;
+    pResult->medianNs *= scale;
+    pResult->madNs *= scale;
+    pResult->meanNs *= scale;
+    pResult->minNs *= scale;
+    pResult->ciLowNs *= scale;
+    pResult->ciHighNs *= scale;
+    free(pSamples);
+    free(pScratch);
+    return 0;
+}
+
+void test_bench_log_header(void)
+{
+    UT_LOG_INFO("%-40s %10s %10s %10s %21s %10s %8s %8s %6s %s", "Benchmark", "median us", "MAD us", "mean us", "95% CI us",
+                "min us", "samples", "iter", "outl", "");
+}
+
+void test_bench_log(const char *pName, const test_bench_result_t *pResult)
+{
+    UT_LOG_INFO("%-40s %10.3f %10.3f %10.3f %10.3f-%-10.3f %10.3f %8u %8u %6u %s%s", pName, pResult->medianNs / 1000.0,
+                pResult->madNs / 1000.0, pResult->meanNs / 1000.0, pResult->ciLowNs / 1000.0, pResult->ciHighNs / 1000.0,
+                pResult->minNs / 1000.0, pResult->samples, pResult->iterationsPerSample, pResult->outliers,
+                (pResult->stable == true) ? "" : "unstable", (pResult->errors > 0) ? " errors" : "");
+}
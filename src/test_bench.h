@@ -0,0 +1,141 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_bench.h
+*
+* Timing core shared by the performance suites.
+*
+* test_bench_run() measures an operation in four steps:
+* - warmup: the operation is run untimed, to fill caches and let the HAL open its IPC channels
+* - calibration: the iterations per sample are doubled until a sample lasts minSampleNs, so that the
+*   clock resolution and the cost of reading it stay negligible
+* - sampling: samples are taken until the confidence interval of the median is narrower than
+*   maxRelativeCi of it, or until maxSamples or maxDurationNs is reached, the result is then unstable
+* - statistics: median and median absolute deviation (MAD), robust to the preemptions and interrupts
+*   of a busy SoC. Samples more than TEST_BENCH_OUTLIER_MADS scaled MADs from the median are counted
+*   as outliers and left out of the mean. The 95% interval of the median comes from the MAD, or from
+*   bootstrap resampling when the samples are far from normal.
+*
+* The measuring thread can be pinned to one CPU for the run, so that migrations do not add to the
+* samples. The settings are read from the "mta.perf.bench" keys of the module profile.
+*/
+
+#ifndef TEST_BENCH_H
+#define TEST_BENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TEST_BENCH_OUTLIER_MADS     (3.0)
+
+/* Operation measured, returns 0 on success; failures are counted, not measured apart */
+typedef int (*test_bench_fn_t)(void *pContext);
+
+typedef struct
+{
+    uint32_t warmupIterations;      /*!< Untimed runs before calibration */
+    uint32_t minSamples;
+    uint32_t maxSamples;
+    uint64_t minSampleNs;           /*!< Shortest sample, sets the iterations per sample */
+    double maxRelativeCi;           /*!< Half width of the interval of the median over the median, e.g. 0.01 */
+    uint64_t maxDurationNs;         /*!< Sampling time limit */
+    int cpu;                        /*!< CPU the measuring thread is pinned to, -1 leaves the affinity alone */
+    uint32_t bootstrapResamples;    /*!< 0 derives the interval from the MAD */
+} test_bench_config_t;
+
+/* Times are per iteration */
+typedef struct
+{
+    uint32_t samples;
+    uint32_t iterationsPerSample;
+    uint32_t outliers;
+    uint64_t errors;                /*!< Failed runs, warmup included */
+    double medianNs;
+    double madNs;                   /*!< Unscaled median absolute deviation */
+    double meanNs;                  /*!< Mean of the samples that are not outliers */
+    double minNs;
+    double ciLowNs;                 /*!< 95% confidence interval of the median */
+    double ciHighNs;
+    bool stable;                    /*!< The interval reached maxRelativeCi */
+    bool pinned;
+} test_bench_result_t;
+
+/**
+ * @brief Default settings: 100 warmup runs, 20 to 500 samples of at least 200 us, 1% interval,
+ *        5 seconds, no pinning, interval from the MAD
+ */
+void test_bench_config_default(test_bench_config_t *pConfig);
+
+/**
+ * @brief Defaults overridden by the "mta.perf.bench" keys of the module profile, see profiles/include/mta_profile.yaml
+ */
+void test_bench_config_load(test_bench_config_t *pConfig);
+
+/**
+ * @brief Measure an operation
+ *
+ * @param[in] pConfig - settings
+ * @param[in] function - operation
+ * @param[in] pContext - passed to function
+ * @param[out] pResult - statistics
+ *
+ * @return int - 0 on success, -1 if the samples cannot be allocated
+ */
+int test_bench_run(const test_bench_config_t *pConfig, test_bench_fn_t function, void *pContext, test_bench_result_t *pResult);
+
+/**
+ * @brief Log the header of a table of test_bench_log() lines
+ */
+void test_bench_log_header(void);
+
+/**
+ * @brief Log a result as one line of a table
+ */
+void test_bench_log(const char *pName, const test_bench_result_t *pResult);
+
+/**
+ * @brief Pin the calling thread to a CPU until test_bench_unpin()
+ *
+ * @param[in] cpu - CPU number, a negative value does nothing
+ *
+ * @return bool - true if the thread is pinned
+ */
+bool test_bench_pin(int cpu);
+
+/**
+ * @brief Restore the affinity the calling thread had before test_bench_pin()
+ */
+void test_bench_unpin(void);
+
+/**
+ * @brief CLOCK_MONOTONIC time in nanoseconds
+ */
+uint64_t test_bench_now_ns(void);
+
+/**
+ * @brief Sort samples in ascending order
+ */
+void test_bench_sort(uint64_t *pSamples, uint32_t count);
+
+/**
+ * @brief Nearest rank percentile of sorted samples, 0 when there are none
+ */
+uint64_t test_bench_percentile(const uint64_t *pSorted, uint32_t count, double percentile);
+
+#endif /* TEST_BENCH_H */
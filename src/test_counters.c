@@ -0,0 +1,338 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include "test_counters.h"
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define COUNTERS_LINE_SIZE      (256)
+
+static const char *gCounterNames[TEST_COUNTER_COUNT] = { "cycles", "instructions", "cache misses", "branch misses" };
+
+static bool gAvailable = false;
+static bool gUserOnly = false;      /*!< Kernel mode is not counted */
+
+/* Group of the calling thread, in the order the counters joined it */
+static __thread pid_t tOwner;       /*!< Process that opened the group, 0 before the first read */
+static __thread int tLeaderFd = -1;
+static __thread int tFds[TEST_COUNTER_COUNT] = { -1, -1, -1, -1 };
+static __thread int tOrder[TEST_COUNTER_COUNT];
+static __thread int tMembers;
+
+/* Closes the group of a thread when it exits, callback and stress threads each open one */
+static pthread_key_t gThreadKey;
+static pthread_once_t gThreadKeyOnce = PTHREAD_ONCE_INIT;
+
+#ifdef __linux__
+static const uint64_t gConfigs[TEST_COUNTER_COUNT] =
+{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static int counters_open_one(int counter, int groupFd, bool userOnly)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = gConfigs[counter];
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = (userOnly == true) ? 1 : 0;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC);
+}
+
+static void counters_close(void)
+{
+    int i;
+
+    for (i = 0; i < TEST_COUNTER_COUNT; i++)
+    {
+        if (tFds[i] >= 0)
+        {
+            close(tFds[i]);
+            tFds[i] = -1;
+        }
+    }
+    tLeaderFd = -1;
+    tMembers = 0;
+}
+
+static void counters_thread_exit(void *pUnused)
+{
+    (void)pUnused;
+    counters_close();
+}
+
+static void counters_key_init(void)
+{
+    (void)pthread_key_create(&gThreadKey, counters_thread_exit);
+}
+
+/* Open the group of the calling thread, returns the errno of the leader on failure */
+static int counters_open(bool userOnly)
+{
+    int counter;
+    int fd;
+    int error = 0;
+
+    counters_close();
+    for (counter = 0; counter < TEST_COUNTER_COUNT; counter++)
+    {
+        fd = counters_open_one(counter, tLeaderFd, userOnly);
+        if (fd < 0)
+        {
+            if (tLeaderFd < 0)
+            {
+                error = errno;
+            }
+            continue;
+        }
+        if (tLeaderFd < 0)
+        {
+            tLeaderFd = fd;
+        }
+        tFds[counter] = fd;
+        tOrder[tMembers++] = counter;
+    }
+    tOwner = getpid();
+    if (tLeaderFd >= 0)
+    {
+        /* Any non NULL value, the destructor only runs for those */
+        pthread_once(&gThreadKeyOnce, counters_key_init);
+        (void)pthread_setspecific(gThreadKey, &tLeaderFd);
+    }
+    return (tLeaderFd >= 0) ? 0 : error;
+}
+#endif
+
+bool test_counters_start(void)
+{
+#ifdef __linux__
+    char line[COUNTERS_LINE_SIZE];
+    size_t used = 0;
+    int error;
+    int i;
+
+    error = counters_open(false);
+    if ((error == EACCES) || (error == EPERM))
+    {
+        gUserOnly = true;
+        error = counters_open(true);
+    }
+    if (tLeaderFd < 0)
+    {
+        UT_LOG_INFO("Hardware counters unavailable (%s), running without them", strerror(error));
+        if ((error == EACCES) || (error == EPERM))
+        {
+            UT_LOG_INFO("Lower /proc/sys/kernel/perf_event_paranoid to allow them");
+        }
+        return false;
+    }
+    gAvailable = true;
+    for (i = 0; i < tMembers; i++)
+    {
+        used += (size_t)snprintf(&line[used], sizeof(line) - used, "%s%s", (i > 0) ? ", " : "", gCounterNames[tOrder[i]]);
+    }
+    UT_LOG_INFO("Hardware counters: %s%s", line, (gUserOnly == true) ? ", user mode only" : "");
+    return true;
+#else
+    UT_LOG_INFO("Hardware counters need perf_event_open(), running without them");
+    return false;
+#endif
+}
+
+bool test_counters_available(void)
+{
+    return gAvailable;
+}
+
+bool test_counters_read(test_counter_sample_t *pSample)
+{
+#ifdef __linux__
+    uint64_t data[3 + TEST_COUNTER_COUNT];    /* nr, time enabled, time running, values */
+    ssize_t length;
+    int i;
+
+    pSample->validMask = 0;
+    if (gAvailable == false)
+    {
+        return false;
+    }
+    if (tOwner != getpid())
+    {
+        /* First read of this thread, or a forked child holding the counters of its parent */
+        (void)counters_open(gUserOnly);
+    }
+    if (tLeaderFd < 0)
+    {
+        return false;
+    }
+    length = read(tLeaderFd, data, sizeof(data));
+    if ((length < (ssize_t)(3 * sizeof(uint64_t))) || (data[0] != (uint64_t)tMembers))
+    {
+        return false;
+    }
+    for (i = 0; i < tMembers; i++)
+    {
+        pSample->values[tOrder[i]] = data[3 + i];
+        if ((data[2] > 0) && (data[2] < data[1]))
+        {
+            /* Multiplexed with other events, extrapolate to the time enabled */
+            pSample->values[tOrder[i]] = (uint64_t)((double)data[3 + i] * (double)data[1] / (double)data[2]);
+        }
+        pSample->validMask |= (1U << tOrder[i]);
+    }
+    return true;
+#else
+    pSample->validMask = 0;
+    return false;
+#endif
+}
+
+void test_counters_delta(const test_counter_sample_t *pBefore, const test_counter_sample_t *pAfter, test_counter_sample_t *pDelta)
+{
+    int i;
+
+    pDelta->validMask = pBefore->validMask & pAfter->validMask;
+    for (i = 0; i < TEST_COUNTER_COUNT; i++)
+    {
+        pDelta->values[i] = ((pDelta->validMask & (1U << i)) != 0) ? (pAfter->values[i] - pBefore->values[i]) : 0;
+    }
+}
+
+void test_counters_add(test_counter_totals_t *pTotals, const test_counter_sample_t *pDelta, uint64_t wallNs)
+{
+    int i;
+
+    __sync_fetch_and_add(&pTotals->calls, 1);
+    __sync_fetch_and_add(&pTotals->wallNs, wallNs);
+    for (i = 0; i < TEST_COUNTER_COUNT; i++)
+    {
+        if ((pDelta->validMask & (1U << i)) != 0)
+        {
+            __sync_fetch_and_add(&pTotals->values[i], pDelta->values[i]);
+        }
+    }
+}
+
+void test_counters_log(const char *pLabel, const test_counter_sample_t *pDelta)
+{
+    char line[COUNTERS_LINE_SIZE];
+    size_t used = 0;
+    int i;
+
+    if (pDelta->validMask == 0)
+    {
+        return;
+    }
+    for (i = 0; i < TEST_COUNTER_COUNT; i++)
+    {
+        if ((pDelta->validMask & (1U << i)) != 0)
+        {
+            used += (size_t)snprintf(&line[used], sizeof(line) - used, "%s%s %llu", (used > 0) ? ", " : "", gCounterNames[i],
+                                     (unsigned long long)pDelta->values[i]);
+        }
+    }
+    if (((pDelta->validMask & (1U << TEST_COUNTER_CYCLES)) != 0) && ((pDelta->validMask & (1U << TEST_COUNTER_INSTRUCTIONS)) != 0) &&
+        (pDelta->values[TEST_COUNTER_CYCLES] > 0))
+    {
+        snprintf(&line[used], sizeof(line) - used, ", IPC %.2f",
+                 (double)pDelta->values[TEST_COUNTER_INSTRUCTIONS] / (double)pDelta->values[TEST_COUNTER_CYCLES]);
+    }
+    UT_LOG_INFO("%s: %s", pLabel, line);
+}
+
+static void counters_format_per_call(char *pOut, size_t size, const test_counter_totals_t *pTotals, uint32_t validMask, int counter)
+{
+    if ((validMask & (1U << counter)) == 0)
+    {
+        snprintf(pOut, size, "-");
+        return;
+    }
+    snprintf(pOut, size, "%.1f", (double)pTotals->values[counter] / (double)pTotals->calls);
+}
+
+void test_counters_report(const test_counter_totals_t *pTotals, const char *const *pNames, int count)
+{
+    char columns[TEST_COUNTER_COUNT][32];
+    char ipc[16];
+    char busy[16];
+    uint32_t validMask = 0;
+    int api;
+    int i;
+
+    if (gAvailable == false)
+    {
+        return;
+    }
+    for (i = 0; i < TEST_COUNTER_COUNT; i++)
+    {
+        if (tFds[i] >= 0)
+        {
+            validMask |= (1U << i);
+        }
+    }
+    UT_LOG_INFO("%-40s %8s %14s %14s %6s %12s %12s %10s", "HAL counters", "calls", "cycles/call", "instr/call", "IPC",
+                "cmiss/call", "bmiss/call", "cycles/us");
+    for (api = 0; api < count; api++)
+    {
+        if (pTotals[api].calls == 0)
+        {
+            continue;
+        }
+        for (i = 0; i < TEST_COUNTER_COUNT; i++)
+        {
+            counters_format_per_call(columns[i], sizeof(columns[i]), &pTotals[api], validMask, i);
+        }
+        snprintf(ipc, sizeof(ipc), "-");
+        snprintf(busy, sizeof(busy), "-");
+        if (((validMask & (1U << TEST_COUNTER_CYCLES)) != 0) && (pTotals[api].values[TEST_COUNTER_CYCLES] > 0))
+        {
+            if ((validMask & (1U << TEST_COUNTER_INSTRUCTIONS)) != 0)
+            {
+                snprintf(ipc, sizeof(ipc), "%.2f", (double)pTotals[api].values[TEST_COUNTER_INSTRUCTIONS] /
+                                                   (double)pTotals[api].values[TEST_COUNTER_CYCLES]);
+            }
+            if (pTotals[api].wallNs > 0)
+            {
+                snprintf(busy, sizeof(busy), "%.0f", (double)pTotals[api].values[TEST_COUNTER_CYCLES] * 1000.0 /
+                                                     (double)pTotals[api].wallNs);
+            }
+        }
+        UT_LOG_INFO("%-40s %8llu %14s %14s %6s %12s %12s %10s", pNames[api], (unsigned long long)pTotals[api].calls,
+                    columns[TEST_COUNTER_CYCLES], columns[TEST_COUNTER_INSTRUCTIONS], ipc,
+                    columns[TEST_COUNTER_CACHE_MISSES], columns[TEST_COUNTER_BRANCH_MISSES], busy);
+    }
+}
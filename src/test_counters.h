@@ -0,0 +1,108 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_counters.h
+*
+* Hardware performance counters of the calling thread, from perf_event_open().
+*
+* Cycles, instructions, cache misses and branch misses are opened as one group per thread, on the first
+* read made by that thread, and reopened after fork(). Counters the PMU does not provide are left out
+* of the group. When the kernel refuses to count kernel mode (perf_event_paranoid 2 or more), user mode
+* only is counted. When no counter can be opened at all, for example in a container or on a kernel
+* without CONFIG_PERF_EVENTS, test_counters_start() reports why and every read fails.
+*/
+
+#ifndef TEST_COUNTERS_H
+#define TEST_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+    TEST_COUNTER_CYCLES = 0,
+    TEST_COUNTER_INSTRUCTIONS,
+    TEST_COUNTER_CACHE_MISSES,
+    TEST_COUNTER_BRANCH_MISSES,
+    TEST_COUNTER_COUNT
+} test_counter_id_t;
+
+typedef struct
+{
+    uint64_t values[TEST_COUNTER_COUNT];    /*!< Scaled for multiplexing */
+    uint32_t validMask;                     /*!< Bit per test_counter_id_t that could be read */
+} test_counter_sample_t;
+
+/* Counters accumulated per API by the call probes, zeroed memory is an empty entry */
+typedef struct
+{
+    volatile uint64_t calls;
+    volatile uint64_t wallNs;
+    volatile uint64_t values[TEST_COUNTER_COUNT];
+} test_counter_totals_t;
+
+/**
+ * @brief Open the counters of the calling thread and report which are available
+ *
+ * @return bool - false when no counter is available, the reason is logged
+ */
+bool test_counters_start(void);
+
+/**
+ * @brief Whether test_counters_start() found counters
+ */
+bool test_counters_available(void);
+
+/**
+ * @brief Read the counters of the calling thread
+ *
+ * @param[out] pSample - counter values
+ *
+ * @return bool - false when counters are unavailable
+ */
+bool test_counters_read(test_counter_sample_t *pSample);
+
+/**
+ * @brief Difference between two samples, valid for the counters valid in both
+ */
+void test_counters_delta(const test_counter_sample_t *pBefore, const test_counter_sample_t *pAfter, test_counter_sample_t *pDelta);
+
+/**
+ * @brief Add a delta to the totals of an API
+ */
+void test_counters_add(test_counter_totals_t *pTotals, const test_counter_sample_t *pDelta, uint64_t wallNs);
+
+/**
+ * @brief Log the counters of a delta, with the instructions per cycle
+ *
+ * @param[in] pLabel - text leading the line
+ * @param[in] pDelta - counters to log
+ */
+void test_counters_log(const char *pLabel, const test_counter_sample_t *pDelta);
+
+/**
+ * @brief Log a table of per API totals
+ *
+ * @param[in] pTotals - count entries
+ * @param[in] pNames - name of each entry
+ * @param[in] count - number of entries
+ */
+void test_counters_report(const test_counter_totals_t *pTotals, const char *const *pNames, int count);
+
+#endif /* TEST_COUNTERS_H */
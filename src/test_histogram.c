@@ -0,0 +1,189 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <math.h>
+#include <time.h>
+#include "test_histogram.h"
+
+#define HISTOGRAM_NS_PER_US     (1000.0)
+
+static const double gSummaryPercentiles[] = { 50.0, 90.0, 99.0, 99.9, 99.99 };
+
+static int histogram_index(uint64_t valueNs)
+{
+    int msb;
+
+    if (valueNs >= (1ULL << TEST_HISTOGRAM_MAX_BITS))
+    {
+        valueNs = (1ULL << TEST_HISTOGRAM_MAX_BITS) - 1;
+    }
+    if (valueNs < TEST_HISTOGRAM_SUB_COUNT)
+    {
+        return (int)valueNs;
+    }
+    msb = 63 - __builtin_clzll(valueNs);
+    return ((msb - TEST_HISTOGRAM_SUB_BITS + 1) * TEST_HISTOGRAM_SUB_COUNT) +
+           (int)((valueNs >> (msb - TEST_HISTOGRAM_SUB_BITS)) - TEST_HISTOGRAM_SUB_COUNT);
+}
+
+static uint64_t histogram_lowest(int index)
+{
+    int group = index / TEST_HISTOGRAM_SUB_COUNT;
+    int sub = index % TEST_HISTOGRAM_SUB_COUNT;
+
+    if (group == 0)
+    {
+        return (uint64_t)sub;
+    }
+    return ((uint64_t)(TEST_HISTOGRAM_SUB_COUNT + sub)) << (group - 1);
+}
+
+static uint64_t histogram_highest(int index)
+{
+    int group = index / TEST_HISTOGRAM_SUB_COUNT;
+
+    return histogram_lowest(index) + ((group == 0) ? 0 : ((1ULL << (group - 1)) - 1));
+}
+
+void test_histogram_record(test_histogram_t *pHistogram, uint64_t valueNs)
+{
+    uint64_t current;
+
+    __sync_fetch_and_add(&pHistogram->buckets[histogram_index(valueNs)], 1);
+    __sync_fetch_and_add(&pHistogram->count, 1);
+    __sync_fetch_and_add(&pHistogram->sumNs, valueNs);
+    current = pHistogram->maxNs;
+    while ((valueNs > current) && (__sync_bool_compare_and_swap(&pHistogram->maxNs, current, valueNs) == 0))
+    {
+        current = pHistogram->maxNs;
+    }
+    current = pHistogram->minNsPlusOne;
+    while (((current == 0) || ((valueNs + 1) < current)) &&
+           (__sync_bool_compare_and_swap(&pHistogram->minNsPlusOne, current, valueNs + 1) == 0))
+    {
+        current = pHistogram->minNsPlusOne;
+    }
+}
+
+uint64_t test_histogram_percentile(const test_histogram_t *pHistogram, double percentile)
+{
+    uint64_t count = pHistogram->count;
+    uint64_t target;
+    uint64_t seen = 0;
+    uint64_t value;
+    int i;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+    target = (uint64_t)ceil((percentile / 100.0) * (double)count);
+    if (target == 0)
+    {
+        target = 1;
+    }
+    for (i = 0; i < TEST_HISTOGRAM_BUCKETS; i++)
+    {
+        seen += pHistogram->buckets[i];
+        if (seen >= target)
+        {
+            value = histogram_highest(i);
+            return (value < pHistogram->maxNs) ? value : pHistogram->maxNs;
+        }
+    }
+    return pHistogram->maxNs;
+}
+
+void test_histogram_write(FILE *pFile, const char *pName, const test_histogram_t *pHistogram)
+{
+    uint64_t count = pHistogram->count;
+    uint64_t seen = 0;
+    uint64_t value;
+    double fraction;
+    double mean;
+    double middle;
+    double variance = 0.0;
+    size_t i;
+    int bucket;
+
+    if (count == 0)
+    {
+        return;
+    }
+    mean = (double)pHistogram->sumNs / (double)count;
+    fprintf(pFile, "# API %s\n", pName);
+    fprintf(pFile, "# count %llu min %.3f us max %.3f us", (unsigned long long)count,
+            (double)(pHistogram->minNsPlusOne - 1) / HISTOGRAM_NS_PER_US, (double)pHistogram->maxNs / HISTOGRAM_NS_PER_US);
+    for (i = 0; i < (sizeof(gSummaryPercentiles) / sizeof(gSummaryPercentiles[0])); i++)
+    {
+        fprintf(pFile, " p%g %.3f us", gSummaryPercentiles[i],
+                (double)test_histogram_percentile(pHistogram, gSummaryPercentiles[i]) / HISTOGRAM_NS_PER_US);
+    }
+    fprintf(pFile, "\n%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+    for (bucket = 0; bucket < TEST_HISTOGRAM_BUCKETS; bucket++)
+    {
+        if (pHistogram->buckets[bucket] == 0)
+        {
+            continue;
+        }
+        seen += pHistogram->buckets[bucket];
+        value = histogram_highest(bucket);
+        if (value > pHistogram->maxNs)
+        {
+            value = pHistogram->maxNs;
+        }
+        middle = ((double)histogram_lowest(bucket) + (double)histogram_highest(bucket)) / 2.0;
+        variance += (double)pHistogram->buckets[bucket] * (middle - mean) * (middle - mean);
+        fraction = (double)seen / (double)count;
+        if (seen < count)
+        {
+            fprintf(pFile, "%12.3f %14.12f %10llu %14.2f\n", (double)value / HISTOGRAM_NS_PER_US, fraction,
+                    (unsigned long long)seen, 1.0 / (1.0 - fraction));
+        }
+        else
+        {
+            fprintf(pFile, "%12.3f %14.12f %10llu\n", (double)value / HISTOGRAM_NS_PER_US, fraction, (unsigned long long)seen);
+        }
+    }
+    fprintf(pFile, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean / HISTOGRAM_NS_PER_US,
+            sqrt(variance / (double)count) / HISTOGRAM_NS_PER_US);
+    fprintf(pFile, "#[Max     = %12.3f, Total count    = %12llu]\n", (double)pHistogram->maxNs / HISTOGRAM_NS_PER_US,
+            (unsigned long long)count);
+    fprintf(pFile, "#[Buckets = %12d, SubBuckets     = %12d]\n\n", TEST_HISTOGRAM_MAX_BITS - TEST_HISTOGRAM_SUB_BITS + 1,
+            TEST_HISTOGRAM_SUB_COUNT);
+}
+
+int test_histogram_dump(const char *pPath, const char *const *pNames, const test_histogram_t *pTable, int count)
+{
+    FILE *pFile;
+    struct timespec now;
+    int i;
+
+    pFile = fopen(pPath, "w");
+    if (pFile == NULL)
+    {
+        return -1;
+    }
+    clock_gettime(CLOCK_REALTIME, &now);
+    fprintf(pFile, "# Latency histograms per API, values in microseconds, written at %lld\n\n", (long long)now.tv_sec);
+    for (i = 0; i < count; i++)
+    {
+        test_histogram_write(pFile, pNames[i], &pTable[i]);
+    }
+    return (fclose(pFile) == 0) ? 0 : -1;
+}
@@ -0,0 +1,96 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_histogram.h
+*
+* High dynamic range latency histograms.
+*
+* Values are counted in log-linear buckets: exact below TEST_HISTOGRAM_SUB_COUNT nanoseconds, then
+* TEST_HISTOGRAM_SUB_COUNT buckets per power of two, which bounds the error of any reported value to
+* 1/TEST_HISTOGRAM_SUB_COUNT (about 3%) from 1 ns up to TEST_HISTOGRAM_MAX_BITS bits (18 minutes).
+* Recording finds the bucket from the position of the highest set bit and increments it atomically,
+* in constant time, from any thread or from processes sharing the histogram memory.
+*
+* The module has no dependency on the UT framework, so that the tracing shim in tools/trace can use it.
+*/
+
+#ifndef TEST_HISTOGRAM_H
+#define TEST_HISTOGRAM_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define TEST_HISTOGRAM_SUB_BITS     (5)
+#define TEST_HISTOGRAM_SUB_COUNT    (1 << TEST_HISTOGRAM_SUB_BITS)
+#define TEST_HISTOGRAM_MAX_BITS     (40)
+#define TEST_HISTOGRAM_BUCKETS      ((TEST_HISTOGRAM_MAX_BITS - TEST_HISTOGRAM_SUB_BITS + 1) * TEST_HISTOGRAM_SUB_COUNT)
+
+/* Zeroed memory is an empty histogram */
+typedef struct
+{
+    volatile uint64_t count;
+    volatile uint64_t sumNs;
+    volatile uint64_t maxNs;
+    volatile uint64_t minNsPlusOne;             /*!< Smallest value plus one, 0 while empty */
+    volatile uint64_t buckets[TEST_HISTOGRAM_BUCKETS];
+} test_histogram_t;
+
+/**
+ * @brief Record one value
+ *
+ * @param[in] pHistogram - histogram to update
+ * @param[in] valueNs - latency in nanoseconds, values beyond TEST_HISTOGRAM_MAX_BITS are counted in the last bucket
+ */
+void test_histogram_record(test_histogram_t *pHistogram, uint64_t valueNs);
+
+/**
+ * @brief Value at a percentile
+ *
+ * @param[in] pHistogram - histogram to read
+ * @param[in] percentile - 0.0 to 100.0
+ *
+ * @return uint64_t - highest value of the bucket holding the percentile, never above the largest value recorded
+ */
+uint64_t test_histogram_percentile(const test_histogram_t *pHistogram, double percentile);
+
+/**
+ * @brief Write the percentile distribution of one histogram
+ *
+ * The distribution follows the HdrHistogram text layout (.hgrm), in microseconds, preceded by a
+ * "# API <name>" line and a summary line.
+ *
+ * @param[in] pFile - output
+ * @param[in] pName - name of the histogram
+ * @param[in] pHistogram - histogram to write, nothing is written while it is empty
+ */
+void test_histogram_write(FILE *pFile, const char *pName, const test_histogram_t *pHistogram);
+
+/**
+ * @brief Replace a file with the distributions of a table of histograms
+ *
+ * @param[in] pPath - file to write
+ * @param[in] pNames - name of each histogram
+ * @param[in] pTable - histograms
+ * @param[in] count - number of histograms
+ *
+ * @return int - 0 on success, -1 if the file cannot be written
+ */
+int test_histogram_dump(const char *pPath, const char *const *pNames, const test_histogram_t *pTable, int count);
+
+#endif /* TEST_HISTOGRAM_H */
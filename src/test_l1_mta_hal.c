@@ -40,6 +40,7 @@
 #include<string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include "test_runner.h"
 
 static int gTestGroup = 1;
 static int gTestID = 1;
@@ -2928,7 +2929,7 @@ void test_l1_mta_hal_negative1_getMtaProvisioningStatus(void)
     UT_LOG_INFO("Out %s\n", __FUNCTION__);
 }
 
-static UT_test_suite_t * pSuite = NULL;
+static test_runner_suite_t * pSuite = NULL;
 
 /**
  * @brief Register the main tests for this module
@@ -2939,7 +2940,7 @@ int test_mta_hal_l1_register(void)
 {
     bool batterySupported;
     // Create the test suite
-    pSuite = UT_add_suite("[L1 mta_hal]", init_mta_hal_init, NULL);
+    pSuite = test_runner_add_suite("[L1 mta_hal]", init_mta_hal_init, NULL);
     if (pSuite == NULL)
     {
         return -1;
@@ -2947,86 +2948,86 @@ int test_mta_hal_l1_register(void)
     batterySupported = UT_KVP_PROFILE_GET_BOOL("mta.batterySupported");
     UT_LOG_DEBUG("batterySupported value from profile : %d \n",batterySupported);
 
-    UT_add_test( pSuite, "l1_mta_hal_positive1_InitDB", test_l1_mta_hal_positive1_InitDB);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_InitDB", test_l1_mta_hal_positive2_InitDB);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetDHCPInfo", test_l1_mta_hal_positive1_GetDHCPInfo);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetDHCPInfo", test_l1_mta_hal_negative1_GetDHCPInfo);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetDHCPV6Info", test_l1_mta_hal_positive1_GetDHCPV6Info);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetDHCPV6Info", test_l1_mta_hal_negative1_GetDHCPV6Info);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetServiceFlow", test_l1_mta_hal_positive1_GetServiceFlow);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetServiceFlow", test_l1_mta_hal_negative1_GetServiceFlow);
-    UT_add_test( pSuite, "l1_mta_hal_negative2_GetServiceFlow", test_l1_mta_hal_negative2_GetServiceFlow);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetHandsets", test_l1_mta_hal_positive1_GetHandsets);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_GetHandsets", test_l1_mta_hal_positive2_GetHandsets);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetHandsets", test_l1_mta_hal_negative1_GetHandsets);
-    UT_add_test( pSuite, "l1_mta_hal_negative2_GetHandsets", test_l1_mta_hal_negative2_GetHandsets);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetDSXLogs", test_l1_mta_hal_positive1_GetDSXLogs);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetDSXLogs", test_l1_mta_hal_negative1_GetDSXLogs);
-    UT_add_test( pSuite, "l1_mta_hal_negative2_GetDSXLogs", test_l1_mta_hal_negative2_GetDSXLogs);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetDSXLogEnable", test_l1_mta_hal_positive1_GetDSXLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetDSXLogEnable", test_l1_mta_hal_negative1_GetDSXLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_SetDSXLogEnable", test_l1_mta_hal_positive1_SetDSXLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_SetDSXLogEnable", test_l1_mta_hal_positive2_SetDSXLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_SetDSXLogEnable", test_l1_mta_hal_negative1_SetDSXLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_ClearDSXLog", test_l1_mta_hal_positive1_ClearDSXLog);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_ClearDSXLog", test_l1_mta_hal_positive2_ClearDSXLog);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_ClearDSXLog", test_l1_mta_hal_negative1_ClearDSXLog);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetCallSignallingLogEnable", test_l1_mta_hal_positive1_GetCallSignallingLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetCallSignallingLogEnable", test_l1_mta_hal_negative1_GetCallSignallingLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_SetCallSignallingLogEnable", test_l1_mta_hal_positive1_SetCallSignallingLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_SetCallSignallingLogEnable", test_l1_mta_hal_positive2_SetCallSignallingLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_SetCallSignallingLogEnable", test_l1_mta_hal_negative1_SetCallSignallingLogEnable);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_ClearCallSignallingLog", test_l1_mta_hal_positive1_ClearCallSignallingLog);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_ClearCallSignallingLog", test_l1_mta_hal_positive2_ClearCallSignallingLog);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_ClearCallSignallingLog", test_l1_mta_hal_negative1_ClearCallSignallingLog);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_GetMtaLog", test_l1_mta_hal_positive1_GetMtaLog);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_GetMtaLog", test_l1_mta_hal_negative1_GetMtaLog);
-    UT_add_test( pSuite, "l1_mta_hal_negative2_GetMtaLog", test_l1_mta_hal_negative2_GetMtaLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_InitDB", test_l1_mta_hal_positive1_InitDB);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_InitDB", test_l1_mta_hal_positive2_InitDB);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetDHCPInfo", test_l1_mta_hal_positive1_GetDHCPInfo);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetDHCPInfo", test_l1_mta_hal_negative1_GetDHCPInfo);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetDHCPV6Info", test_l1_mta_hal_positive1_GetDHCPV6Info);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetDHCPV6Info", test_l1_mta_hal_negative1_GetDHCPV6Info);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetServiceFlow", test_l1_mta_hal_positive1_GetServiceFlow);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetServiceFlow", test_l1_mta_hal_negative1_GetServiceFlow);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative2_GetServiceFlow", test_l1_mta_hal_negative2_GetServiceFlow);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetHandsets", test_l1_mta_hal_positive1_GetHandsets);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_GetHandsets", test_l1_mta_hal_positive2_GetHandsets);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetHandsets", test_l1_mta_hal_negative1_GetHandsets);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative2_GetHandsets", test_l1_mta_hal_negative2_GetHandsets);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetDSXLogs", test_l1_mta_hal_positive1_GetDSXLogs);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetDSXLogs", test_l1_mta_hal_negative1_GetDSXLogs);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative2_GetDSXLogs", test_l1_mta_hal_negative2_GetDSXLogs);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetDSXLogEnable", test_l1_mta_hal_positive1_GetDSXLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetDSXLogEnable", test_l1_mta_hal_negative1_GetDSXLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_SetDSXLogEnable", test_l1_mta_hal_positive1_SetDSXLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_SetDSXLogEnable", test_l1_mta_hal_positive2_SetDSXLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_SetDSXLogEnable", test_l1_mta_hal_negative1_SetDSXLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_ClearDSXLog", test_l1_mta_hal_positive1_ClearDSXLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_ClearDSXLog", test_l1_mta_hal_positive2_ClearDSXLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_ClearDSXLog", test_l1_mta_hal_negative1_ClearDSXLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetCallSignallingLogEnable", test_l1_mta_hal_positive1_GetCallSignallingLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetCallSignallingLogEnable", test_l1_mta_hal_negative1_GetCallSignallingLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_SetCallSignallingLogEnable", test_l1_mta_hal_positive1_SetCallSignallingLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_SetCallSignallingLogEnable", test_l1_mta_hal_positive2_SetCallSignallingLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_SetCallSignallingLogEnable", test_l1_mta_hal_negative1_SetCallSignallingLogEnable);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_ClearCallSignallingLog", test_l1_mta_hal_positive1_ClearCallSignallingLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_ClearCallSignallingLog", test_l1_mta_hal_positive2_ClearCallSignallingLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_ClearCallSignallingLog", test_l1_mta_hal_negative1_ClearCallSignallingLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_GetMtaLog", test_l1_mta_hal_positive1_GetMtaLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_GetMtaLog", test_l1_mta_hal_negative1_GetMtaLog);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative2_GetMtaLog", test_l1_mta_hal_negative2_GetMtaLog);
 
     if(batterySupported == true)
     {
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetInstalled", test_l1_mta_hal_positive1_BatteryGetInstalled);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetInstalled", test_l1_mta_hal_negative1_BatteryGetInstalled);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetTotalCapacity", test_l1_mta_hal_positive1_BatteryGetTotalCapacity);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetTotalCapacity", test_l1_mta_hal_negative1_BatteryGetTotalCapacity);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetActualCapacity", test_l1_mta_hal_positive1_BatteryGetActualCapacity);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetActualCapacity", test_l1_mta_hal_negative1_BatteryGetActualCapacity);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetRemainingCharge", test_l1_mta_hal_positive1_BatteryGetRemainingCharge);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetRemainingCharge", test_l1_mta_hal_negative1_BatteryGetRemainingCharge);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetRemainingTime", test_l1_mta_hal_positive1_BatteryGetRemainingTime);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetRemainingTime", test_l1_mta_hal_negative1_BatteryGetRemainingTime);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetNumberofCycles", test_l1_mta_hal_positive1_BatteryGetNumberofCycles);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetNumberofCycles", test_l1_mta_hal_negative1_BatteryGetNumberofCycles);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetPowerStatus", test_l1_mta_hal_positive1_BatteryGetPowerStatus);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetPowerStatus", test_l1_mta_hal_negative1_BatteryGetPowerStatus);
-        UT_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetPowerStatus", test_l1_mta_hal_negative2_BatteryGetPowerStatus);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetCondition", test_l1_mta_hal_positive1_BatteryGetCondition);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetCondition", test_l1_mta_hal_negative1_BatteryGetCondition);
-        UT_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetCondition", test_l1_mta_hal_negative2_BatteryGetCondition);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetStatus", test_l1_mta_hal_positive1_BatteryGetStatus);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetStatus", test_l1_mta_hal_negative1_BatteryGetStatus);
-        UT_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetStatus", test_l1_mta_hal_negative2_BatteryGetStatus);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetLife", test_l1_mta_hal_positive1_BatteryGetLife);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetLife", test_l1_mta_hal_negative1_BatteryGetLife);
-        UT_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetLife", test_l1_mta_hal_negative2_BatteryGetLife);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetInfo", test_l1_mta_hal_positive1_BatteryGetInfo);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetInfo", test_l1_mta_hal_negative1_BatteryGetInfo);
-        UT_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetPowerSavingModeStatus", test_l1_mta_hal_positive1_BatteryGetPowerSavingModeStatus);
-        UT_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetPowerSavingModeStatus", test_l1_mta_hal_negative1_BatteryGetPowerSavingModeStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetInstalled", test_l1_mta_hal_positive1_BatteryGetInstalled);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetInstalled", test_l1_mta_hal_negative1_BatteryGetInstalled);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetTotalCapacity", test_l1_mta_hal_positive1_BatteryGetTotalCapacity);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetTotalCapacity", test_l1_mta_hal_negative1_BatteryGetTotalCapacity);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetActualCapacity", test_l1_mta_hal_positive1_BatteryGetActualCapacity);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetActualCapacity", test_l1_mta_hal_negative1_BatteryGetActualCapacity);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetRemainingCharge", test_l1_mta_hal_positive1_BatteryGetRemainingCharge);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetRemainingCharge", test_l1_mta_hal_negative1_BatteryGetRemainingCharge);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetRemainingTime", test_l1_mta_hal_positive1_BatteryGetRemainingTime);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetRemainingTime", test_l1_mta_hal_negative1_BatteryGetRemainingTime);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetNumberofCycles", test_l1_mta_hal_positive1_BatteryGetNumberofCycles);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetNumberofCycles", test_l1_mta_hal_negative1_BatteryGetNumberofCycles);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetPowerStatus", test_l1_mta_hal_positive1_BatteryGetPowerStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetPowerStatus", test_l1_mta_hal_negative1_BatteryGetPowerStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetPowerStatus", test_l1_mta_hal_negative2_BatteryGetPowerStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetCondition", test_l1_mta_hal_positive1_BatteryGetCondition);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetCondition", test_l1_mta_hal_negative1_BatteryGetCondition);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetCondition", test_l1_mta_hal_negative2_BatteryGetCondition);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetStatus", test_l1_mta_hal_positive1_BatteryGetStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetStatus", test_l1_mta_hal_negative1_BatteryGetStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetStatus", test_l1_mta_hal_negative2_BatteryGetStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetLife", test_l1_mta_hal_positive1_BatteryGetLife);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetLife", test_l1_mta_hal_negative1_BatteryGetLife);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative2_BatteryGetLife", test_l1_mta_hal_negative2_BatteryGetLife);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetInfo", test_l1_mta_hal_positive1_BatteryGetInfo);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetInfo", test_l1_mta_hal_negative1_BatteryGetInfo);
+        test_runner_add_test( pSuite, "l1_mta_hal_positive1_BatteryGetPowerSavingModeStatus", test_l1_mta_hal_positive1_BatteryGetPowerSavingModeStatus);
+        test_runner_add_test( pSuite, "l1_mta_hal_negative1_BatteryGetPowerSavingModeStatus", test_l1_mta_hal_negative1_BatteryGetPowerSavingModeStatus);
     }
-    UT_add_test( pSuite, "l1_mta_hal_positive1_Get_MTAResetCount", test_l1_mta_hal_positive1_Get_MTAResetCount);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_Get_MTAResetCount", test_l1_mta_hal_negative1_Get_MTAResetCount);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_Get_LineResetCount", test_l1_mta_hal_positive1_Get_LineResetCount);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_Get_LineResetCount", test_l1_mta_hal_negative1_Get_LineResetCount);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_ClearCalls", test_l1_mta_hal_positive1_ClearCalls);
-    UT_add_test( pSuite, "l1_mta_hal_positive2_ClearCalls", test_l1_mta_hal_positive2_ClearCalls);
-    UT_add_test( pSuite, "l1_mta_hal_positive3_ClearCalls", test_l1_mta_hal_positive3_ClearCalls);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_getDhcpStatus", test_l1_mta_hal_positive1_getDhcpStatus);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_getDhcpStatus", test_l1_mta_hal_negative1_getDhcpStatus);
-    UT_add_test( pSuite, "l1_mta_hal_negative2_getDhcpStatus", test_l1_mta_hal_negative2_getDhcpStatus);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_getConfigFileStatus", test_l1_mta_hal_positive1_getConfigFileStatus);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_getConfigFileStatus", test_l1_mta_hal_negative1_getConfigFileStatus);
-    UT_add_test( pSuite, "l1_mta_hal_positive1_getMtaProvisioningStatus", test_l1_mta_hal_positive1_getMtaProvisioningStatus);
-    UT_add_test( pSuite, "l1_mta_hal_negative1_getMtaProvisioningStatus", test_l1_mta_hal_negative1_getMtaProvisioningStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_Get_MTAResetCount", test_l1_mta_hal_positive1_Get_MTAResetCount);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_Get_MTAResetCount", test_l1_mta_hal_negative1_Get_MTAResetCount);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_Get_LineResetCount", test_l1_mta_hal_positive1_Get_LineResetCount);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_Get_LineResetCount", test_l1_mta_hal_negative1_Get_LineResetCount);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_ClearCalls", test_l1_mta_hal_positive1_ClearCalls);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive2_ClearCalls", test_l1_mta_hal_positive2_ClearCalls);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive3_ClearCalls", test_l1_mta_hal_positive3_ClearCalls);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_getDhcpStatus", test_l1_mta_hal_positive1_getDhcpStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_getDhcpStatus", test_l1_mta_hal_negative1_getDhcpStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative2_getDhcpStatus", test_l1_mta_hal_negative2_getDhcpStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_getConfigFileStatus", test_l1_mta_hal_positive1_getConfigFileStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_getConfigFileStatus", test_l1_mta_hal_negative1_getConfigFileStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_positive1_getMtaProvisioningStatus", test_l1_mta_hal_positive1_getMtaProvisioningStatus);
+    test_runner_add_test( pSuite, "l1_mta_hal_negative1_getMtaProvisioningStatus", test_l1_mta_hal_negative1_getMtaProvisioningStatus);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,323 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_l1_mta_hal_alloc.c
+* @page mta_hal_alloc Level 1 Allocation Tests
+*
+* ## Module's Role
+* This module checks the ownership of the heap arrays returned through double pointers by
+* mta_hal_GetServiceFlow(), mta_hal_GetHandsets(), mta_hal_GetCalls(), mta_hal_GetDSXLogs() and
+* mta_hal_GetMtaLog(). Every block the HAL allocates during a call is accounted by the allocator
+* hooks of test_alloc.h; after the caller has released the returned array, nothing allocated by the
+* call may remain outstanding.
+*
+* The suite is only registered when allocation accounting is available (glibc).
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include "mta_hal.h"
+#include <stdlib.h>
+#include <string.h>
+#include "test_alloc.h"
+#include "test_probe.h"
+#include "test_runner.h"
+
+static int gTestGroup = 5;
+static int gTestID = 1;
+
+extern int init_mta_hal_init(void);
+
+/* Log what a call allocated, relative to the statistics taken before it */
+static void alloc_log_call(int api, const test_alloc_stats_t *pBefore, ULONG count)
+{
+    test_alloc_stats_t after;
+
+    test_alloc_get(api, &after);
+    UT_LOG_DEBUG("%s returned %lu entries: %llu allocations, %llu reallocs, %llu bytes, %llu blocks outstanding",
+                 test_probe_api_name(api), count,
+                 (unsigned long long)(after.allocs - pBefore->allocs),
+                 (unsigned long long)(after.reallocs - pBefore->reallocs),
+                 (unsigned long long)(after.bytes - pBefore->bytes),
+                 (unsigned long long)(after.outstandingBlocks - pBefore->outstandingBlocks));
+}
+
+/* Check that the caller released every block the call allocated */
+static void alloc_check_released(int api, const test_alloc_stats_t *pBefore)
+{
+    test_alloc_stats_t after;
+
+    test_alloc_get(api, &after);
+    UT_LOG_DEBUG("%s blocks outstanding after release: %llu (%llu bytes)", test_probe_api_name(api),
+                 (unsigned long long)(after.outstandingBlocks - pBefore->outstandingBlocks),
+                 (unsigned long long)(after.outstandingBytes - pBefore->outstandingBytes));
+    UT_ASSERT_EQUAL(after.outstandingBlocks, pBefore->outstandingBlocks);
+    UT_ASSERT_EQUAL(after.untracked, pBefore->untracked);
+}
+
+/**
+* @brief Verify that the service flow array returned by mta_hal_GetServiceFlow() is released by free()
+*
+* **Test Group ID:** Memory: 05 @n
+* **Test Case ID:** 001 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Invoke mta_hal_GetServiceFlow | Count = 0, ppCfg = valid double pointer | RETURN_OK | Should Pass |
+* | 02 | free() the returned array | ppCfg | No block allocated by the call is outstanding | Should Pass |
+*/
+void test_l1_mta_hal_alloc_GetServiceFlow(void)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetServiceFlow);
+    test_alloc_stats_t before;
+    ULONG count = 0;
+    PMTAMGMT_MTA_SERVICE_FLOW pCfg = NULL;
+    INT result;
+
+    gTestID = 1;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_alloc_get(api, &before);
+    UT_LOG_DEBUG("Invoking mta_hal_GetServiceFlow with valid parameters");
+    result = mta_hal_GetServiceFlow(&count, &pCfg);
+    UT_LOG_DEBUG("Result : %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    alloc_log_call(api, &before, count);
+
+    free(pCfg);
+    alloc_check_released(api, &before);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+* @brief Verify that the handset array returned by mta_hal_GetHandsets() is released by free()
+*
+* **Test Group ID:** Memory: 05 @n
+* **Test Case ID:** 002 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Invoke mta_hal_GetHandsets | pulCount = 0, ppHandsets = valid double pointer | RETURN_OK | Should Pass |
+* | 02 | free() the returned array | ppHandsets | No block allocated by the call is outstanding | Should Pass |
+*/
+void test_l1_mta_hal_alloc_GetHandsets(void)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetHandsets);
+    test_alloc_stats_t before;
+    ULONG count = 0;
+    PMTAMGMT_MTA_HANDSETS_INFO pHandsets = NULL;
+    INT result;
+
+    gTestID = 2;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_alloc_get(api, &before);
+    UT_LOG_DEBUG("Invoking mta_hal_GetHandsets with valid parameters");
+    result = mta_hal_GetHandsets(&count, &pHandsets);
+    UT_LOG_DEBUG("Result : %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    alloc_log_call(api, &before, count);
+
+    free(pHandsets);
+    alloc_check_released(api, &before);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+* @brief Verify that the call array returned by mta_hal_GetCalls() is released by free()
+*
+* **Test Group ID:** Memory: 05 @n
+* **Test Case ID:** 003 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Invoke mta_hal_GetCalls | InstanceNumber = 1, Count = 0, ppCfg = valid double pointer | RETURN_OK | Should Pass |
+* | 02 | free() the returned array | ppCfg | No block allocated by the call is outstanding | Should Pass |
+*/
+void test_l1_mta_hal_alloc_GetCalls(void)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetCalls);
+    test_alloc_stats_t before;
+    ULONG count = 0;
+    PMTAMGMT_MTA_CALLS pCalls = NULL;
+    INT result;
+
+    gTestID = 3;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_alloc_get(api, &before);
+    UT_LOG_DEBUG("Invoking mta_hal_GetCalls with InstanceNumber = 1");
+    result = mta_hal_GetCalls(1, &count, &pCalls);
+    UT_LOG_DEBUG("Result : %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    alloc_log_call(api, &before, count);
+
+    free(pCalls);
+    alloc_check_released(api, &before);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+* @brief Verify that the DSX log array returned by mta_hal_GetDSXLogs() is released by free()
+*
+* **Test Group ID:** Memory: 05 @n
+* **Test Case ID:** 004 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Invoke mta_hal_GetDSXLogs | Count = 0, ppDSXLog = valid double pointer | RETURN_OK | Should Pass |
+* | 02 | free() the returned array | ppDSXLog | No block allocated by the call is outstanding | Should Pass |
+*/
+void test_l1_mta_hal_alloc_GetDSXLogs(void)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetDSXLogs);
+    test_alloc_stats_t before;
+    ULONG count = 0;
+    PMTAMGMT_MTA_DSXLOG pLog = NULL;
+    INT result;
+
+    gTestID = 4;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_alloc_get(api, &before);
+    UT_LOG_DEBUG("Invoking mta_hal_GetDSXLogs with valid parameters");
+    result = mta_hal_GetDSXLogs(&count, &pLog);
+    UT_LOG_DEBUG("Result : %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    alloc_log_call(api, &before, count);
+
+    free(pLog);
+    alloc_check_released(api, &before);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+* @brief Verify that the log array returned by mta_hal_GetMtaLog() and its descriptions are released by free()
+*
+* Every entry owns its pDescription string, which the caller releases before the array itself.
+*
+* **Test Group ID:** Memory: 05 @n
+* **Test Case ID:** 005 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** None @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Invoke mta_hal_GetMtaLog | Count = 0, ppCfg = valid double pointer | RETURN_OK | Should Pass |
+* | 02 | free() every pDescription, then the array | ppCfg | No block allocated by the call is outstanding | Should Pass |
+*/
+void test_l1_mta_hal_alloc_GetMtaLog(void)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetMtaLog);
+    test_alloc_stats_t before;
+    ULONG count = 0;
+    ULONG i;
+    PMTAMGMT_MTA_MTALOG_FULL pLog = NULL;
+    INT result;
+
+    gTestID = 5;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_alloc_get(api, &before);
+    UT_LOG_DEBUG("Invoking mta_hal_GetMtaLog with valid parameters");
+    result = mta_hal_GetMtaLog(&count, &pLog);
+    UT_LOG_DEBUG("Result : %d", result);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    alloc_log_call(api, &before, count);
+
+    if (pLog != NULL)
+    {
+        for (i = 0; i < count; i++)
+        {
+            free(pLog[i].pDescription);
+        }
+        free(pLog);
+    }
+    alloc_check_released(api, &before);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the allocation tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_l1_alloc_register(void)
+{
+    if (test_alloc_available() == false)
+    {
+        UT_LOG_DEBUG("Allocation accounting not available, allocation tests not registered");
+        return 0;
+    }
+
+    pSuite = test_runner_add_suite("[L1 mta_hal allocation]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+
+    test_runner_add_test( pSuite, "l1_mta_hal_alloc_GetServiceFlow", test_l1_mta_hal_alloc_GetServiceFlow);
+    test_runner_add_test( pSuite, "l1_mta_hal_alloc_GetHandsets", test_l1_mta_hal_alloc_GetHandsets);
+    test_runner_add_test( pSuite, "l1_mta_hal_alloc_GetCalls", test_l1_mta_hal_alloc_GetCalls);
+    test_runner_add_test( pSuite, "l1_mta_hal_alloc_GetDSXLogs", test_l1_mta_hal_alloc_GetDSXLogs);
+    test_runner_add_test( pSuite, "l1_mta_hal_alloc_GetMtaLog", test_l1_mta_hal_alloc_GetMtaLog);
+    return 0;
+}
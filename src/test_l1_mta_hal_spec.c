@@ -0,0 +1,304 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_l1_mta_hal_spec.c
+* @page mta_hal_spec Level 1 Generated Tests
+*
+* ## Module's Role
+* This module generates a positive and a negative test for every API of mta_hal_api_list.h from the
+* descriptions of test_api.h, instead of writing them one by one. The valid and invalid values and the
+* output ranges come from mta_hal_api_spec.h; an API is covered by adding a line there.
+*
+* The hand written tests of test_l1_mta_hal.c remain the reference for the APIs they cover, this suite
+* extends the same checks to every API. It is registered by default; "mta.specTests: false" in the module
+* profile leaves it out.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "test_api.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+static int gTestGroup = 6;
+static int gTestID = 1;
+
+extern int init_mta_hal_init(void);
+
+static void spec_violation(void *pContext, const char *pPath, uint64_t value, const test_api_rule_t *pRule)
+{
+    (void)pContext;
+    UT_LOG_ERROR("%s is %llu, expected %llu to %llu", pPath, (unsigned long long)value, (unsigned long long)pRule->first,
+                 (unsigned long long)pRule->last);
+}
+
+/* One valid call, the result and the outputs checked */
+static void spec_call_valid(int api, const uintptr_t *pArgs)
+{
+    const test_api_desc_t *pDesc = test_api_desc(api);
+    int64_t result;
+
+    UT_LOG_DEBUG("Invoking %s(%llu, %llu, %llu)", pDesc->pName, (unsigned long long)pArgs[0], (unsigned long long)pArgs[1],
+                 (unsigned long long)pArgs[2]);
+    result = test_api_call(api, pArgs);
+    if (pDesc->returnsStatus == true)
+    {
+        UT_LOG_DEBUG("Return status: %lld", (long long)result);
+        UT_ASSERT_EQUAL(result, RETURN_OK);
+        if (result != RETURN_OK)
+        {
+            return;
+        }
+    }
+    UT_ASSERT_EQUAL(test_api_check_outputs(api, pArgs, spec_violation, NULL), 0);
+}
+
+/**
+* @brief Valid calls of an API generated from mta_hal_api_spec.h
+*
+* The API is called with every scalar argument at the first value of its valid range, then once per
+* argument with that argument at the last value of its range. Index ranges are read from the HAL: an
+* index into an empty table has no valid value and the test only logs it.
+*
+* **Test Group ID:** Generated: 06 @n
+* **Test Case ID:** (2 x position of the API in mta_hal_api_list.h) + 1 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** "mta.specTests" is not false @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Call the API with the first valid values | outputs allocated, scalars at first | RETURN_OK, outputs in range | Should Pass |
+* | 02 | Call the API with each scalar at its last valid value | scalar at last | RETURN_OK, outputs in range | Should Pass |
+*/
+static void spec_positive(int api)
+{
+    const test_api_desc_t *pDesc = test_api_desc(api);
+    test_api_bounds_t bounds;
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+    uintptr_t first;
+    int status;
+    int arg;
+
+    gTestID = (2 * api) + 1;
+    UT_LOG_INFO("In %s %s [%02d%03d]\n", __FUNCTION__, pDesc->pName, gTestGroup, gTestID);
+
+    status = test_api_args_valid(api, args);
+    UT_ASSERT_TRUE_FATAL(status >= 0);
+    if (status == 1)
+    {
+        UT_LOG_INFO("%s has an index into an empty table, no valid call", pDesc->pName);
+        test_record_args_free(api, args);
+        UT_LOG_INFO("Out %s\n", __FUNCTION__);
+        return;
+    }
+
+    spec_call_valid(api, args);
+    for (arg = 0; arg < pDesc->argCount; arg++)
+    {
+        if ((test_record_arg_is_output(api, arg) == true) || (test_api_arg_bounds(api, arg, &bounds) == false) ||
+            (bounds.last == bounds.first))
+        {
+            continue;
+        }
+        test_record_args_release(api, args);
+        first = args[arg];
+        args[arg] = (uintptr_t)bounds.last;
+        spec_call_valid(api, args);
+        args[arg] = first;
+    }
+    test_record_args_free(api, args);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+* @brief Invalid calls of an API generated from mta_hal_api_spec.h
+*
+* Each output pointer is passed NULL in turn, the other arguments valid, then each scalar argument with
+* an invalid value in mta_hal_api_spec.h is passed that value. Destructive APIs only get these calls.
+*
+* **Test Group ID:** Generated: 06 @n
+* **Test Case ID:** (2 x position of the API in mta_hal_api_list.h) + 2 @n
+* **Priority:** High @n@n
+*
+* **Pre-Conditions:** "mta.specTests" is not false @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Call the API with each output pointer NULL | output = NULL | RETURN_ERR | Should Pass |
+* | 02 | Call the API with each scalar at its invalid value | scalar = invalid | RETURN_ERR | Should Pass |
+*/
+static void spec_negative(int api)
+{
+    const test_api_desc_t *pDesc = test_api_desc(api);
+    test_api_bounds_t bounds;
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+    uintptr_t saved;
+    int64_t result;
+    int arg;
+
+    gTestID = (2 * api) + 2;
+    UT_LOG_INFO("In %s %s [%02d%03d]\n", __FUNCTION__, pDesc->pName, gTestGroup, gTestID);
+
+    UT_ASSERT_TRUE_FATAL(test_api_args_valid(api, args) >= 0);
+    for (arg = 0; arg < pDesc->argCount; arg++)
+    {
+        if (test_record_arg_is_output(api, arg) == true)
+        {
+            saved = args[arg];
+            args[arg] = 0;
+            UT_LOG_DEBUG("Invoking %s with argument %d NULL", pDesc->pName, arg);
+            result = test_api_call(api, args);
+            UT_LOG_DEBUG("Return status: %lld", (long long)result);
+            UT_ASSERT_EQUAL(result, RETURN_ERR);
+            args[arg] = saved;
+            test_record_args_release(api, args);
+        }
+        else if ((test_api_arg_bounds(api, arg, &bounds) == true) && (bounds.invalid != TEST_API_NO_INVALID))
+        {
+            saved = args[arg];
+            args[arg] = (uintptr_t)bounds.invalid;
+            UT_LOG_DEBUG("Invoking %s with argument %d = %llu", pDesc->pName, arg, (unsigned long long)bounds.invalid);
+            result = test_api_call(api, args);
+            UT_LOG_DEBUG("Return status: %lld", (long long)result);
+            UT_ASSERT_EQUAL(result, RETURN_ERR);
+            args[arg] = saved;
+            test_record_args_release(api, args);
+        }
+    }
+    test_record_args_free(api, args);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/* An API has a negative test when an argument can be made invalid */
+static bool spec_has_negative(int api)
+{
+    test_api_bounds_t bounds;
+    int arg;
+
+    if (test_api_desc(api)->returnsStatus == false)
+    {
+        return false;
+    }
+    for (arg = 0; arg < test_api_desc(api)->argCount; arg++)
+    {
+        if ((test_record_arg_is_output(api, arg) == true) ||
+            ((test_api_arg_bounds(api, arg, &bounds) == true) && (bounds.invalid != TEST_API_NO_INVALID)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    static void test_l1_mta_hal_spec_positive_##name(void) { spec_positive(TEST_PROBE_ID(name)); } \
+    static void test_l1_mta_hal_spec_negative_##name(void) { spec_negative(TEST_PROBE_ID(name)); }
+#define MTA_HAL_API_VOID(name, parameters, arguments)
+#include "mta_hal_api_list.h"
+
+typedef struct
+{
+    int api;
+    const char *pPositiveTitle;
+    test_runner_test_fn_t positive;
+    const char *pNegativeTitle;
+    test_runner_test_fn_t negative;
+} spec_test_t;
+
+static const spec_test_t gTests[] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    { TEST_PROBE_ID(name), "l1_mta_hal_spec_positive_" #name, test_l1_mta_hal_spec_positive_##name, \
+      "l1_mta_hal_spec_negative_" #name, test_l1_mta_hal_spec_negative_##name },
+#define MTA_HAL_API_VOID(name, parameters, arguments)
+#include "mta_hal_api_list.h"
+};
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the tests generated from mta_hal_api_spec.h
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_l1_spec_register(void)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    const test_api_desc_t *pDesc;
+    size_t i;
+
+    /* On unless turned off, an absent key registers the suite */
+    if ((UT_KVP_PROFILE_GET_STRING("mta.specTests", value) == UT_KVP_STATUS_SUCCESS) && (strcmp(value, "false") == 0))
+    {
+        UT_LOG_DEBUG("mta.specTests is false, generated tests not registered");
+        return 0;
+    }
+
+    pSuite = test_runner_add_suite("[L1 mta_hal spec]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < sizeof(gTests) / sizeof(gTests[0]); i++)
+    {
+        pDesc = test_api_desc(gTests[i].api);
+        if (pDesc->pSkipReason != NULL)
+        {
+            UT_LOG_DEBUG("%s not generated: %s", pDesc->pName, pDesc->pSkipReason);
+            continue;
+        }
+        if ((pDesc->pOptionalKey != NULL) && (UT_KVP_PROFILE_GET_BOOL(pDesc->pOptionalKey) == false))
+        {
+            UT_LOG_DEBUG("%s not generated: %s not set", pDesc->pName, pDesc->pOptionalKey);
+            continue;
+        }
+        if (pDesc->destructive == false)
+        {
+            test_runner_add_test( pSuite, gTests[i].pPositiveTitle, gTests[i].positive);
+        }
+        if (spec_has_negative(gTests[i].api) == true)
+        {
+            test_runner_add_test( pSuite, gTests[i].pNegativeTitle, gTests[i].negative);
+        }
+    }
+    return 0;
+}
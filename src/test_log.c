@@ -0,0 +1,628 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "test_log.h"
+
+#define LOG_RECORD_MAX          (TEST_LOG_LINE_SIZE)    /*!< Bytes of one record, strings are truncated to fit */
+#define LOG_SPEC_SIZE           (32)                    /*!< Longest conversion specification, e.g. "%-*.*lld" */
+#define LOG_DRAIN_PERIOD_NS     (10000000L)
+
+/* Definition of the UT framework, the Makefile links every other call through __wrap_UT_logPrefix() */
+extern void __real_UT_logPrefix(const char *file, int line, const char *prefix, const char *format, ...);
+void __wrap_UT_logPrefix(const char *file, int line, const char *prefix, const char *format, ...) __attribute__((format(printf, 4, 5)));
+
+/* Type of the argument of a conversion, as read with va_arg() and passed back to snprintf() */
+typedef enum
+{
+    LOG_ARG_NONE = 0,           /*!< "%%" */
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_INTMAX,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_LDOUBLE,
+    LOG_ARG_STRING,             /*!< Copied into the record */
+    LOG_ARG_POINTER,
+    LOG_ARG_UNSUPPORTED         /*!< %n, wide characters, malformed */
+} log_arg_kind_t;
+
+typedef struct
+{
+    const char *pStart;         /*!< The '%' */
+    size_t length;
+    int stars;                  /*!< '*' width and precision, int arguments preceding the value */
+    log_arg_kind_t kind;
+} log_spec_t;
+
+/* Fixed part of a queued line, the arguments follow */
+typedef struct
+{
+    uint32_t length;            /*!< Bytes of the record, including this header */
+    int32_t line;
+    uint64_t timeNs;            /*!< CLOCK_MONOTONIC time of the call, orders the lines of all threads */
+    const char *pFile;
+    const char *pPrefix;
+    const char *pFormat;        /*!< String literal of the UT_LOG_* macro */
+} log_record_t;
+
+/* Single producer, single consumer ring of the records of one thread */
+typedef struct log_queue_s
+{
+    uint8_t *pData;
+    volatile uint64_t head;     /*!< Read by the consumer holding gLog.drainLock */
+    volatile uint64_t tail;     /*!< Written by the owning thread */
+    uint64_t limit;             /*!< Tail when the drain in progress started */
+    volatile int inUse;         /*!< Owned by a live thread, released when the thread exits */
+    struct log_queue_s *pNext;
+} log_queue_t;
+
+static struct
+{
+    volatile int mode;          /*!< test_log_mode_t */
+    log_queue_t *volatile pQueues;
+    pthread_mutex_t drainLock;
+    pthread_key_t key;
+    pthread_t thread;
+    bool threadRunning;
+    volatile int stopping;
+    volatile uint64_t lines;
+    volatile uint64_t stalls;   /*!< Full queues formatted by their own thread */
+} gLog = { .drainLock = PTHREAD_MUTEX_INITIALIZER };
+
+static pthread_once_t gLogOnce = PTHREAD_ONCE_INIT;
+static __thread log_queue_t *tQueue;
+
+static void log_drain(void);
+
+/* Parse the conversion following pFormat, returns the format after it or NULL when there is none */
+static const char *log_next_spec(const char *pFormat, log_spec_t *pSpec)
+{
+    const char *p = strchr(pFormat, '%');
+    char modifier[3] = { '\0', '\0', '\0' };
+    int numModifiers = 0;
+
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    pSpec->pStart = p++;
+    pSpec->stars = 0;
+    while ((*p != '\0') && (strchr("-+ #0'", *p) != NULL))
+    {
+        p++;
+    }
+    if (*p == '*')
+    {
+        pSpec->stars++;
+        p++;
+    }
+    while ((*p >= '0') && (*p <= '9'))
+    {
+        p++;
+    }
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*')
+        {
+            pSpec->stars++;
+            p++;
+        }
+        while ((*p >= '0') && (*p <= '9'))
+        {
+            p++;
+        }
+    }
+    while ((*p != '\0') && (strchr("hlzjtLq", *p) != NULL) && (numModifiers < 2))
+    {
+        modifier[numModifiers++] = *p++;
+    }
+
+    switch (*p)
+    {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            if ((modifier[0] == 'q') || ((modifier[0] == 'l') && (modifier[1] == 'l')))
+            {
+                pSpec->kind = LOG_ARG_LLONG;
+            }
+            else
+            {
+                pSpec->kind = (modifier[0] == 'l') ? LOG_ARG_LONG : (modifier[0] == 'z') ? LOG_ARG_SIZE :
+                              (modifier[0] == 'j') ? LOG_ARG_INTMAX : (modifier[0] == 't') ? LOG_ARG_PTRDIFF : LOG_ARG_INT;
+            }
+            break;
+        case 'c':
+            pSpec->kind = (modifier[0] == '\0') ? LOG_ARG_INT : LOG_ARG_UNSUPPORTED;
+            break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            pSpec->kind = (modifier[0] == 'L') ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+            break;
+        case 's':
+            pSpec->kind = (modifier[0] == '\0') ? LOG_ARG_STRING : LOG_ARG_UNSUPPORTED;
+            break;
+        case 'p':
+            pSpec->kind = LOG_ARG_POINTER;
+            break;
+        case '%':
+            pSpec->kind = ((p - pSpec->pStart) == 1) ? LOG_ARG_NONE : LOG_ARG_UNSUPPORTED;
+            break;
+        default:
+            pSpec->kind = LOG_ARG_UNSUPPORTED;
+            break;
+    }
+    if (*p != '\0')
+    {
+        p++;
+    }
+    pSpec->length = (size_t)(p - pSpec->pStart);
+    return p;
+}
+
+static bool log_put(uint8_t *pRecord, size_t *pUsed, const void *pValue, size_t size)
+{
+    if ((*pUsed + size) > LOG_RECORD_MAX)
+    {
+        return false;
+    }
+    memcpy(&pRecord[*pUsed], pValue, size);
+    *pUsed += size;
+    return true;
+}
+
+/* Copy the arguments of a line after the record header, false if the format cannot be queued */
+static bool log_encode(uint8_t *pRecord, size_t *pLength, const char *pFormat, va_list args)
+{
+    const char *pNext;
+    const char *pString;
+    log_spec_t spec;
+    size_t used = sizeof(log_record_t);
+    size_t length;
+    long double longDouble;
+    double real;
+    int64_t integer;
+    int i;
+
+    while ((pNext = log_next_spec(pFormat, &spec)) != NULL)
+    {
+        pFormat = pNext;
+        if (spec.kind == LOG_ARG_UNSUPPORTED)
+        {
+            return false;
+        }
+        for (i = 0; i < spec.stars; i++)
+        {
+            integer = va_arg(args, int);
+            if (log_put(pRecord, &used, &integer, sizeof(integer)) == false)
+            {
+                return false;
+            }
+        }
+        switch (spec.kind)
+        {
+            case LOG_ARG_INT:
+                integer = va_arg(args, int);
+                break;
+            case LOG_ARG_LONG:
+                integer = va_arg(args, long);
+                break;
+            case LOG_ARG_LLONG:
+                integer = va_arg(args, long long);
+                break;
+            case LOG_ARG_SIZE:
+                integer = (int64_t)va_arg(args, size_t);
+                break;
+            case LOG_ARG_INTMAX:
+                integer = va_arg(args, intmax_t);
+                break;
+            case LOG_ARG_PTRDIFF:
+                integer = va_arg(args, ptrdiff_t);
+                break;
+            case LOG_ARG_POINTER:
+                integer = (int64_t)(intptr_t)va_arg(args, void *);
+                break;
+            case LOG_ARG_DOUBLE:
+                real = va_arg(args, double);
+                if (log_put(pRecord, &used, &real, sizeof(real)) == false)
+                {
+                    return false;
+                }
+                continue;
+            case LOG_ARG_LDOUBLE:
+                longDouble = va_arg(args, long double);
+                if (log_put(pRecord, &used, &longDouble, sizeof(longDouble)) == false)
+                {
+                    return false;
+                }
+                continue;
+            case LOG_ARG_STRING:
+                pString = va_arg(args, const char *);
+                pString = (pString != NULL) ? pString : "(null)";
+                if (used >= LOG_RECORD_MAX)
+                {
+                    return false;
+                }
+                /* Truncated to the room left, as the line would be */
+                length = strnlen(pString, LOG_RECORD_MAX - used - 1);
+                memcpy(&pRecord[used], pString, length);
+                pRecord[used + length] = '\0';
+                used += length + 1;
+                continue;
+            default:
+                continue;
+        }
+        if (log_put(pRecord, &used, &integer, sizeof(integer)) == false)
+        {
+            return false;
+        }
+    }
+    *pLength = used;
+    return true;
+}
+
+static int64_t log_get_integer(const uint8_t *pArgs, size_t *pOffset)
+{
+    int64_t value;
+
+    memcpy(&value, &pArgs[*pOffset], sizeof(value));
+    *pOffset += sizeof(value);
+    return value;
+}
+
+/* Format a record as vsnprintf() would have formatted the original call */
+static void log_format(const log_record_t *pRecord, const uint8_t *pArgs, char *pOut, size_t size)
+{
+    const char *pFormat = pRecord->pFormat;
+    const char *pNext;
+    char specText[LOG_SPEC_SIZE];
+    log_spec_t spec;
+    long double longDouble;
+    double real;
+    size_t offset = 0;
+    size_t used = 0;
+    int stars[2] = { 0, 0 };
+    int written = 0;
+    int i;
+
+#define LOG_PRINT(value) \
+    ((spec.stars == 0) ? snprintf(&pOut[used], size - used, specText, (value)) : \
+     (spec.stars == 1) ? snprintf(&pOut[used], size - used, specText, stars[0], (value)) : \
+                         snprintf(&pOut[used], size - used, specText, stars[0], stars[1], (value)))
+
+    pOut[0] = '\0';
+    while (((pNext = log_next_spec(pFormat, &spec)) != NULL) && (used < (size - 1)))
+    {
+        written = snprintf(&pOut[used], size - used, "%.*s", (int)(spec.pStart - pFormat), pFormat);
+        used += ((size_t)written < (size - used)) ? (size_t)written : (size - used - 1);
+        snprintf(specText, sizeof(specText), "%.*s", (int)spec.length, spec.pStart);
+        for (i = 0; i < spec.stars; i++)
+        {
+            stars[i] = (int)log_get_integer(pArgs, &offset);
+        }
+        switch (spec.kind)
+        {
+            case LOG_ARG_INT:
+                written = LOG_PRINT((int)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_LONG:
+                written = LOG_PRINT((long)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_LLONG:
+                written = LOG_PRINT((long long)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_SIZE:
+                written = LOG_PRINT((size_t)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_INTMAX:
+                written = LOG_PRINT((intmax_t)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_PTRDIFF:
+                written = LOG_PRINT((ptrdiff_t)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_POINTER:
+                written = LOG_PRINT((void *)(intptr_t)log_get_integer(pArgs, &offset));
+                break;
+            case LOG_ARG_DOUBLE:
+                memcpy(&real, &pArgs[offset], sizeof(real));
+                offset += sizeof(real);
+                written = LOG_PRINT(real);
+                break;
+            case LOG_ARG_LDOUBLE:
+                memcpy(&longDouble, &pArgs[offset], sizeof(longDouble));
+                offset += sizeof(longDouble);
+                written = LOG_PRINT(longDouble);
+                break;
+            case LOG_ARG_STRING:
+                written = LOG_PRINT((const char *)&pArgs[offset]);
+                offset += strlen((const char *)&pArgs[offset]) + 1;
+                break;
+            default:
+                written = snprintf(&pOut[used], size - used, "%%");
+                break;
+        }
+        used += ((written >= 0) && ((size_t)written < (size - used))) ? (size_t)written : (size - used - 1);
+        pFormat = pNext;
+    }
+    if (used < (size - 1))
+    {
+        snprintf(&pOut[used], size - used, "%s", pFormat);
+    }
+#undef LOG_PRINT
+}
+
+static void log_ring_copy(uint8_t *pRing, uint64_t offset, uint8_t *pData, size_t length, bool toRing)
+{
+    size_t index = (size_t)(offset & (TEST_LOG_QUEUE_SIZE - 1));
+    size_t first = TEST_LOG_QUEUE_SIZE - index;
+
+    first = (first < length) ? first : length;
+    if (toRing == true)
+    {
+        memcpy(&pRing[index], pData, first);
+        memcpy(pRing, &pData[first], length - first);
+    }
+    else
+    {
+        memcpy(pData, &pRing[index], first);
+        memcpy(&pData[first], pRing, length - first);
+    }
+}
+
+static void log_queue_release(void *pQueue)
+{
+    __sync_lock_release(&((log_queue_t *)pQueue)->inUse);
+}
+
+/* Queue of the calling thread, a queue released by an exited thread is taken over before creating one */
+static log_queue_t *log_queue_get(void)
+{
+    log_queue_t *pQueue;
+
+    if (tQueue != NULL)
+    {
+        return tQueue;
+    }
+    for (pQueue = gLog.pQueues; pQueue != NULL; pQueue = pQueue->pNext)
+    {
+        if (__sync_bool_compare_and_swap(&pQueue->inUse, 0, 1) != 0)
+        {
+            break;
+        }
+    }
+    if (pQueue == NULL)
+    {
+        pQueue = calloc(1, sizeof(log_queue_t));
+        if (pQueue == NULL)
+        {
+            return NULL;
+        }
+        pQueue->pData = malloc(TEST_LOG_QUEUE_SIZE);
+        if (pQueue->pData == NULL)
+        {
+            free(pQueue);
+            return NULL;
+        }
+        pQueue->inUse = 1;
+        do
+        {
+            pQueue->pNext = gLog.pQueues;
+        } while (__sync_bool_compare_and_swap(&gLog.pQueues, pQueue->pNext, pQueue) == 0);
+    }
+    (void)pthread_setspecific(gLog.key, pQueue);
+    tQueue = pQueue;
+    return pQueue;
+}
+
+static bool log_enqueue(uint8_t *pRecord, size_t length)
+{
+    log_queue_t *pQueue = log_queue_get();
+    uint64_t tail;
+
+    if (pQueue == NULL)
+    {
+        return false;
+    }
+    tail = pQueue->tail;
+    if ((tail + length - __atomic_load_n(&pQueue->head, __ATOMIC_ACQUIRE)) > TEST_LOG_QUEUE_SIZE)
+    {
+        __sync_fetch_and_add(&gLog.stalls, 1);
+        test_log_flush();
+    }
+    log_ring_copy(pQueue->pData, tail, pRecord, length, true);
+    __atomic_store_n(&pQueue->tail, tail + length, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* Write the records queued when the drain starts, oldest first across the queues; gLog.drainLock held */
+static void log_drain(void)
+{
+    uint8_t record[LOG_RECORD_MAX];
+    char text[TEST_LOG_LINE_SIZE];
+    log_record_t header;
+    log_record_t oldest;
+    log_queue_t *pOldest;
+    log_queue_t *pQueue;
+
+    for (pQueue = gLog.pQueues; pQueue != NULL; pQueue = pQueue->pNext)
+    {
+        pQueue->limit = __atomic_load_n(&pQueue->tail, __ATOMIC_ACQUIRE);
+    }
+    for (;;)
+    {
+        pOldest = NULL;
+        for (pQueue = gLog.pQueues; pQueue != NULL; pQueue = pQueue->pNext)
+        {
+            if (pQueue->head == pQueue->limit)
+            {
+                continue;
+            }
+            log_ring_copy(pQueue->pData, pQueue->head, (uint8_t *)&header, sizeof(header), false);
+            if ((pOldest == NULL) || (header.timeNs < oldest.timeNs))
+            {
+                pOldest = pQueue;
+                oldest = header;
+            }
+        }
+        if (pOldest == NULL)
+        {
+            break;
+        }
+        log_ring_copy(pOldest->pData, pOldest->head, record, oldest.length, false);
+        __atomic_store_n(&pOldest->head, pOldest->head + oldest.length, __ATOMIC_RELEASE);
+        log_format(&oldest, &record[sizeof(log_record_t)], text, sizeof(text));
+        __real_UT_logPrefix(oldest.pFile, oldest.line, oldest.pPrefix, "%s", text);
+        gLog.lines++;
+    }
+}
+
+static void *log_thread(void *pArg)
+{
+    struct timespec period = { 0, LOG_DRAIN_PERIOD_NS };
+
+    (void)pArg;
+    while (gLog.stopping == 0)
+    {
+        nanosleep(&period, NULL);
+        test_log_flush();
+    }
+    return NULL;
+}
+
+/* Nothing queued crosses a fork, the child would write the lines of its parent again */
+static void log_fork_prepare(void)
+{
+    pthread_mutex_lock(&gLog.drainLock);
+    log_drain();
+}
+
+static void log_fork_parent(void)
+{
+    pthread_mutex_unlock(&gLog.drainLock);
+}
+
+static void log_fork_child(void)
+{
+    pthread_mutex_unlock(&gLog.drainLock);
+    gLog.mode = TEST_LOG_SYNC;
+    gLog.threadRunning = false;
+}
+
+static void log_init(void)
+{
+    (void)pthread_key_create(&gLog.key, log_queue_release);
+    (void)pthread_atfork(log_fork_prepare, log_fork_parent, log_fork_child);
+}
+
+void __wrap_UT_logPrefix(const char *file, int line, const char *prefix, const char *format, ...)
+{
+    uint8_t record[LOG_RECORD_MAX];
+    char text[TEST_LOG_LINE_SIZE];
+    log_record_t header;
+    struct timespec ts;
+    size_t length;
+    va_list args;
+    bool encoded;
+
+    if (__atomic_load_n(&gLog.mode, __ATOMIC_ACQUIRE) != TEST_LOG_SYNC)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        va_start(args, format);
+        encoded = log_encode(record, &length, format, args);
+        va_end(args);
+        if (encoded == true)
+        {
+            header.length = (uint32_t)length;
+            header.line = line;
+            header.timeNs = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+            header.pFile = file;
+            header.pPrefix = prefix;
+            header.pFormat = format;
+            memcpy(record, &header, sizeof(header));
+            if (log_enqueue(record, length) == true)
+            {
+                return;
+            }
+        }
+        /* Written now, after the lines queued before it */
+        test_log_flush();
+    }
+
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    __real_UT_logPrefix(file, line, prefix, "%s", text);
+}
+
+void test_log_start(test_log_mode_t mode)
+{
+    if (mode == TEST_LOG_SYNC)
+    {
+        return;
+    }
+    pthread_once(&gLogOnce, log_init);
+    gLog.lines = 0;
+    gLog.stalls = 0;
+    gLog.stopping = 0;
+    if (mode == TEST_LOG_BACKGROUND)
+    {
+        gLog.threadRunning = (pthread_create(&gLog.thread, NULL, log_thread, NULL) == 0);
+        if (gLog.threadRunning == false)
+        {
+            UT_LOG_INFO("Unable to start the log thread, lines are written when the run ends");
+            mode = TEST_LOG_DEFERRED;
+        }
+    }
+    __atomic_store_n(&gLog.mode, (int)mode, __ATOMIC_RELEASE);
+}
+
+void test_log_stop(void)
+{
+    if (gLog.mode == TEST_LOG_SYNC)
+    {
+        return;
+    }
+    if (gLog.threadRunning == true)
+    {
+        gLog.stopping = 1;
+        pthread_join(gLog.thread, NULL);
+        gLog.threadRunning = false;
+    }
+    __atomic_store_n(&gLog.mode, TEST_LOG_SYNC, __ATOMIC_RELEASE);
+    test_log_flush();
+    UT_LOG_INFO("Log sink: %llu lines queued, %llu full queues formatted by their own thread",
+                (unsigned long long)gLog.lines, (unsigned long long)gLog.stalls);
+}
+
+void test_log_flush(void)
+{
+    pthread_mutex_lock(&gLog.drainLock);
+    log_drain();
+    pthread_mutex_unlock(&gLog.drainLock);
+}
@@ -0,0 +1,70 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_log.h
+*
+* Asynchronous sink for the UT_LOG_* macros, so that log formatting and I/O stay out of timed loops.
+*
+* The Makefile links every call to UT_logPrefix() through __wrap_UT_logPrefix(). While the sink is
+* off, each line is formatted and handed to the UT framework at once, as before. While it is on, the
+* calling thread only appends a binary record to a queue of its own: the source location, the
+* format string pointer, a timestamp and the raw arguments, strings copied. No lock is taken and no
+* system call made. Records are formatted and written by a background thread every few milliseconds,
+* or, in deferred mode, only when the sink stops. Lines of all threads are written in time order.
+*
+* A thread whose queue is full formats its queue itself, which is counted and reported when the sink
+* stops. Records still queued are lost if the process crashes. A format the sink cannot encode (%n,
+* wide characters) is written synchronously.
+*/
+
+#ifndef TEST_LOG_H
+#define TEST_LOG_H
+
+#define TEST_LOG_QUEUE_SIZE     (256 * 1024)    /*!< Bytes of the queue of each logging thread, a power of two */
+#define TEST_LOG_LINE_SIZE      (2048)          /*!< Longest line written, as the UT framework */
+
+typedef enum
+{
+    TEST_LOG_SYNC = 0,          /*!< Every line formatted and written by the caller */
+    TEST_LOG_BACKGROUND,        /*!< Records formatted by a background thread */
+    TEST_LOG_DEFERRED           /*!< Records formatted when the sink stops, or a queue fills */
+} test_log_mode_t;
+
+/**
+ * @brief Start queueing the lines of every thread
+ *
+ * A forked child starts with the sink off, its queues were emptied before the fork.
+ *
+ * @param[in] mode - test_log_mode_t, TEST_LOG_SYNC does nothing
+ */
+void test_log_start(test_log_mode_t mode);
+
+/**
+ * @brief Write every queued line, stop the background thread and log synchronously again
+ *
+ * Reports the number of lines and of full queues when the sink was on.
+ */
+void test_log_stop(void);
+
+/**
+ * @brief Write every line queued so far, from the calling thread
+ */
+void test_log_flush(void);
+
+#endif /* TEST_LOG_H */
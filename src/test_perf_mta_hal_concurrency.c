@@ -0,0 +1,738 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_concurrency.c
+* @page mta_hal_perf_concurrency Cross-Process Concurrent Access Benchmark
+*
+* ## Module's Role
+* This module measures how the mta_hal behaves when several processes use it at the same time, as
+* CcspMtaAgent, telemetry and the web UI do on a device, each with its own instance of the vendor
+* libhal_mta. Every client is a separate process, the test binary started again with
+* "--concurrency-client", which loads the library, calls mta_hal_InitDB() and then issues its mix of
+* calls back to back; throughput and tail latency are reported per process. A client still running
+* CONC_GRACE_NS after the end of a phase is killed and reported as hung.
+*
+* Clients flagged as "dumper" (typically a log dump from the web UI) are left out of a first, quiet
+* phase and added in a second, contended phase. Comparing the two phases shows whether a dump starves
+* the other processes.
+*
+* The clients are described in a concurrency profile, see profiles/perf/mta_concurrent_clients.yaml,
+* selected with the key "mta.perf.concurrencyProfile" of the module profile; the suite is not
+* registered when the key is empty.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "test_api.h"
+#include "test_bench.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+#define CONC_MAX_CLIENTS        (8)
+#define CONC_MAX_CALLS          (16)
+#define CONC_MAX_SAMPLES        (1U << 18)
+#define CONC_KEY_SIZE           (128)
+#define CONC_NAME_SIZE          (32)
+#define CONC_NS_PER_US          (1000ULL)
+#define CONC_NS_PER_MS          (1000000ULL)
+#define CONC_NS_PER_SEC         (1000000000ULL)
+#define CONC_READY_TIMEOUT_NS   (30ULL * CONC_NS_PER_SEC)
+#define CONC_GRACE_NS           (10ULL * CONC_NS_PER_SEC)
+#define CONC_SHARED_TEMPLATE    "/tmp/mta_hal_conc.XXXXXX"
+#define CONC_SELF_EXE           "/proc/self/exe"
+#define CONC_CLIENT_SWITCH      "--concurrency-client"
+
+typedef struct
+{
+    int api;                        /*!< test_probe_api_t */
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+} conc_call_t;
+
+typedef struct
+{
+    char name[CONC_NAME_SIZE];
+    bool dumper;                    /*!< Only runs in the contended phase */
+    uint32_t thinkMs;               /*!< Pause after each call */
+    int numCalls;                   /*!< Calls loaded, whose arguments are allocated */
+    conc_call_t calls[CONC_MAX_CALLS];
+} conc_client_t;
+
+/* Outcome of one client process, written into memory shared with the test */
+typedef struct
+{
+    volatile int ready;             /*!< mta_hal_InitDB() has returned */
+    volatile int done;
+    INT initRet;
+    uint64_t initNs;
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t elapsedNs;
+    uint64_t p50Ns;
+    uint64_t p99Ns;
+    uint64_t p999Ns;
+    uint64_t maxNs;
+} conc_result_t;
+
+typedef struct
+{
+    volatile int go;
+    uint64_t stopNs;
+    conc_result_t results[CONC_MAX_CLIENTS];
+} conc_shared_t;
+
+typedef enum
+{
+    CONC_PHASE_QUIET = 0,           /*!< Clients without the dumper flag */
+    CONC_PHASE_CONTENDED,           /*!< All clients */
+    CONC_PHASE_COUNT
+} conc_phase_t;
+
+static const char *gPhaseNames[CONC_PHASE_COUNT] = { "quiet", "contended" };
+
+static int gTestGroup = 4;
+static int gTestID = 2;
+
+static char gConcurrencyProfile[UT_KVP_MAX_ELEMENT_SIZE];
+
+static void conc_sleep_ms(uint32_t ms)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ms / 1000U);
+    ts.tv_nsec = (long)(ms % 1000U) * 1000000L;
+    nanosleep(&ts, NULL);
+}
+
+static void conc_free_clients(conc_client_t *pClients, int numClients)
+{
+    int i;
+    int j;
+
+    for (i = 0; i < numClients; i++)
+    {
+        for (j = 0; j < pClients[i].numCalls; j++)
+        {
+            test_record_args_free(pClients[i].calls[j].api, pClients[i].calls[j].args);
+        }
+        pClients[i].numCalls = 0;
+    }
+}
+
+/**
+ * @brief Read one call of a client and allocate its arguments
+ *
+ * @return int - 0 on success, -1 on error, nothing is then allocated
+ */
+static int conc_load_call(ut_kvp_instance_t *pInstance, uint32_t client, uint32_t index, conc_call_t *pCall)
+{
+    char key[CONC_KEY_SIZE];
+    char apiName[UT_KVP_MAX_ELEMENT_SIZE];
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    const test_api_desc_t *pDesc;
+    int status;
+
+    snprintf(key, sizeof(key), "concurrency.clients.%u.calls.%u.api", client, index);
+    if (ut_kvp_getStringField(pInstance, key, apiName, sizeof(apiName)) != UT_KVP_STATUS_SUCCESS)
+    {
+        UT_LOG_ERROR("%s is missing", key);
+        return -1;
+    }
+    pCall->api = test_probe_api_find(apiName);
+    pDesc = test_api_desc(pCall->api);
+    if ((pDesc == NULL) || (pDesc->pSkipReason != NULL))
+    {
+        UT_LOG_ERROR("%s: unknown or non replayable API [%s]", key, apiName);
+        return -1;
+    }
+
+    /* Without "arg" the scalar arguments take their first valid value of mta_hal_api_spec.h */
+    snprintf(key, sizeof(key), "concurrency.clients.%u.calls.%u.arg", client, index);
+    if (ut_kvp_getStringField(pInstance, key, value, sizeof(value)) == UT_KVP_STATUS_SUCCESS)
+    {
+        status = test_record_args_alloc(pCall->api, ut_kvp_getUInt32Field(pInstance, key), pCall->args);
+    }
+    else
+    {
+        status = test_api_args_valid(pCall->api, pCall->args);
+    }
+    if (status < 0)
+    {
+        UT_LOG_ERROR("Unable to allocate the arguments of [%s]", apiName);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read the clients of a concurrency profile
+ *
+ * @return int - number of clients loaded, -1 on error
+ */
+static int conc_load_clients(ut_kvp_instance_t *pInstance, conc_client_t *pClients, int maxClients)
+{
+    char key[CONC_KEY_SIZE];
+    uint32_t count;
+    uint32_t numCalls;
+    uint32_t i;
+    uint32_t j;
+
+    count = ut_kvp_getListCount(pInstance, "concurrency.clients");
+    if ((count == 0) || (count > (uint32_t)maxClients))
+    {
+        UT_LOG_ERROR("concurrency.clients has %u entries, expected 1 to %d", count, maxClients);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        memset(&pClients[i], 0, sizeof(conc_client_t));
+
+        snprintf(key, sizeof(key), "concurrency.clients.%u.name", i);
+        if (ut_kvp_getStringField(pInstance, key, pClients[i].name, sizeof(pClients[i].name)) != UT_KVP_STATUS_SUCCESS)
+        {
+            snprintf(pClients[i].name, sizeof(pClients[i].name), "client%u", i);
+        }
+
+        snprintf(key, sizeof(key), "concurrency.clients.%u.dumper", i);
+        pClients[i].dumper = ut_kvp_getBoolField(pInstance, key);
+        snprintf(key, sizeof(key), "concurrency.clients.%u.thinkMs", i);
+        pClients[i].thinkMs = ut_kvp_getUInt32Field(pInstance, key);
+
+        snprintf(key, sizeof(key), "concurrency.clients.%u.calls", i);
+        numCalls = ut_kvp_getListCount(pInstance, key);
+        if ((numCalls == 0) || (numCalls > CONC_MAX_CALLS))
+        {
+            UT_LOG_ERROR("%s has %u entries, expected 1 to %d", key, numCalls, CONC_MAX_CALLS);
+            conc_free_clients(pClients, (int)i);
+            return -1;
+        }
+        for (j = 0; j < numCalls; j++)
+        {
+            if (conc_load_call(pInstance, i, j, &pClients[i].calls[j]) != 0)
+            {
+                conc_free_clients(pClients, (int)i + 1);
+                return -1;
+            }
+            pClients[i].numCalls++;
+        }
+    }
+    return (int)count;
+}
+
+/*
+ * Calls of a client process, from the release of all clients to the end of the phase. The latency of
+ * every call is kept; once the sample buffer is full, reservoir sampling keeps it representative of the
+ * whole run.
+ */
+static void conc_client(const conc_client_t *pClient, conc_shared_t *pShared, int index)
+{
+    conc_result_t *pResult = &pShared->results[index];
+    uint64_t *pSamples;
+    uint64_t startNs;
+    uint64_t callStart;
+    uint64_t elapsed;
+    uint64_t calls = 0;
+    uint32_t numSamples = 0;
+    uint32_t seed = 2463534242U + (uint32_t)index;
+    uint32_t slot;
+    int64_t result;
+    int next = 0;
+
+    pSamples = malloc(sizeof(uint64_t) * CONC_MAX_SAMPLES);
+    pResult->ready = 1;
+
+    while (pShared->go == 0)
+    {
+        conc_sleep_ms(1);
+    }
+
+    startNs = test_bench_now_ns();
+    while ((pSamples != NULL) && (test_bench_now_ns() < pShared->stopNs))
+    {
+        callStart = test_bench_now_ns();
+        result = test_api_call(pClient->calls[next].api, pClient->calls[next].args);
+        elapsed = test_bench_now_ns() - callStart;
+        test_record_args_release(pClient->calls[next].api, pClient->calls[next].args);
+        if ((test_api_desc(pClient->calls[next].api)->returnsStatus == true) && (result != RETURN_OK))
+        {
+            pResult->errors++;
+        }
+
+        if (numSamples < CONC_MAX_SAMPLES)
+        {
+            pSamples[numSamples++] = elapsed;
+        }
+        else
+        {
+            seed ^= seed << 13;     /* xorshift32 */
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            slot = (uint32_t)(seed % (calls + 1));
+            if (slot < CONC_MAX_SAMPLES)
+            {
+                pSamples[slot] = elapsed;
+            }
+        }
+        if (elapsed > pResult->maxNs)
+        {
+            pResult->maxNs = elapsed;
+        }
+        calls++;
+
+        next = (next + 1) % pClient->numCalls;
+        if (pClient->thinkMs > 0)
+        {
+            conc_sleep_ms(pClient->thinkMs);
+        }
+    }
+    pResult->elapsedNs = test_bench_now_ns() - startNs;
+    pResult->calls = calls;
+
+    if (pSamples != NULL)
+    {
+        test_bench_sort(pSamples, numSamples);
+        pResult->p50Ns = test_bench_percentile(pSamples, numSamples, 50.0);
+        pResult->p99Ns = test_bench_percentile(pSamples, numSamples, 99.0);
+        pResult->p999Ns = test_bench_percentile(pSamples, numSamples, 99.9);
+        free(pSamples);
+    }
+    pResult->done = 1;
+}
+
+/**
+ * @brief Entry of a client process, started by the benchmark as "--concurrency-client profile index fd"
+ *
+ * The client loads its calls from the concurrency profile once mta_hal_InitDB() has returned, as index
+ * ranges are read from the HAL, and writes its results into the memory of fd shared with the benchmark.
+ *
+ * @param[in] argc - argument count, after the switch
+ * @param[in] argv - concurrency profile, client index and shared memory descriptor
+ *
+ * @return int - process exit status, 0 once the phase is complete
+ */
+int test_perf_mta_hal_concurrency_client(int argc, char **argv)
+{
+    static conc_client_t clients[CONC_MAX_CLIENTS];
+    ut_kvp_instance_t *pInstance;
+    conc_shared_t *pShared;
+    conc_result_t *pResult;
+    uint64_t startNs;
+    int numClients = -1;
+    int index;
+    int fd;
+
+    if (argc != 3)
+    {
+        UT_LOG_ERROR("%s expects a profile, a client index and a descriptor", CONC_CLIENT_SWITCH);
+        return 1;
+    }
+    index = atoi(argv[1]);
+    fd = atoi(argv[2]);
+    if ((index < 0) || (index >= CONC_MAX_CLIENTS))
+    {
+        UT_LOG_ERROR("Invalid client index [%s]", argv[1]);
+        return 1;
+    }
+    pShared = mmap(NULL, sizeof(conc_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (pShared == MAP_FAILED)
+    {
+        UT_LOG_ERROR("Unable to map the memory shared with the benchmark");
+        return 1;
+    }
+    pResult = &pShared->results[index];
+
+    startNs = test_bench_now_ns();
+    pResult->initRet = mta_hal_InitDB();
+    pResult->initNs = test_bench_now_ns() - startNs;
+
+    pInstance = ut_kvp_createInstance();
+    if (pInstance != NULL)
+    {
+        if (ut_kvp_open(pInstance, argv[0]) == UT_KVP_STATUS_SUCCESS)
+        {
+            numClients = conc_load_clients(pInstance, clients, CONC_MAX_CLIENTS);
+            ut_kvp_close(pInstance);
+        }
+        ut_kvp_destroyInstance(pInstance);
+    }
+    if (index >= numClients)
+    {
+        /* Not done, the benchmark reports the client as not completed */
+        UT_LOG_ERROR("Unable to load client %d of [%s]", index, argv[0]);
+        pResult->ready = 1;
+        munmap(pShared, sizeof(conc_shared_t));
+        return 1;
+    }
+
+    conc_client(&clients[index], pShared, index);
+    conc_free_clients(clients, numClients);
+    munmap(pShared, sizeof(conc_shared_t));
+    return 0;
+}
+
+/**
+ * @brief Run one phase with the selected clients, each in its own process
+ *
+ * Every client is the test binary executed again, so that it loads and initialises libhal_mta itself
+ * rather than inheriting the state of the benchmark.
+ *
+ * @return int - 0 on success, -1 if a client could not be started, did not complete or hung
+ */
+static int conc_run_phase(const conc_client_t *pClients, int numClients, conc_phase_t phase, uint32_t seconds, conc_shared_t *pShared, int sharedFd)
+{
+    pid_t pids[CONC_MAX_CLIENTS];
+    char indexText[16];
+    char fdText[16];
+    char *argv[] = { CONC_SELF_EXE, CONC_CLIENT_SWITCH, gConcurrencyProfile, indexText, fdText, NULL };
+    uint64_t deadline;
+    int ready;
+    int running;
+    int result = 0;
+    int i;
+
+    memset(pShared, 0, sizeof(conc_shared_t));
+    snprintf(fdText, sizeof(fdText), "%d", sharedFd);
+    for (i = 0; i < numClients; i++)
+    {
+        pids[i] = 0;
+        if ((phase == CONC_PHASE_QUIET) && (pClients[i].dumper == true))
+        {
+            continue;
+        }
+        snprintf(indexText, sizeof(indexText), "%d", i);
+        fflush(NULL);
+        pids[i] = fork();
+        if (pids[i] == 0)
+        {
+            execv(CONC_SELF_EXE, argv);
+            _exit(127);
+        }
+        if (pids[i] < 0)
+        {
+            UT_LOG_ERROR("Unable to start client [%s]", pClients[i].name);
+            result = -1;
+        }
+    }
+
+    /* Release all clients together once every one of them has initialised the HAL */
+    deadline = test_bench_now_ns() + CONC_READY_TIMEOUT_NS;
+    do
+    {
+        ready = 1;
+        for (i = 0; i < numClients; i++)
+        {
+            if ((pids[i] <= 0) || (pShared->results[i].ready != 0))
+            {
+                continue;
+            }
+            if (waitpid(pids[i], NULL, WNOHANG) != 0)
+            {
+                UT_LOG_ERROR("Client [%s] exited before it was ready", pClients[i].name);
+                pids[i] = 0;
+                result = -1;
+                continue;
+            }
+            ready = 0;
+        }
+        if (ready == 0)
+        {
+            conc_sleep_ms(1);
+        }
+    } while ((ready == 0) && (test_bench_now_ns() < deadline));
+    if (ready == 0)
+    {
+        UT_LOG_ERROR("Not every client returned from mta_hal_InitDB() within %llu s", CONC_READY_TIMEOUT_NS / CONC_NS_PER_SEC);
+        result = -1;
+    }
+    pShared->stopNs = test_bench_now_ns() + ((uint64_t)seconds * CONC_NS_PER_SEC);
+    __sync_synchronize();
+    pShared->go = 1;
+
+    /* A client blocked in the HAL must not block the benchmark, it is killed once the grace period is over */
+    deadline = pShared->stopNs + CONC_GRACE_NS;
+    do
+    {
+        running = 0;
+        for (i = 0; i < numClients; i++)
+        {
+            if (pids[i] <= 0)
+            {
+                continue;
+            }
+            if (waitpid(pids[i], NULL, WNOHANG) == 0)
+            {
+                running++;
+                continue;
+            }
+            if (pShared->results[i].done == 0)
+            {
+                UT_LOG_ERROR("Client [%s] did not complete the %s phase", pClients[i].name, gPhaseNames[phase]);
+                result = -1;
+            }
+            pids[i] = 0;
+        }
+        if (running > 0)
+        {
+            conc_sleep_ms(10);
+        }
+    } while ((running > 0) && (test_bench_now_ns() < deadline));
+
+    for (i = 0; i < numClients; i++)
+    {
+        if (pids[i] <= 0)
+        {
+            continue;
+        }
+        kill(pids[i], SIGKILL);
+        waitpid(pids[i], NULL, 0);
+        UT_LOG_ERROR("Client [%s] hung, still running %llu s after the end of the %s phase, killed", pClients[i].name,
+                     CONC_GRACE_NS / CONC_NS_PER_SEC, gPhaseNames[phase]);
+        result = -1;
+    }
+    return result;
+}
+
+static void conc_report_phase(const conc_client_t *pClients, int numClients, conc_phase_t phase, const conc_shared_t *pShared)
+{
+    const conc_result_t *pResult;
+    int i;
+
+    UT_LOG_INFO("Phase: %s", gPhaseNames[phase]);
+    UT_LOG_INFO("%-16s %8s %10s %8s %10s %10s %10s %10s %10s", "client", "init ms", "calls/s", "errors",
+                "p50 us", "p99 us", "p99.9 us", "max us", "role");
+    for (i = 0; i < numClients; i++)
+    {
+        if ((phase == CONC_PHASE_QUIET) && (pClients[i].dumper == true))
+        {
+            continue;
+        }
+        pResult = &pShared->results[i];
+        UT_LOG_INFO("%-16s %8.3f %10.1f %8llu %10.1f %10.1f %10.1f %10.1f %10s",
+                    pClients[i].name,
+                    (double)pResult->initNs / CONC_NS_PER_MS,
+                    (pResult->elapsedNs > 0) ? ((double)pResult->calls * CONC_NS_PER_SEC / (double)pResult->elapsedNs) : 0.0,
+                    (unsigned long long)pResult->errors,
+                    (double)pResult->p50Ns / CONC_NS_PER_US,
+                    (double)pResult->p99Ns / CONC_NS_PER_US,
+                    (double)pResult->p999Ns / CONC_NS_PER_US,
+                    (double)pResult->maxNs / CONC_NS_PER_US,
+                    (pClients[i].dumper == true) ? "dumper" : "");
+    }
+}
+
+/**
+* @brief Run several processes against the HAL at once and report throughput and tail latency per process
+*
+* Each client of the concurrency profile runs in its own process, a new instance of the test binary which
+* loads libhal_mta itself: it calls mta_hal_InitDB(), waits until
+* every other client has done the same, then cycles through its calls for "durationSeconds". The
+* benchmark runs a quiet phase without the dumper clients followed by a contended phase with all of
+* them, and reports for every non dumper client how its throughput and p99 latency changed once the
+* dumpers joined. When "maxP99Ratio" is set the contended p99 of every non dumper client must stay
+* within that multiple of its quiet p99.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 002 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.concurrencyProfile" names a valid concurrency profile @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Load the concurrency profile | concurrency.clients | At least one valid client | Should Pass |
+* | 02 | Run the non dumper clients in parallel processes | durationSeconds | Every client initialises and completes within CONC_GRACE_NS of the end | Should Pass |
+* | 03 | Run all clients in parallel processes | durationSeconds | Every client initialises and completes within CONC_GRACE_NS of the end | Should Pass |
+* | 04 | Compare the p99 latency of the non dumper clients between the phases, if maxP99Ratio is set | maxP99Ratio | Ratio within the limit | Should Pass |
+*/
+void test_perf_mta_hal_concurrency_MultiProcess(void)
+{
+    static conc_client_t clients[CONC_MAX_CLIENTS];
+    static conc_result_t quiet[CONC_MAX_CLIENTS];
+    ut_kvp_instance_t *pInstance = NULL;
+    conc_shared_t *pShared;
+    char sharedPath[] = CONC_SHARED_TEMPLATE;
+    int sharedFd;
+    char ratioText[UT_KVP_MAX_ELEMENT_SIZE];
+    int numClients;
+    int numDumpers = 0;
+    int i;
+    uint32_t seconds;
+    double maxP99Ratio = 0.0;
+    double ratio;
+    double quietRate;
+    double contendedRate;
+    const conc_result_t *pContended;
+
+    gTestID = 2;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT_PTR_NOT_NULL_FATAL(pInstance);
+    if (ut_kvp_open(pInstance, gConcurrencyProfile) != UT_KVP_STATUS_SUCCESS)
+    {
+        UT_LOG_ERROR("Unable to open concurrency profile [%s]", gConcurrencyProfile);
+        ut_kvp_destroyInstance(pInstance);
+        UT_FAIL("Concurrency profile could not be opened");
+        return;
+    }
+
+    numClients = conc_load_clients(pInstance, clients, CONC_MAX_CLIENTS);
+    seconds = ut_kvp_getUInt32Field(pInstance, "concurrency.durationSeconds");
+    if (ut_kvp_getStringField(pInstance, "concurrency.maxP99Ratio", ratioText, sizeof(ratioText)) == UT_KVP_STATUS_SUCCESS)
+    {
+        maxP99Ratio = atof(ratioText);
+    }
+    ut_kvp_close(pInstance);
+    ut_kvp_destroyInstance(pInstance);
+
+    if (numClients <= 0)
+    {
+        UT_FAIL("Concurrency profile has no valid clients");
+        return;
+    }
+    if (seconds == 0)
+    {
+        seconds = 10;
+    }
+    for (i = 0; i < numClients; i++)
+    {
+        if (clients[i].dumper == true)
+        {
+            numDumpers++;
+        }
+    }
+
+    /* The clients are new programs, the shared memory is a descriptor they inherit across exec */
+    pShared = MAP_FAILED;
+    sharedFd = mkstemp(sharedPath);
+    if (sharedFd >= 0)
+    {
+        unlink(sharedPath);
+        if (ftruncate(sharedFd, sizeof(conc_shared_t)) == 0)
+        {
+            pShared = mmap(NULL, sizeof(conc_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED, sharedFd, 0);
+        }
+    }
+    if (pShared == MAP_FAILED)
+    {
+        if (sharedFd >= 0)
+        {
+            close(sharedFd);
+        }
+        conc_free_clients(clients, numClients);
+        UT_FAIL("Unable to map memory shared with the clients");
+        return;
+    }
+
+    UT_LOG_DEBUG("Running %d clients (%d dumpers) for %u s per phase", numClients, numDumpers, seconds);
+
+    if ((numDumpers > 0) && (numDumpers < numClients))
+    {
+        UT_ASSERT_EQUAL(conc_run_phase(clients, numClients, CONC_PHASE_QUIET, seconds, pShared, sharedFd), 0);
+        conc_report_phase(clients, numClients, CONC_PHASE_QUIET, pShared);
+        memcpy(quiet, pShared->results, sizeof(quiet));
+    }
+
+    UT_ASSERT_EQUAL(conc_run_phase(clients, numClients, CONC_PHASE_CONTENDED, seconds, pShared, sharedFd), 0);
+    conc_report_phase(clients, numClients, CONC_PHASE_CONTENDED, pShared);
+
+    if ((numDumpers > 0) && (numDumpers < numClients))
+    {
+        UT_LOG_INFO("Starvation by dumpers:");
+        UT_LOG_INFO("%-16s %14s %14s %10s", "client", "calls/s change", "p99 quiet us", "p99 ratio");
+        for (i = 0; i < numClients; i++)
+        {
+            if (clients[i].dumper == true)
+            {
+                continue;
+            }
+            pContended = &pShared->results[i];
+            quietRate = (quiet[i].elapsedNs > 0) ? ((double)quiet[i].calls / (double)quiet[i].elapsedNs) : 0.0;
+            contendedRate = (pContended->elapsedNs > 0) ? ((double)pContended->calls / (double)pContended->elapsedNs) : 0.0;
+            ratio = (quiet[i].p99Ns > 0) ? ((double)pContended->p99Ns / (double)quiet[i].p99Ns) : 0.0;
+            UT_LOG_INFO("%-16s %13.1f%% %14.1f %10.2f", clients[i].name,
+                        (quietRate > 0.0) ? ((contendedRate - quietRate) * 100.0 / quietRate) : 0.0,
+                        (double)quiet[i].p99Ns / CONC_NS_PER_US, ratio);
+            if (maxP99Ratio > 0.0)
+            {
+                UT_LOG_DEBUG("Checking p99 ratio of [%s] against %.2f", clients[i].name, maxP99Ratio);
+                UT_ASSERT_TRUE(ratio <= maxP99Ratio);
+            }
+        }
+    }
+
+    munmap(pShared, sizeof(conc_shared_t));
+    close(sharedFd);
+    conc_free_clients(clients, numClients);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the cross-process concurrent access benchmark
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_concurrency_register(void)
+{
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.concurrencyProfile", gConcurrencyProfile) != UT_KVP_STATUS_SUCCESS) ||
+        (gConcurrencyProfile[0] == '\0'))
+    {
+        UT_LOG_DEBUG("mta.perf.concurrencyProfile not set, concurrency benchmark not registered");
+        return 0;
+    }
+
+    /* Every client process initialises the HAL itself */
+    pSuite = test_runner_add_suite("[PERF mta_hal concurrency]", NULL, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_concurrency_MultiProcess", test_perf_mta_hal_concurrency_MultiProcess);
+    return 0;
+}
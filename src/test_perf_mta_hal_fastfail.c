@@ -0,0 +1,312 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_fastfail.c
+* @page mta_hal_perf_fastfail Fast Fail of NULL Arguments
+*
+* ## Module's Role
+* The negative L1 tests check that a NULL output pointer returns RETURN_ERR; this module checks how long
+* the rejection takes. The agent passes unset pointers on its error paths, and a HAL checking its
+* arguments after a request to the MTA daemon or under its lock makes those paths as slow as a real
+* fetch, and as exposed to a stuck daemon.
+*
+* Every API of mta_hal_api_spec.h taking an output pointer is timed with the timing core of test_bench.h,
+* once with valid arguments and once with each output NULL in turn. A NULL rejection must be faster than
+* "maxRejectRatio" times the valid call, on the 95% intervals of the medians, unless it is under
+* "floorUs": a HAL answering from memory rejects about as fast as it answers. The NULL calls are then
+* repeated "rounds" times between two reads of the voluntary context switches of the thread: a rejection
+* that waits on a lock or on a reply gives up the CPU, a comparison does not.
+*
+* The suite is registered when "mta.perf.fastFail.rounds" of the module profile is set.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#define _GNU_SOURCE
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include "test_api.h"
+#include "test_bench.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+#define FASTFAIL_DEFAULT_RATIO          (0.5)
+#define FASTFAIL_DEFAULT_FLOOR_US       (1.0)
+#define FASTFAIL_DEFAULT_BLOCKING       (1.0)
+#define FASTFAIL_NAME_SIZE              (64)
+
+#ifdef RUSAGE_THREAD
+#define FASTFAIL_RUSAGE                 RUSAGE_THREAD
+#else
+#define FASTFAIL_RUSAGE                 RUSAGE_SELF
+#endif
+
+static int gTestGroup = 4;
+static int gTestID = 8;
+
+static uint32_t gRounds = 0;
+static double gMaxRejectRatio = FASTFAIL_DEFAULT_RATIO;
+static double gFloorNs = FASTFAIL_DEFAULT_FLOOR_US * 1000.0;
+static double gMaxBlockingPercent = FASTFAIL_DEFAULT_BLOCKING;
+
+extern int init_mta_hal_init(void);
+
+/* Context of a timed call */
+typedef struct
+{
+    int api;
+    uintptr_t *pArgs;
+    int64_t expected;
+} fastfail_call_t;
+
+static int fastfail_invoke(void *pContext)
+{
+    fastfail_call_t *pCall = (fastfail_call_t *)pContext;
+    int64_t result;
+
+    result = test_api_call(pCall->api, pCall->pArgs);
+    test_record_args_release(pCall->api, pCall->pArgs);
+    return (result == pCall->expected) ? 0 : -1;
+}
+
+static long fastfail_voluntary_switches(void)
+{
+    struct rusage usage;
+
+    if (getrusage(FASTFAIL_RUSAGE, &usage) != 0)
+    {
+        return 0;
+    }
+    return usage.ru_nvcsw;
+}
+
+/* Time the valid call, then each output NULL in turn; the number of slow or blocking rejections, and in
+ * pWrong that of the NULL arguments not rejected */
+static int fastfail_check_api(const test_bench_config_t *pConfig, int api, uintptr_t *pArgs, int *pWrong,
+                              bool *pAllocated)
+{
+    const test_api_desc_t *pDesc = test_api_desc(api);
+    fastfail_call_t call = { api, pArgs, RETURN_OK };
+    test_bench_result_t valid;
+    test_bench_result_t rejected;
+    char name[FASTFAIL_NAME_SIZE];
+    uintptr_t saved;
+    uint32_t round;
+    long switches;
+    int failures = 0;
+    int arg;
+
+    *pAllocated = true;
+    if (test_bench_run(pConfig, fastfail_invoke, &call, &valid) != 0)
+    {
+        *pAllocated = false;
+        return 0;
+    }
+    test_bench_log(pDesc->pName, &valid);
+    if (valid.errors > 0)
+    {
+        UT_LOG_WARNING("%s: %llu valid calls did not return RETURN_OK, the reference is not a fetch", pDesc->pName,
+                       (unsigned long long)valid.errors);
+    }
+
+    for (arg = 0; arg < pDesc->argCount; arg++)
+    {
+        if (test_record_arg_is_output(api, arg) == false)
+        {
+            continue;
+        }
+        saved = pArgs[arg];
+        pArgs[arg] = 0;
+        call.expected = RETURN_ERR;
+        if (test_bench_run(pConfig, fastfail_invoke, &call, &rejected) != 0)
+        {
+            pArgs[arg] = saved;
+            *pAllocated = false;
+            return failures;
+        }
+        snprintf(name, sizeof(name), "%s(arg %d NULL)", pDesc->pName, arg);
+        test_bench_log(name, &rejected);
+        if (rejected.errors > 0)
+        {
+            (*pWrong)++;
+            UT_LOG_ERROR("%s: %llu calls with argument %d NULL did not return RETURN_ERR", pDesc->pName,
+                         (unsigned long long)rejected.errors, arg);
+        }
+        if ((gMaxRejectRatio > 0.0) && (rejected.ciLowNs > gFloorNs) && (rejected.ciLowNs > (valid.ciHighNs * gMaxRejectRatio)))
+        {
+            UT_LOG_ERROR("%s rejects argument %d NULL in %.3f us, over %.2f times the %.3f us of a valid call: the arguments are checked late",
+                         pDesc->pName, arg, rejected.medianNs / 1000.0, gMaxRejectRatio, valid.medianNs / 1000.0);
+            failures++;
+        }
+
+        switches = fastfail_voluntary_switches();
+        for (round = 0; round < gRounds; round++)
+        {
+            fastfail_invoke(&call);
+        }
+        switches = fastfail_voluntary_switches() - switches;
+        UT_LOG_DEBUG("%s argument %d NULL: %ld voluntary context switches over %u calls", pDesc->pName, arg, switches, gRounds);
+        if ((gMaxBlockingPercent > 0.0) && (((double)switches * 100.0) > ((double)gRounds * gMaxBlockingPercent)))
+        {
+            UT_LOG_ERROR("%s gives up the CPU %ld times over %u calls with argument %d NULL: the rejection waits on a lock or a reply",
+                         pDesc->pName, switches, gRounds, arg);
+            failures++;
+        }
+        pArgs[arg] = saved;
+        call.expected = RETURN_OK;
+    }
+    return failures;
+}
+
+/**
+* @brief Time the rejection of NULL output pointers against valid calls
+*
+* Each API of mta_hal_api_spec.h taking an output pointer is timed with valid arguments, then with each
+* output NULL in turn. A NULL rejection may not be slower than "maxRejectRatio" times the valid call on
+* the 95% intervals of the medians, unless under "floorUs", and may not give up the CPU in more than
+* "maxBlockingPercent" of "rounds" further calls. A ratio or percentage of 0 only reports.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 008 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.fastFail.rounds" is set @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Time each API with valid arguments | mta.perf.bench | Median logged | Should Pass |
+* | 02 | Time each API with each output NULL | output = NULL | RETURN_ERR, within maxRejectRatio of the valid call | Should Pass |
+* | 03 | Count the voluntary context switches of "rounds" NULL calls | output = NULL | Within maxBlockingPercent | Should Pass |
+*/
+void test_perf_mta_hal_fastfail_NullOutputs(void)
+{
+    const test_api_desc_t *pDesc;
+    test_bench_config_t config;
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+    bool allocated;
+    bool hasOutput;
+    int wrong = 0;
+    int checked = 0;
+    int failures = 0;
+    int status;
+    int api;
+    int arg;
+
+    gTestID = 8;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_bench_config_load(&config);
+    test_bench_log_header();
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        pDesc = test_api_desc(api);
+        hasOutput = false;
+        for (arg = 0; arg < pDesc->argCount; arg++)
+        {
+            hasOutput |= test_record_arg_is_output(api, arg);
+        }
+        if ((hasOutput == false) || (pDesc->destructive == true) || (pDesc->pSkipReason != NULL) ||
+            ((pDesc->pOptionalKey != NULL) && (UT_KVP_PROFILE_GET_BOOL(pDesc->pOptionalKey) == false)))
+        {
+            continue;
+        }
+        status = test_api_args_valid(api, args);
+        if (status != 0)
+        {
+            UT_LOG_DEBUG("%s has no valid call, not timed", pDesc->pName);
+            if (status > 0)
+            {
+                test_record_args_free(api, args);
+            }
+            continue;
+        }
+        failures += fastfail_check_api(&config, api, args, &wrong, &allocated);
+        test_record_args_free(api, args);
+        if (allocated == false)
+        {
+            UT_FAIL("Unable to allocate the benchmark samples");
+            return;
+        }
+        checked++;
+    }
+
+    UT_LOG_INFO("%d APIs timed, %d NULL arguments not rejected, %d slow or blocking rejections", checked, wrong, failures);
+    UT_ASSERT_TRUE(checked > 0);
+    UT_ASSERT_EQUAL(wrong, 0);
+    UT_ASSERT_EQUAL(failures, 0);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the fast fail timing of NULL arguments
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_fastfail_register(void)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    gRounds = UT_KVP_PROFILE_GET_UINT32("mta.perf.fastFail.rounds");
+    if (gRounds == 0)
+    {
+        UT_LOG_DEBUG("mta.perf.fastFail.rounds not set, fast fail timing not registered");
+        return 0;
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.fastFail.maxRejectRatio", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gMaxRejectRatio = atof(value);
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.fastFail.floorUs", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gFloorNs = atof(value) * 1000.0;
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.fastFail.maxBlockingPercent", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gMaxBlockingPercent = atof(value);
+    }
+
+    pSuite = test_runner_add_suite("[PERF mta_hal fast fail]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_fastfail_NullOutputs", test_perf_mta_hal_fastfail_NullOutputs);
+    return 0;
+}
@@ -0,0 +1,336 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_heapsoak.c
+* @page mta_hal_perf_heapsoak Log Fetch Heap Fragmentation Soak
+*
+* ## Module's Role
+* This module repeats, for a large number of cycles, what the MTA agent does on every log poll: fetch the
+* DSX and MTA logs with mta_hal_GetDSXLogs() and mta_hal_GetMtaLog() and free them. The DSX log is cleared
+* periodically so that the arrays vary in size from cycle to cycle.
+*
+* Every "sampleEvery" cycles the state of the heap is recorded: the arena obtained from the system, the
+* bytes in use and free inside it, the mmapped blocks and the resident set size of the process. A heap
+* whose free bytes keep growing while the bytes in use stay flat is fragmenting; an RSS that does not
+* come back after malloc_trim() is held by blocks still in use.
+*
+* The suite is registered when "mta.perf.heapSoak.cycles" of the module profile is set.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "test_api.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+/* mallinfo2() appeared in glibc 2.33, older versions only have the int based mallinfo() */
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+#define HEAPSOAK_MALLINFO2
+#endif
+
+#define HEAPSOAK_MAX_SAMPLES        (256)
+#define HEAPSOAK_DEFAULT_SAMPLES    (20)
+
+typedef struct
+{
+    uint32_t cycle;
+    uint64_t arenaBytes;            /*!< Heap obtained from the system with brk() */
+    uint64_t mmapBytes;             /*!< Blocks allocated with mmap() */
+    uint64_t inUseBytes;            /*!< Bytes allocated inside the arena */
+    uint64_t freeBytes;             /*!< Bytes free inside the arena */
+    uint64_t rssKb;                 /*!< Resident set size of the process */
+} heapsoak_sample_t;
+
+static int gTestGroup = 4;
+static int gTestID = 5;
+
+static uint32_t gCycles;
+static uint32_t gSampleEvery;
+static uint32_t gClearEvery;
+static uint32_t gMaxArenaGrowthKb;
+static uint32_t gMaxRssGrowthKb;
+
+extern int init_mta_hal_init(void);
+
+static uint64_t heapsoak_rss_kb(void)
+{
+    unsigned long long sizePages = 0;
+    unsigned long long residentPages = 0;
+    FILE *pFile;
+
+    pFile = fopen("/proc/self/statm", "r");
+    if (pFile == NULL)
+    {
+        return 0;
+    }
+    if (fscanf(pFile, "%llu %llu", &sizePages, &residentPages) != 2)
+    {
+        residentPages = 0;
+    }
+    fclose(pFile);
+    return (uint64_t)residentPages * (uint64_t)sysconf(_SC_PAGESIZE) / 1024U;
+}
+
+static void heapsoak_sample(heapsoak_sample_t *pSample, uint32_t cycle)
+{
+    memset(pSample, 0, sizeof(*pSample));
+    pSample->cycle = cycle;
+#if defined(HEAPSOAK_MALLINFO2)
+    {
+        struct mallinfo2 info = mallinfo2();
+
+        pSample->arenaBytes = info.arena;
+        pSample->mmapBytes = info.hblkhd;
+        pSample->inUseBytes = info.uordblks;
+        pSample->freeBytes = info.fordblks;
+    }
+#elif defined(__GLIBC__)
+    {
+        struct mallinfo info = mallinfo();
+
+        pSample->arenaBytes = (uint32_t)info.arena;
+        pSample->mmapBytes = (uint32_t)info.hblkhd;
+        pSample->inUseBytes = (uint32_t)info.uordblks;
+        pSample->freeBytes = (uint32_t)info.fordblks;
+    }
+#endif
+    pSample->rssKb = heapsoak_rss_kb();
+}
+
+/* Free bytes held in the arena, as a percentage of the arena */
+static double heapsoak_fragmentation(const heapsoak_sample_t *pSample)
+{
+    if (pSample->arenaBytes == 0)
+    {
+        return 0.0;
+    }
+    return (100.0 * (double)pSample->freeBytes) / (double)pSample->arenaBytes;
+}
+
+static void heapsoak_log_sample(const heapsoak_sample_t *pSample)
+{
+    UT_LOG_INFO("%8u %10llu %10llu %10llu %10llu %6.1f%% %10llu", pSample->cycle,
+                (unsigned long long)(pSample->arenaBytes / 1024U), (unsigned long long)(pSample->mmapBytes / 1024U),
+                (unsigned long long)(pSample->inUseBytes / 1024U), (unsigned long long)(pSample->freeBytes / 1024U),
+                heapsoak_fragmentation(pSample), (unsigned long long)pSample->rssKb);
+}
+
+static int64_t heapsoak_growth_kb(uint64_t first, uint64_t last)
+{
+    return ((int64_t)last - (int64_t)first) / 1024;
+}
+
+/* Fetch a log and free the list the HAL returned, the storage of the arguments is kept */
+static bool heapsoak_fetch(int api, const uintptr_t *pArgs)
+{
+    int64_t result;
+
+    result = test_api_call(api, pArgs);
+    test_record_args_release(api, pArgs);
+    return (result == RETURN_OK);
+}
+
+/**
+* @brief Soak the heap with log fetch and free cycles
+*
+* Each cycle fetches and frees the DSX log and the MTA log; every "clearEvery" cycles the DSX log is cleared.
+* The first sample is taken after "sampleEvery" cycles, once the heap has settled, and growth is measured
+* from there. When "maxArenaGrowthKb" or "maxRssGrowthKb" are set, growth beyond them fails the test.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 005 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.heapSoak.cycles" is set @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Enable DSX logging | mta_hal_SetDSXLogEnable(TRUE) | RETURN_OK | Should Pass |
+* | 02 | Fetch and free the DSX and MTA logs, clearing the DSX log every clearEvery cycles | cycles | RETURN_OK | Should Pass |
+* | 03 | Sample the heap and RSS every sampleEvery cycles | mallinfo2(), /proc/self/statm | Growth reported | Should Pass |
+* | 04 | Compare arena and RSS growth with the limits, if set | maxArenaGrowthKb, maxRssGrowthKb | Growth within the limits | Should Pass |
+* | 05 | Trim the heap and report the RSS | malloc_trim(0) | RSS reported | Should Pass |
+* | 06 | Restore DSX logging | mta_hal_SetDSXLogEnable(original) | RETURN_OK | Should Pass |
+*/
+void test_perf_mta_hal_heapsoak_LogFetch(void)
+{
+    static heapsoak_sample_t samples[HEAPSOAK_MAX_SAMPLES];
+    uintptr_t dsxArgs[TEST_RECORD_MAX_ARGS + 1];
+    uintptr_t mtaArgs[TEST_RECORD_MAX_ARGS + 1];
+    int dsxLogs;
+    int mtaLog;
+    heapsoak_sample_t trimmed;
+    BOOLEAN enabled = FALSE;
+    uint32_t cycle;
+    uint32_t errors = 0;
+    int numSamples = 0;
+    int i;
+    INT result;
+
+    gTestID = 5;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    dsxLogs = test_probe_api_find("mta_hal_GetDSXLogs");
+    mtaLog = test_probe_api_find("mta_hal_GetMtaLog");
+    if (test_api_args_valid(dsxLogs, dsxArgs) != 0)
+    {
+        UT_FAIL("Unable to allocate the arguments of mta_hal_GetDSXLogs");
+        return;
+    }
+    if (test_api_args_valid(mtaLog, mtaArgs) != 0)
+    {
+        test_record_args_free(dsxLogs, dsxArgs);
+        UT_FAIL("Unable to allocate the arguments of mta_hal_GetMtaLog");
+        return;
+    }
+
+    result = mta_hal_GetDSXLogEnable(&enabled);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    result = mta_hal_SetDSXLogEnable(TRUE);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+
+    UT_LOG_DEBUG("Running %u cycles, sampling every %u, clearing the DSX log every %u", gCycles, gSampleEvery, gClearEvery);
+    for (cycle = 1; cycle <= gCycles; cycle++)
+    {
+        if ((gClearEvery != 0) && ((cycle % gClearEvery) == 0))
+        {
+            if (mta_hal_ClearDSXLog(TRUE) != RETURN_OK)
+            {
+                errors++;
+            }
+        }
+        if (heapsoak_fetch(dsxLogs, dsxArgs) == false)
+        {
+            errors++;
+        }
+        if (heapsoak_fetch(mtaLog, mtaArgs) == false)
+        {
+            errors++;
+        }
+        if (((cycle % gSampleEvery) == 0) && (numSamples < HEAPSOAK_MAX_SAMPLES))
+        {
+            heapsoak_sample(&samples[numSamples++], cycle);
+        }
+    }
+
+    test_record_args_free(dsxLogs, dsxArgs);
+    test_record_args_free(mtaLog, mtaArgs);
+    result = mta_hal_SetDSXLogEnable(enabled);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+
+    UT_LOG_INFO("%u cycles, %u errors", gCycles, errors);
+    UT_ASSERT_EQUAL(errors, 0);
+    if (numSamples == 0)
+    {
+        UT_LOG_INFO("No heap samples, cycles is smaller than sampleEvery");
+        UT_LOG_INFO("Out %s\n", __FUNCTION__);
+        return;
+    }
+
+    UT_LOG_INFO("%8s %10s %10s %10s %10s %7s %10s", "cycle", "arena KB", "mmap KB", "in use KB", "free KB", "frag", "RSS KB");
+    for (i = 0; i < numSamples; i++)
+    {
+        heapsoak_log_sample(&samples[i]);
+    }
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    heapsoak_sample(&trimmed, gCycles);
+    UT_LOG_INFO("After malloc_trim(0):");
+    heapsoak_log_sample(&trimmed);
+
+#ifndef __GLIBC__
+    UT_LOG_INFO("Heap statistics need glibc, only RSS is reported");
+#endif
+    UT_LOG_INFO("Growth from cycle %u: arena %lld KB, in use %lld KB, free %lld KB, RSS %lld KB, RSS after trim %lld KB",
+                samples[0].cycle,
+                (long long)heapsoak_growth_kb(samples[0].arenaBytes, samples[numSamples - 1].arenaBytes),
+                (long long)heapsoak_growth_kb(samples[0].inUseBytes, samples[numSamples - 1].inUseBytes),
+                (long long)heapsoak_growth_kb(samples[0].freeBytes, samples[numSamples - 1].freeBytes),
+                (long long)((int64_t)samples[numSamples - 1].rssKb - (int64_t)samples[0].rssKb),
+                (long long)((int64_t)trimmed.rssKb - (int64_t)samples[0].rssKb));
+
+    if (gMaxArenaGrowthKb != 0)
+    {
+        UT_ASSERT_TRUE(heapsoak_growth_kb(samples[0].arenaBytes, samples[numSamples - 1].arenaBytes) <= (int64_t)gMaxArenaGrowthKb);
+    }
+    if (gMaxRssGrowthKb != 0)
+    {
+        UT_ASSERT_TRUE(((int64_t)samples[numSamples - 1].rssKb - (int64_t)samples[0].rssKb) <= (int64_t)gMaxRssGrowthKb);
+    }
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the heap fragmentation soak
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_heapsoak_register(void)
+{
+    gCycles = UT_KVP_PROFILE_GET_UINT32("mta.perf.heapSoak.cycles");
+    if (gCycles == 0)
+    {
+        UT_LOG_DEBUG("mta.perf.heapSoak.cycles not set, heap soak not registered");
+        return 0;
+    }
+    gSampleEvery = UT_KVP_PROFILE_GET_UINT32("mta.perf.heapSoak.sampleEvery");
+    if (gSampleEvery == 0)
+    {
+        gSampleEvery = (gCycles >= HEAPSOAK_DEFAULT_SAMPLES) ? (gCycles / HEAPSOAK_DEFAULT_SAMPLES) : 1U;
+    }
+    gClearEvery = UT_KVP_PROFILE_GET_UINT32("mta.perf.heapSoak.clearEvery");
+    gMaxArenaGrowthKb = UT_KVP_PROFILE_GET_UINT32("mta.perf.heapSoak.maxArenaGrowthKb");
+    gMaxRssGrowthKb = UT_KVP_PROFILE_GET_UINT32("mta.perf.heapSoak.maxRssGrowthKb");
+
+    pSuite = test_runner_add_suite("[PERF mta_hal heap soak]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_heapsoak_LogFetch", test_perf_mta_hal_heapsoak_LogFetch);
+    return 0;
+}
@@ -0,0 +1,397 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_indexsweep.c
+* @page mta_hal_perf_indexsweep Index Boundary Sweep
+*
+* ## Module's Role
+* This module sweeps the index arguments of the APIs described in mta_hal_api_spec.h across the valid
+* range, its boundaries and far beyond, and checks every return code. Each index rule gives its points:
+* the first, middle and last entries of the table read from the HAL, which must return RETURN_OK, and
+* the entry below the base, the two after the last and the largest 32 bit and ULONG values, which must
+* return RETURN_ERR. An argument accepting any ULONG (the instance of mta_hal_ClearCalls) is swept at
+* 0, 1, the middle and the top of its range, all expected to succeed. Destructive APIs get only the
+* out of range points.
+*
+* The points are called in turn for "rounds" rounds, then the timing core of test_bench.h measures a
+* valid index, the nearest out of range index and the farthest. Argument validation should reject an
+* index with a comparison against the table size: a rejection slower than a valid fetch, or growing with
+* the index, is a lookup walking the table before it fails. Both are checked on the confidence intervals
+* of the medians, so that noise does not fail the test.
+*
+* The suite is registered when "mta.perf.indexSweep.rounds" of the module profile is set.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "test_api.h"
+#include "test_bench.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+#define SWEEP_MAX_POINTS        (12)
+#define SWEEP_DEFAULT_RATIO     (2.0)
+#define SWEEP_NAME_SIZE         (64)
+
+static int gTestGroup = 4;
+static int gTestID = 7;
+
+static uint32_t gRounds = 0;
+static double gMaxRejectRatio = SWEEP_DEFAULT_RATIO;
+static double gMaxFarRatio = SWEEP_DEFAULT_RATIO;
+
+extern int init_mta_hal_init(void);
+
+typedef struct
+{
+    uintptr_t value;
+    bool valid;                     /*!< RETURN_OK expected, RETURN_ERR otherwise */
+    uint64_t wrong;                 /*!< Calls returning the other code */
+} sweep_point_t;
+
+typedef struct
+{
+    int api;
+    int arg;
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+    sweep_point_t points[SWEEP_MAX_POINTS];
+    int numPoints;
+    int valid;                      /*!< Point timed as a valid call, -1 for none */
+    int near;                       /*!< Point just after the table, -1 without out of range points */
+    int far;                        /*!< Largest out of range point */
+} sweep_t;
+
+/* Context of a timed point */
+typedef struct
+{
+    sweep_t *pSweep;
+    const sweep_point_t *pPoint;
+} sweep_timed_t;
+
+/* Position of the point, which is not added twice */
+static int sweep_add(sweep_t *pSweep, uint64_t value, bool valid)
+{
+    uintptr_t argument = (uintptr_t)(ULONG)value;
+    int i;
+
+    /* ULONG is 32 bits on the device, the values beyond collapse onto the same argument */
+    for (i = 0; i < pSweep->numPoints; i++)
+    {
+        if (pSweep->points[i].value == argument)
+        {
+            return i;
+        }
+    }
+    if (pSweep->numPoints >= SWEEP_MAX_POINTS)
+    {
+        return -1;
+    }
+    pSweep->points[pSweep->numPoints].value = argument;
+    pSweep->points[pSweep->numPoints].valid = valid;
+    pSweep->points[pSweep->numPoints].wrong = 0;
+    return pSweep->numPoints++;
+}
+
+/* The points of an argument, false if it is not an index */
+static bool sweep_build(sweep_t *pSweep, const test_api_rule_t *pRule)
+{
+    test_api_bounds_t bounds;
+    bool destructive = test_api_desc(pRule->api)->destructive;
+
+    pSweep->api = pRule->api;
+    pSweep->arg = pRule->arg;
+    pSweep->numPoints = 0;
+    pSweep->valid = -1;
+    pSweep->near = -1;
+    pSweep->far = -1;
+    if (test_api_arg_bounds(pRule->api, pRule->arg, &bounds) == false)
+    {
+        return false;
+    }
+    if (pRule->kind == TEST_API_RULE_VALUES)
+    {
+        /* Only an argument accepting any ULONG is an index without a table */
+        if ((bounds.first != 0) || (bounds.last < UINT32_MAX) || (bounds.invalid != TEST_API_NO_INVALID) || (destructive == true))
+        {
+            return false;
+        }
+        pSweep->valid = sweep_add(pSweep, 0, true);
+        sweep_add(pSweep, 1, true);
+        sweep_add(pSweep, UINT32_MAX / 2, true);
+        sweep_add(pSweep, UINT32_MAX, true);
+        return true;
+    }
+    if (pRule->kind != TEST_API_RULE_INDEX)
+    {
+        return false;
+    }
+    if ((bounds.empty == false) && (destructive == false))
+    {
+        pSweep->valid = sweep_add(pSweep, bounds.first, true);
+        sweep_add(pSweep, bounds.first + ((bounds.last - bounds.first) / 2), true);
+        sweep_add(pSweep, bounds.last, true);
+    }
+    if (bounds.first > 0)
+    {
+        sweep_add(pSweep, bounds.first - 1, false);
+    }
+    pSweep->near = sweep_add(pSweep, bounds.invalid, false);
+    sweep_add(pSweep, bounds.invalid + 1, false);
+    sweep_add(pSweep, UINT32_MAX, false);
+    pSweep->far = sweep_add(pSweep, (uint64_t)(ULONG)-1, false);
+    return true;
+}
+
+static bool sweep_call(sweep_t *pSweep, const sweep_point_t *pPoint)
+{
+    int64_t result;
+
+    pSweep->args[pSweep->arg] = pPoint->value;
+    result = test_api_call(pSweep->api, pSweep->args);
+    test_record_args_release(pSweep->api, pSweep->args);
+    return (result == ((pPoint->valid == true) ? RETURN_OK : RETURN_ERR));
+}
+
+static int sweep_invoke(void *pContext)
+{
+    sweep_timed_t *pTimed = (sweep_timed_t *)pContext;
+
+    return (sweep_call(pTimed->pSweep, pTimed->pPoint) == true) ? 0 : -1;
+}
+
+static int sweep_time(const test_bench_config_t *pConfig, sweep_t *pSweep, const sweep_point_t *pPoint,
+                      test_bench_result_t *pResult)
+{
+    char name[SWEEP_NAME_SIZE];
+    sweep_timed_t timed = { pSweep, pPoint };
+
+    if (test_bench_run(pConfig, sweep_invoke, &timed, pResult) != 0)
+    {
+        return -1;
+    }
+    snprintf(name, sizeof(name), "%s(%llu)", test_api_desc(pSweep->api)->pName, (unsigned long long)pPoint->value);
+    test_bench_log(name, pResult);
+    return 0;
+}
+
+/* Timing of the rejections, false if one is slower than the limits */
+static bool sweep_check_timing(const test_bench_config_t *pConfig, sweep_t *pSweep, bool *pAllocated)
+{
+    const sweep_point_t *pValid = (pSweep->valid >= 0) ? &pSweep->points[pSweep->valid] : NULL;
+    const sweep_point_t *pNear = (pSweep->near >= 0) ? &pSweep->points[pSweep->near] : NULL;
+    const sweep_point_t *pFar = (pSweep->far >= 0) ? &pSweep->points[pSweep->far] : pNear;
+    test_bench_result_t valid;
+    test_bench_result_t near;
+    test_bench_result_t far;
+    const char *pName = test_api_desc(pSweep->api)->pName;
+    bool fast = true;
+
+    *pAllocated = true;
+    if (pNear == NULL)
+    {
+        return true;
+    }
+    if (((pValid != NULL) && (sweep_time(pConfig, pSweep, pValid, &valid) != 0)) ||
+        (sweep_time(pConfig, pSweep, pNear, &near) != 0) || (sweep_time(pConfig, pSweep, pFar, &far) != 0))
+    {
+        *pAllocated = false;
+        return true;
+    }
+    if ((pValid != NULL) && (gMaxRejectRatio > 0.0) && (near.ciLowNs > (valid.ciHighNs * gMaxRejectRatio)))
+    {
+        UT_LOG_ERROR("%s rejects index %llu in %.3f us, over %.1f times the %.3f us of a valid index", pName,
+                     (unsigned long long)pNear->value, near.medianNs / 1000.0, gMaxRejectRatio, valid.medianNs / 1000.0);
+        fast = false;
+    }
+    if ((pFar != pNear) && (gMaxFarRatio > 0.0) && (far.ciLowNs > (near.ciHighNs * gMaxFarRatio)))
+    {
+        UT_LOG_ERROR("%s rejects index %llu in %.3f us, over %.1f times the %.3f us of index %llu: the rejection grows with the index",
+                     pName, (unsigned long long)pFar->value, far.medianNs / 1000.0, gMaxFarRatio, near.medianNs / 1000.0,
+                     (unsigned long long)pNear->value);
+        fast = false;
+    }
+    return fast;
+}
+
+/**
+* @brief Sweep the index arguments of mta_hal_api_spec.h and time their rejection
+*
+* Every index argument is called at each of its points for "rounds" rounds, and the return code of each
+* call is checked: RETURN_OK within the table, RETURN_ERR beyond it. A valid index, the nearest and the
+* farthest out of range index are then timed: the nearest rejection may not be slower than
+* "maxRejectRatio" times a valid call, and the farthest not slower than "maxFarRatio" times the nearest,
+* both on the 95% intervals of the medians. A ratio of 0 only reports.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 007 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.indexSweep.rounds" is set @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Read the table sizes and build the points of each index | mta_hal_api_spec.h | Points logged | Should Pass |
+* | 02 | Call every point for the given rounds | valid, boundary and far indices | RETURN_OK within the table, RETURN_ERR beyond | Should Pass |
+* | 03 | Time a valid, the nearest and the farthest out of range index | mta.perf.bench | Rejections within the ratios | Should Pass |
+*/
+void test_perf_mta_hal_indexsweep_Indices(void)
+{
+    const test_api_rule_t *pRule;
+    const test_api_desc_t *pDesc;
+    test_bench_config_t config;
+    sweep_t sweep;
+    uint64_t wrong = 0;
+    uint64_t calls;
+    uint64_t startNs;
+    uint64_t elapsedNs;
+    uint32_t round;
+    bool allocated;
+    int swept = 0;
+    int slow = 0;
+    int rule;
+    int i;
+
+    gTestID = 7;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_bench_config_load(&config);
+    for (rule = 0; rule < test_api_rule_count(); rule++)
+    {
+        pRule = test_api_rule_at(rule);
+        pDesc = test_api_desc(pRule->api);
+        if ((pDesc->pSkipReason != NULL) ||
+            ((pDesc->pOptionalKey != NULL) && (UT_KVP_PROFILE_GET_BOOL(pDesc->pOptionalKey) == false)) ||
+            (sweep_build(&sweep, pRule) == false) || (sweep.numPoints == 0))
+        {
+            continue;
+        }
+        if (test_api_args_valid(sweep.api, sweep.args) < 0)
+        {
+            UT_LOG_DEBUG("%s has no valid call, not swept", pDesc->pName);
+            continue;
+        }
+        for (i = 0; i < sweep.numPoints; i++)
+        {
+            UT_LOG_DEBUG("%s argument %d = %llu, %s expected", pDesc->pName, sweep.arg, (unsigned long long)sweep.points[i].value,
+                         (sweep.points[i].valid == true) ? "RETURN_OK" : "RETURN_ERR");
+        }
+
+        startNs = test_bench_now_ns();
+        for (round = 0; round < gRounds; round++)
+        {
+            for (i = 0; i < sweep.numPoints; i++)
+            {
+                if (sweep_call(&sweep, &sweep.points[i]) == false)
+                {
+                    sweep.points[i].wrong++;
+                }
+            }
+        }
+        elapsedNs = test_bench_now_ns() - startNs;
+        calls = (uint64_t)gRounds * (uint64_t)sweep.numPoints;
+        UT_LOG_INFO("%s: %llu calls over %d points, %.0f calls/s", pDesc->pName, (unsigned long long)calls, sweep.numPoints,
+                    (elapsedNs > 0) ? ((double)calls * 1e9 / (double)elapsedNs) : 0.0);
+        for (i = 0; i < sweep.numPoints; i++)
+        {
+            if (sweep.points[i].wrong > 0)
+            {
+                UT_LOG_ERROR("%s(%llu): %llu of %u calls did not return %s", pDesc->pName, (unsigned long long)sweep.points[i].value,
+                             (unsigned long long)sweep.points[i].wrong, gRounds, (sweep.points[i].valid == true) ? "RETURN_OK" : "RETURN_ERR");
+                wrong += sweep.points[i].wrong;
+            }
+        }
+
+        if (swept == 0)
+        {
+            test_bench_log_header();
+        }
+        if (sweep_check_timing(&config, &sweep, &allocated) == false)
+        {
+            slow++;
+        }
+        test_record_args_free(sweep.api, sweep.args);
+        if (allocated == false)
+        {
+            UT_FAIL("Unable to allocate the benchmark samples");
+            return;
+        }
+        swept++;
+    }
+
+    UT_LOG_INFO("%d index arguments swept, %llu wrong return codes, %d slow rejections", swept, (unsigned long long)wrong, slow);
+    UT_ASSERT_TRUE(swept > 0);
+    UT_ASSERT_EQUAL(wrong, 0);
+    UT_ASSERT_EQUAL(slow, 0);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the index boundary sweep
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_indexsweep_register(void)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    gRounds = UT_KVP_PROFILE_GET_UINT32("mta.perf.indexSweep.rounds");
+    if (gRounds == 0)
+    {
+        UT_LOG_DEBUG("mta.perf.indexSweep.rounds not set, index sweep not registered");
+        return 0;
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.indexSweep.maxRejectRatio", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gMaxRejectRatio = atof(value);
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.indexSweep.maxFarRatio", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gMaxFarRatio = atof(value);
+    }
+
+    pSuite = test_runner_add_suite("[PERF mta_hal index sweep]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_indexsweep_Indices", test_perf_mta_hal_indexsweep_Indices);
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_latency.c
+* @page mta_hal_perf_latency Per API Latency Benchmark
+*
+* ## Module's Role
+* This module measures the latency of every mta_hal API that only reads state with the timing core of
+* test_bench.h: warmup, calibrated samples until the confidence interval of the median is narrow enough,
+* and median, MAD and 95% interval per API. The APIs and their valid arguments come from the table of
+* test_api.h, so that an API described in mta_hal_api_spec.h is timed without code of its own. Two HAL drops can be compared on the medians and their
+* intervals; overlapping intervals mean the difference is within the noise of the device.
+*
+* The suite is registered when "mta.perf.bench.latency" of the module profile is true, the timing settings
+* are the other "mta.perf.bench" keys.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "test_api.h"
+#include "test_bench.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+static int gTestGroup = 4;
+static int gTestID = 6;
+
+extern int init_mta_hal_init(void);
+
+typedef struct
+{
+    int api;
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+} latency_call_t;
+
+static int latency_invoke(void *pContext)
+{
+    latency_call_t *pCall = (latency_call_t *)pContext;
+    int64_t result;
+
+    result = test_api_call(pCall->api, pCall->args);
+    /* Lists returned by the HAL are freed, the storage is reused by the next call */
+    test_record_args_release(pCall->api, pCall->args);
+    return ((test_api_desc(pCall->api)->returnsStatus == false) || (result == RETURN_OK)) ? 0 : -1;
+}
+
+/* APIs that only read state and have a valid call on this device */
+static bool latency_is_measured(int api)
+{
+    const test_api_desc_t *pDesc = test_api_desc(api);
+
+    if ((pDesc->pSkipReason != NULL) || (pDesc->destructive == true) || (test_record_api_is_query(api) == false))
+    {
+        return false;
+    }
+    return (pDesc->pOptionalKey == NULL) || (UT_KVP_PROFILE_GET_BOOL(pDesc->pOptionalKey) == true);
+}
+
+/**
+* @brief Measure the latency of every API only reading state
+*
+* Each API is measured on its own with the settings of "mta.perf.bench", with the first valid arguments of
+* mta_hal_api_spec.h. Optional APIs whose profile key is not set, and indexed APIs with an empty table, are
+* left out. APIs whose interval did not
+* narrow to maxCiPercent within maxSeconds are flagged unstable, and APIs that failed are flagged with
+* errors; neither fails the test, the figures are for comparison between HAL drops.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 006 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.bench.latency" is true @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Load the timing settings | mta.perf.bench | Settings logged | Should Pass |
+* | 02 | Measure each API only reading state | warmup, samples, interval | Median, MAD and interval reported | Should Pass |
+*/
+void test_perf_mta_hal_latency_Queries(void)
+{
+    latency_call_t call;
+    test_bench_config_t config;
+    test_bench_result_t result;
+    int unstable = 0;
+    int measured = 0;
+    int status;
+    int api;
+
+    gTestID = 6;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    test_bench_config_load(&config);
+    UT_LOG_DEBUG("Warmup %u, %u to %u samples of %llu us, interval %.2f%%, %llu s per API, CPU %d, %s",
+                 config.warmupIterations, config.minSamples, config.maxSamples, (unsigned long long)(config.minSampleNs / 1000ULL),
+                 config.maxRelativeCi * 100.0, (unsigned long long)(config.maxDurationNs / 1000000000ULL), config.cpu,
+                 (config.bootstrapResamples > 0) ? "bootstrap interval" : "MAD interval");
+
+    test_bench_log_header();
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        if (latency_is_measured(api) == false)
+        {
+            continue;
+        }
+        call.api = api;
+        status = test_api_args_valid(api, call.args);
+        if (status != 0)
+        {
+            UT_LOG_DEBUG("%s has no valid call, not measured", test_api_desc(api)->pName);
+            if (status > 0)
+            {
+                test_record_args_free(api, call.args);
+            }
+            continue;
+        }
+        status = test_bench_run(&config, latency_invoke, &call, &result);
+        test_record_args_free(api, call.args);
+        if (status != 0)
+        {
+            UT_FAIL("Unable to allocate the benchmark samples");
+            return;
+        }
+        test_bench_log(test_api_desc(api)->pName, &result);
+        measured++;
+        if (result.stable == false)
+        {
+            unstable++;
+        }
+    }
+    UT_LOG_INFO("%d APIs measured, %d unstable", measured, unstable);
+    UT_ASSERT_TRUE(measured > 0);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the per API latency benchmark
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_latency_register(void)
+{
+    if (UT_KVP_PROFILE_GET_BOOL("mta.perf.bench.latency") == false)
+    {
+        UT_LOG_DEBUG("mta.perf.bench.latency not set, latency benchmark not registered");
+        return 0;
+    }
+
+    pSuite = test_runner_add_suite("[PERF mta_hal latency]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_latency_Queries", test_perf_mta_hal_latency_Queries);
+    return 0;
+}
@@ -0,0 +1,408 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_logmem.c
+* @page mta_hal_perf_logmem Log Memory Footprint Benchmark
+*
+* ## Module's Role
+* This module measures the memory used by the log dumps of mta_hal_GetDSXLogs() and mta_hal_GetMtaLog()
+* as the logs grow. The HAL offers no way to add log entries, so the logs are sampled while the device
+* produces them: the DSX log is cleared and enabled first, then both logs are fetched at a fixed interval
+* and every new entry count becomes an observation of bytes allocated per entry, realloc() calls and
+* bytes copied by realloc(), taken from the allocator hooks of test_alloc.h.
+*
+* Once the entry count has grown enough, the growth exponents of the realloc count, of the bytes requested
+* and of the bytes copied are fitted against the entry count. An array grown one entry at a time requests
+* O(n^2) bytes, and copies as much whenever the allocator cannot extend the block in place, so an exponent
+* above "maxGrowthExponent" fails the test. So does a run in which the entry count never spans the range a
+* fit needs, as a check that could not be made: "durationSeconds" must cover enough of the log's growth.
+*
+* The suite is registered when "mta.perf.logMemory.durationSeconds" of the module profile is set.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "test_alloc.h"
+#include "test_probe.h"
+#include "test_runner.h"
+
+#define LOGMEM_MAX_OBSERVATIONS     (256)
+#define LOGMEM_MIN_POINTS           (3)
+#define LOGMEM_MIN_RANGE            (4.0)   /* Largest over smallest entry count needed for a fit */
+#define LOGMEM_DEFAULT_INTERVAL_MS  (1000)
+#define LOGMEM_DEFAULT_EXPONENT     (1.5)
+#define LOGMEM_NS_PER_MS            (1000000ULL)
+
+typedef struct
+{
+    ULONG count;                    /*!< Entries returned */
+    uint64_t allocs;
+    uint64_t reallocs;
+    uint64_t copyBytes;             /*!< Bytes moved by realloc() */
+    uint64_t bytes;                 /*!< Bytes requested, by realloc() too, whether or not the block moved */
+    uint64_t footprintBytes;        /*!< Bytes handed to the caller, outstanding after the call */
+} logmem_observation_t;
+
+typedef INT (*logmem_fetch_fn_t)(logmem_observation_t *pObservation);
+
+static int gTestGroup = 4;
+static int gTestID = 3;
+
+static uint32_t gDurationSeconds;
+static uint32_t gIntervalMs;
+static double gMaxExponent;
+
+extern int init_mta_hal_init(void);
+
+static uint64_t logmem_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void logmem_delta(logmem_observation_t *pObservation, ULONG count, const test_alloc_stats_t *pBefore, const test_alloc_stats_t *pAfter)
+{
+    pObservation->count = count;
+    pObservation->allocs = pAfter->allocs - pBefore->allocs;
+    pObservation->reallocs = pAfter->reallocs - pBefore->reallocs;
+    pObservation->copyBytes = pAfter->reallocCopyBytes - pBefore->reallocCopyBytes;
+    pObservation->bytes = pAfter->bytes - pBefore->bytes;
+    pObservation->footprintBytes = pAfter->outstandingBytes - pBefore->outstandingBytes;
+}
+
+static INT logmem_fetch_DSXLogs(logmem_observation_t *pObservation)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetDSXLogs);
+    test_alloc_stats_t before;
+    test_alloc_stats_t after;
+    ULONG count = 0;
+    PMTAMGMT_MTA_DSXLOG pLog = NULL;
+    INT result;
+
+    test_alloc_get(api, &before);
+    result = mta_hal_GetDSXLogs(&count, &pLog);
+    test_alloc_get(api, &after);
+    logmem_delta(pObservation, count, &before, &after);
+    free(pLog);
+    return result;
+}
+
+static INT logmem_fetch_MtaLog(logmem_observation_t *pObservation)
+{
+    int api = TEST_PROBE_ID(mta_hal_GetMtaLog);
+    test_alloc_stats_t before;
+    test_alloc_stats_t after;
+    ULONG count = 0;
+    ULONG i;
+    PMTAMGMT_MTA_MTALOG_FULL pLog = NULL;
+    INT result;
+
+    test_alloc_get(api, &before);
+    result = mta_hal_GetMtaLog(&count, &pLog);
+    test_alloc_get(api, &after);
+    logmem_delta(pObservation, count, &before, &after);
+    if (pLog != NULL)
+    {
+        for (i = 0; i < count; i++)
+        {
+            free(pLog[i].pDescription);
+        }
+        free(pLog);
+    }
+    return result;
+}
+
+/**
+ * @brief Least squares slope of log(value) against log(count)
+ *
+ * @return bool - false when there are too few non zero points, or too narrow a range of counts, for a fit
+ */
+static bool logmem_growth_exponent(const logmem_observation_t *pObservations, int numObservations, size_t offset, double *pExponent)
+{
+    double sumX = 0.0;
+    double sumY = 0.0;
+    double sumXX = 0.0;
+    double sumXY = 0.0;
+    double x;
+    double y;
+    double minCount = 0.0;
+    double maxCount = 0.0;
+    uint64_t value;
+    int points = 0;
+    int i;
+
+    for (i = 0; i < numObservations; i++)
+    {
+        memcpy(&value, (const uint8_t *)&pObservations[i] + offset, sizeof(value));
+        if ((pObservations[i].count == 0) || (value == 0))
+        {
+            continue;
+        }
+        x = log((double)pObservations[i].count);
+        y = log((double)value);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        if ((points == 0) || ((double)pObservations[i].count < minCount))
+        {
+            minCount = (double)pObservations[i].count;
+        }
+        if ((double)pObservations[i].count > maxCount)
+        {
+            maxCount = (double)pObservations[i].count;
+        }
+        points++;
+    }
+    if ((points < LOGMEM_MIN_POINTS) || (maxCount < (minCount * LOGMEM_MIN_RANGE)))
+    {
+        return false;
+    }
+    *pExponent = ((points * sumXY) - (sumX * sumY)) / ((points * sumXX) - (sumX * sumX));
+    return true;
+}
+
+/* Check the growth of one measure over observations spanning the range of a fit; a measure that is 0 at too
+ * many sizes to be fitted does not grow with the log */
+static void logmem_check_growth(const char *pMeasure, const logmem_observation_t *pObservations, int numObservations, size_t offset)
+{
+    double exponent;
+
+    if (logmem_growth_exponent(pObservations, numObservations, offset, &exponent) == false)
+    {
+        UT_LOG_INFO("%s growth: 0 at most sizes, not fitted", pMeasure);
+        return;
+    }
+    UT_LOG_INFO("%s growth: O(n^%.2f)%s", pMeasure, exponent, (exponent > gMaxExponent) ? " - faster than linear" : "");
+    UT_ASSERT_TRUE(exponent <= gMaxExponent);
+}
+
+/* Sample a log for the configured duration and report how its memory use grows with its size */
+static void logmem_run(const char *pApiName, logmem_fetch_fn_t fetch)
+{
+    static logmem_observation_t observations[LOGMEM_MAX_OBSERVATIONS];
+    logmem_observation_t observation;
+    struct timespec interval;
+    uint64_t deadlineNs;
+    uint32_t fetches = 0;
+    uint32_t errors = 0;
+    unsigned long minCount = 0;
+    unsigned long maxCount = 0;
+    int numObservations = 0;
+    int i;
+    bool seen;
+
+    interval.tv_sec = (time_t)(gIntervalMs / 1000U);
+    interval.tv_nsec = (long)(gIntervalMs % 1000U) * 1000000L;
+    deadlineNs = logmem_now_ns() + ((uint64_t)gDurationSeconds * 1000ULL * LOGMEM_NS_PER_MS);
+
+    UT_LOG_DEBUG("Sampling %s every %u ms for %u s", pApiName, gIntervalMs, gDurationSeconds);
+    do
+    {
+        memset(&observation, 0, sizeof(observation));
+        fetches++;
+        if (fetch(&observation) != RETURN_OK)
+        {
+            errors++;
+        }
+        else if ((observation.count > 0) && (numObservations < LOGMEM_MAX_OBSERVATIONS))
+        {
+            /* One observation per entry count, the first one seen */
+            seen = false;
+            for (i = 0; i < numObservations; i++)
+            {
+                if (observations[i].count == observation.count)
+                {
+                    seen = true;
+                }
+            }
+            if (seen == false)
+            {
+                observations[numObservations++] = observation;
+            }
+        }
+        nanosleep(&interval, NULL);
+    } while (logmem_now_ns() < deadlineNs);
+
+    UT_LOG_INFO("%s: %u fetches, %u errors, %d distinct sizes", pApiName, fetches, errors, numObservations);
+    UT_LOG_INFO("%8s %12s %12s %8s %10s %14s %12s", "entries", "footprint", "bytes/entry", "allocs", "reallocs", "requested", "copied");
+    for (i = 0; i < numObservations; i++)
+    {
+        UT_LOG_INFO("%8lu %12llu %12.1f %8llu %10llu %14llu %12llu", observations[i].count,
+                    (unsigned long long)observations[i].footprintBytes,
+                    (double)observations[i].footprintBytes / (double)observations[i].count,
+                    (unsigned long long)observations[i].allocs, (unsigned long long)observations[i].reallocs,
+                    (unsigned long long)observations[i].bytes, (unsigned long long)observations[i].copyBytes);
+    }
+    UT_ASSERT_EQUAL(errors, 0);
+
+    for (i = 0; i < numObservations; i++)
+    {
+        if ((i == 0) || (observations[i].count < minCount))
+        {
+            minCount = observations[i].count;
+        }
+        if (observations[i].count > maxCount)
+        {
+            maxCount = observations[i].count;
+        }
+    }
+    if ((numObservations < LOGMEM_MIN_POINTS) || ((double)maxCount < ((double)minCount * LOGMEM_MIN_RANGE)))
+    {
+        UT_LOG_ERROR("%s growth not assessed: %d distinct sizes from %lu to %lu entries, a fit needs %d sizes spanning x%.0f",
+                     pApiName, numObservations, minCount, maxCount, LOGMEM_MIN_POINTS, LOGMEM_MIN_RANGE);
+        UT_FAIL("The log did not grow over a wide enough range of sizes, increase durationSeconds");
+        return;
+    }
+    logmem_check_growth("realloc count", observations, numObservations, offsetof(logmem_observation_t, reallocs));
+    logmem_check_growth("bytes requested", observations, numObservations, offsetof(logmem_observation_t, bytes));
+    logmem_check_growth("bytes copied by realloc", observations, numObservations, offsetof(logmem_observation_t, copyBytes));
+}
+
+/**
+* @brief Measure the memory footprint of the DSX log dump as the log grows
+*
+* The DSX log is cleared and logging enabled, then mta_hal_GetDSXLogs() is sampled for "durationSeconds".
+* The original logging state is restored afterwards.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 003 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.logMemory.durationSeconds" is set @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Clear the DSX log and enable DSX logging | mta_hal_ClearDSXLog(TRUE), mta_hal_SetDSXLogEnable(TRUE) | RETURN_OK | Should Pass |
+* | 02 | Sample mta_hal_GetDSXLogs every intervalMs | Count, ppDSXLog | RETURN_OK, footprint per size reported | Should Pass |
+* | 03 | Fit the growth of realloc count, bytes requested and bytes copied against the entry count | maxGrowthExponent | Exponent within the limit | Should Pass |
+* | 04 | Restore DSX logging | mta_hal_SetDSXLogEnable(original) | RETURN_OK | Should Pass |
+*/
+void test_perf_mta_hal_logmem_GetDSXLogs(void)
+{
+    BOOLEAN enabled = FALSE;
+    INT result;
+
+    gTestID = 3;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    result = mta_hal_GetDSXLogEnable(&enabled);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    result = mta_hal_ClearDSXLog(TRUE);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+    result = mta_hal_SetDSXLogEnable(TRUE);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+
+    logmem_run("mta_hal_GetDSXLogs", logmem_fetch_DSXLogs);
+
+    result = mta_hal_SetDSXLogEnable(enabled);
+    UT_ASSERT_EQUAL(result, RETURN_OK);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+* @brief Measure the memory footprint of the MTA log dump as the log grows
+*
+* The footprint includes the pDescription string owned by every entry.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 004 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.logMemory.durationSeconds" is set @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Sample mta_hal_GetMtaLog every intervalMs | Count, ppCfg | RETURN_OK, footprint per size reported | Should Pass |
+* | 02 | Fit the growth of realloc count, bytes requested and bytes copied against the entry count | maxGrowthExponent | Exponent within the limit | Should Pass |
+*/
+void test_perf_mta_hal_logmem_GetMtaLog(void)
+{
+    gTestID = 4;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    logmem_run("mta_hal_GetMtaLog", logmem_fetch_MtaLog);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the log memory footprint benchmark
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_logmem_register(void)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    gDurationSeconds = UT_KVP_PROFILE_GET_UINT32("mta.perf.logMemory.durationSeconds");
+    if ((gDurationSeconds == 0) || (test_alloc_available() == false))
+    {
+        UT_LOG_DEBUG("mta.perf.logMemory.durationSeconds not set or no allocation accounting, log memory benchmark not registered");
+        return 0;
+    }
+    gIntervalMs = UT_KVP_PROFILE_GET_UINT32("mta.perf.logMemory.intervalMs");
+    if (gIntervalMs == 0)
+    {
+        gIntervalMs = LOGMEM_DEFAULT_INTERVAL_MS;
+    }
+    gMaxExponent = LOGMEM_DEFAULT_EXPONENT;
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.logMemory.maxGrowthExponent", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gMaxExponent = atof(value);
+    }
+
+    pSuite = test_runner_add_suite("[PERF mta_hal log memory]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_logmem_GetDSXLogs", test_perf_mta_hal_logmem_GetDSXLogs);
+    test_runner_add_test( pSuite, "perf_mta_hal_logmem_GetMtaLog", test_perf_mta_hal_logmem_GetMtaLog);
+    return 0;
+}
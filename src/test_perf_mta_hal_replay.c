@@ -0,0 +1,415 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_replay.c
+* @page mta_hal_perf_replay Polling Profile Replay Benchmark
+*
+* ## Module's Role
+* This module replays the polling cadence of the MTA agent against the mta_hal and reports the
+* CPU time and wall time the HAL consumes per minute of agent operation (the "HAL CPU budget").
+*
+* The cadence is described in a polling profile, see profiles/perf/mta_agent_polling.yaml. The
+* profile is selected with the key "mta.perf.pollingProfile" of the module profile; the suite is
+* not registered when the key is empty.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "test_api.h"
+#include "test_bench.h"
+#include "test_probe.h"
+#include "test_record.h"
+#include "test_runner.h"
+
+#define REPLAY_MAX_ENTRIES      (64)
+#define REPLAY_KEY_SIZE         (128)
+#define REPLAY_NS_PER_MS        (1000000ULL)
+#define REPLAY_NS_PER_MINUTE    (60ULL * 1000ULL * REPLAY_NS_PER_MS)
+#define REPLAY_DEFAULT_WARMUP   (1)
+
+typedef struct
+{
+    int api;                        /*!< test_probe_api_t */
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+    uint64_t intervalNs;
+    uint64_t nextDueNs;
+    uint32_t calls;
+    uint32_t errors;
+    uint64_t wallNs;
+    uint64_t cpuNs;
+    uint64_t maxWallNs;
+} replay_entry_t;
+
+static int gTestGroup = 4;
+static int gTestID = 1;
+
+static char gPollingProfile[UT_KVP_MAX_ELEMENT_SIZE];
+static uint32_t gWarmupPasses = REPLAY_DEFAULT_WARMUP;
+
+extern int init_mta_hal_init(void);
+
+static uint64_t replay_clock_ns(clockid_t clockId)
+{
+    struct timespec ts;
+
+    clock_gettime(clockId, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void replay_sleep_until_ns(uint64_t deadlineNs)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(deadlineNs / 1000000000ULL);
+    ts.tv_nsec = (long)(deadlineNs % 1000000000ULL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+    {
+        /* Interrupted, sleep again for the remainder */
+    }
+}
+
+/* Call an entry once, with the storage of its arguments kept for the next call */
+static bool replay_call(replay_entry_t *pEntry)
+{
+    int64_t result;
+
+    result = test_api_call(pEntry->api, pEntry->args);
+    test_record_args_release(pEntry->api, pEntry->args);
+    return (test_api_desc(pEntry->api)->returnsStatus == false) || (result == RETURN_OK);
+}
+
+static void replay_free_entries(replay_entry_t *pEntries, int numEntries)
+{
+    int i;
+
+    for (i = 0; i < numEntries; i++)
+    {
+        test_record_args_free(pEntries[i].api, pEntries[i].args);
+    }
+}
+
+/**
+ * @brief Read one call of a polling profile and allocate its arguments
+ *
+ * @return int - 0 on success, -1 on error, nothing is then allocated
+ */
+static int replay_load_entry(ut_kvp_instance_t *pInstance, uint32_t index, replay_entry_t *pEntry)
+{
+    char key[REPLAY_KEY_SIZE];
+    char apiName[UT_KVP_MAX_ELEMENT_SIZE];
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+    const test_api_desc_t *pDesc;
+    uint32_t intervalMs;
+    int status;
+
+    memset(pEntry, 0, sizeof(replay_entry_t));
+
+    snprintf(key, sizeof(key), "polling.calls.%u.api", index);
+    if (ut_kvp_getStringField(pInstance, key, apiName, sizeof(apiName)) != UT_KVP_STATUS_SUCCESS)
+    {
+        UT_LOG_ERROR("%s is missing", key);
+        return -1;
+    }
+    pEntry->api = test_probe_api_find(apiName);
+    pDesc = test_api_desc(pEntry->api);
+    if ((pDesc == NULL) || (pDesc->pSkipReason != NULL))
+    {
+        UT_LOG_ERROR("%s: unknown or non replayable API [%s]", key, apiName);
+        return -1;
+    }
+
+    snprintf(key, sizeof(key), "polling.calls.%u.intervalMs", index);
+    intervalMs = ut_kvp_getUInt32Field(pInstance, key);
+    if (intervalMs == 0)
+    {
+        UT_LOG_ERROR("%s must be greater than zero", key);
+        return -1;
+    }
+    pEntry->intervalNs = (uint64_t)intervalMs * REPLAY_NS_PER_MS;
+
+    /* Without "arg" the scalar arguments take their first valid value of mta_hal_api_spec.h */
+    snprintf(key, sizeof(key), "polling.calls.%u.arg", index);
+    if (ut_kvp_getStringField(pInstance, key, value, sizeof(value)) == UT_KVP_STATUS_SUCCESS)
+    {
+        status = test_record_args_alloc(pEntry->api, ut_kvp_getUInt32Field(pInstance, key), pEntry->args);
+    }
+    else
+    {
+        status = test_api_args_valid(pEntry->api, pEntry->args);
+    }
+    if (status < 0)
+    {
+        UT_LOG_ERROR("Unable to allocate the arguments of [%s]", apiName);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read the call list of a polling profile
+ *
+ * @return int - number of entries loaded, -1 on error
+ */
+static int replay_load_entries(ut_kvp_instance_t *pInstance, replay_entry_t *pEntries, int maxEntries)
+{
+    uint32_t count;
+    uint32_t i;
+
+    count = ut_kvp_getListCount(pInstance, "polling.calls");
+    if ((count == 0) || (count > (uint32_t)maxEntries))
+    {
+        UT_LOG_ERROR("polling.calls has %u entries, expected 1 to %d", count, maxEntries);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (replay_load_entry(pInstance, i, &pEntries[i]) != 0)
+        {
+            replay_free_entries(pEntries, (int)i);
+            return -1;
+        }
+    }
+    return (int)count;
+}
+
+/**
+* @brief Replay the MTA agent polling cadence and report the HAL CPU budget
+*
+* Every call listed in the polling profile is issued at its interval for "durationMinutes" minutes of
+* agent time. In the default compressed mode the calls are issued back to back in schedule order, so
+* the run takes only as long as the HAL itself, after "mta.perf.polling.warmupPasses" passes over the
+* calls; with "realtime: true" the test sleeps until each call
+* is due, which also captures cold cache behaviour. Process CPU time is used so that work done by
+* threads inside the HAL library is included; work done in other processes on behalf of the HAL is not.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 001 @n
+* **Priority:** Medium @n@n
+*
+* **Pre-Conditions:** "mta.perf.pollingProfile" names a valid polling profile @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Load the polling profile | polling.calls | At least one valid entry | Should Pass |
+* | 02 | Replay the schedule for durationMinutes | api, intervalMs, arg | CPU and wall time per minute are reported | Should Pass |
+* | 03 | Compare CPU time per minute with cpuBudgetMsPerMinute, if set | cpuBudgetMsPerMinute | CPU time within budget | Should Pass |
+*/
+void test_perf_mta_hal_replay_PollingProfile(void)
+{
+    static replay_entry_t entries[REPLAY_MAX_ENTRIES];
+    ut_kvp_instance_t *pInstance = NULL;
+    int numEntries;
+    int i;
+    int next;
+    bool realtime;
+    uint32_t minutes;
+    uint32_t budgetMs;
+    uint64_t durationNs;
+    uint64_t startNs;
+    uint64_t wallStart;
+    uint64_t cpuStart;
+    uint64_t elapsed;
+    uint64_t totalWallNs = 0;
+    uint64_t totalCpuNs = 0;
+    uint32_t totalCalls = 0;
+    uint32_t totalErrors = 0;
+    double cpuMsPerMinute;
+    double wallMsPerMinute;
+    test_bench_config_t bench;
+    uint32_t pass;
+    bool ok;
+
+    gTestID = 1;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    pInstance = ut_kvp_createInstance();
+    UT_ASSERT_PTR_NOT_NULL_FATAL(pInstance);
+    if (ut_kvp_open(pInstance, gPollingProfile) != UT_KVP_STATUS_SUCCESS)
+    {
+        UT_LOG_ERROR("Unable to open polling profile [%s]", gPollingProfile);
+        ut_kvp_destroyInstance(pInstance);
+        UT_FAIL("Polling profile could not be opened");
+        return;
+    }
+
+    numEntries = replay_load_entries(pInstance, entries, REPLAY_MAX_ENTRIES);
+    minutes = ut_kvp_getUInt32Field(pInstance, "polling.durationMinutes");
+    realtime = ut_kvp_getBoolField(pInstance, "polling.realtime");
+    budgetMs = ut_kvp_getUInt32Field(pInstance, "polling.cpuBudgetMsPerMinute");
+    ut_kvp_close(pInstance);
+    ut_kvp_destroyInstance(pInstance);
+
+    if (numEntries <= 0)
+    {
+        UT_FAIL("Polling profile has no valid calls");
+        return;
+    }
+    if (minutes == 0)
+    {
+        minutes = 1;
+    }
+    durationNs = (uint64_t)minutes * REPLAY_NS_PER_MINUTE;
+
+    UT_LOG_DEBUG("Replaying %d calls for %u minute(s) in %s mode", numEntries, minutes, realtime ? "realtime" : "compressed");
+
+    /* The CPU pinning is shared with the other benchmarks, see test_bench.h */
+    test_bench_config_load(&bench);
+    if (test_bench_pin(bench.cpu) == true)
+    {
+        UT_LOG_DEBUG("Replaying on CPU %d", bench.cpu);
+    }
+    if (realtime == false)
+    {
+        /* Back to back calls are otherwise dominated by the first, cold, ones; a realtime replay models
+           an agent whose calls are cold anyway. Passes over the whole schedule, not the iterations of the
+           micro-benchmarks: a log dump may take seconds on a device */
+        UT_LOG_DEBUG("Warming up with %u pass(es) over the calls", gWarmupPasses);
+        for (pass = 0; pass < gWarmupPasses; pass++)
+        {
+            for (i = 0; i < numEntries; i++)
+            {
+                (void)replay_call(&entries[i]);
+            }
+        }
+    }
+
+    startNs = replay_clock_ns(CLOCK_MONOTONIC);
+    for (;;)
+    {
+        /* Pick the call that is due first, ties go to the earlier profile entry */
+        next = -1;
+        for (i = 0; i < numEntries; i++)
+        {
+            if ((entries[i].nextDueNs < durationNs) && ((next < 0) || (entries[i].nextDueNs < entries[next].nextDueNs)))
+            {
+                next = i;
+            }
+        }
+        if (next < 0)
+        {
+            break;
+        }
+
+        if (realtime == true)
+        {
+            replay_sleep_until_ns(startNs + entries[next].nextDueNs);
+        }
+
+        wallStart = replay_clock_ns(CLOCK_MONOTONIC);
+        cpuStart = replay_clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+        ok = replay_call(&entries[next]);
+        entries[next].cpuNs += replay_clock_ns(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+        elapsed = replay_clock_ns(CLOCK_MONOTONIC) - wallStart;
+
+        entries[next].wallNs += elapsed;
+        if (elapsed > entries[next].maxWallNs)
+        {
+            entries[next].maxWallNs = elapsed;
+        }
+        entries[next].calls++;
+        if (ok == false)
+        {
+            entries[next].errors++;
+        }
+        entries[next].nextDueNs += entries[next].intervalNs;
+    }
+    test_bench_unpin();
+
+    UT_LOG_INFO("%-40s %8s %6s %14s %14s %12s", "API", "calls/min", "errors", "wall ms/min", "cpu ms/min", "max wall ms");
+    for (i = 0; i < numEntries; i++)
+    {
+        UT_LOG_INFO("%-40s %8.1f %6u %14.3f %14.3f %12.3f",
+                    test_api_desc(entries[i].api)->pName,
+                    (double)entries[i].calls / minutes,
+                    entries[i].errors,
+                    (double)entries[i].wallNs / REPLAY_NS_PER_MS / minutes,
+                    (double)entries[i].cpuNs / REPLAY_NS_PER_MS / minutes,
+                    (double)entries[i].maxWallNs / REPLAY_NS_PER_MS);
+        totalWallNs += entries[i].wallNs;
+        totalCpuNs += entries[i].cpuNs;
+        totalCalls += entries[i].calls;
+        totalErrors += entries[i].errors;
+    }
+    replay_free_entries(entries, numEntries);
+
+    wallMsPerMinute = (double)totalWallNs / REPLAY_NS_PER_MS / minutes;
+    cpuMsPerMinute = (double)totalCpuNs / REPLAY_NS_PER_MS / minutes;
+    UT_LOG_INFO("HAL CPU budget: %.3f ms CPU, %.3f ms wall per minute (%.4f%% of one core, %u calls, %u errors)",
+                cpuMsPerMinute, wallMsPerMinute, cpuMsPerMinute / 600.0, totalCalls, totalErrors);
+
+    if (budgetMs > 0)
+    {
+        UT_LOG_DEBUG("Checking CPU time against budget of %u ms per minute", budgetMs);
+        UT_ASSERT_TRUE(cpuMsPerMinute <= (double)budgetMs);
+    }
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the polling profile replay benchmark
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_replay_register(void)
+{
+    char value[UT_KVP_MAX_ELEMENT_SIZE];
+
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.pollingProfile", gPollingProfile) != UT_KVP_STATUS_SUCCESS) ||
+        (gPollingProfile[0] == '\0'))
+    {
+        UT_LOG_DEBUG("mta.perf.pollingProfile not set, replay benchmark not registered");
+        return 0;
+    }
+    if ((UT_KVP_PROFILE_GET_STRING("mta.perf.polling.warmupPasses", value) == UT_KVP_STATUS_SUCCESS) && (value[0] != '\0'))
+    {
+        gWarmupPasses = UT_KVP_PROFILE_GET_UINT32("mta.perf.polling.warmupPasses");
+    }
+
+    pSuite = test_runner_add_suite("[PERF mta_hal replay]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_replay_PollingProfile", test_perf_mta_hal_replay_PollingProfile);
+    return 0;
+}
@@ -0,0 +1,346 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file test_perf_mta_hal_snapshot.c
+* @page mta_hal_perf_snapshot Status Snapshot Benchmark
+*
+* ## Module's Role
+* This module measures the case for the bulk read of mta_hal_snapshot.h. The status refresh of the MTA
+* agent is made of the individual calls listed there, one round trip to the MTA daemon each on a device;
+* mta_hal_GetSnapshot() returns the same values in one call.
+*
+* The refresh is timed both ways with the timing core of test_bench.h, after checking that the snapshot
+* holds the values of the individual calls. mta_hal_GetSnapshot() is not part of mta_hal.h: it is
+* referenced weakly, and a HAL without it only has the individual calls timed, which is the cost a
+* snapshot would remove. The skeleton emulates a round trip per call with MTA_HAL_SKELETON_ROUND_TRIP_US.
+*
+* The suite is registered when "mta.perf.bench.snapshot" of the module profile is true, the timing
+* settings are the other "mta.perf.bench" keys.
+*
+* **Pre-Conditions:**  None@n
+* **Dependencies:** None@n
+*
+* Ref to API Definition specification documentation : [MTAhalSpec.md](../../../docs/pages/MTAhalSpec.md)
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include "mta_hal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "mta_hal_snapshot.h"
+#include "test_bench.h"
+#include "test_runner.h"
+
+/* Calls of a refresh without and with the battery */
+#define SNAPSHOT_STATUS_CALLS       (8)
+#define SNAPSHOT_BATTERY_CALLS      (11)
+
+#define SNAPSHOT_FIELD(kind, member, battery) \
+    { #member, kind, offsetof(MTAMGMT_MTA_SNAPSHOT, member), sizeof(((MTAMGMT_MTA_SNAPSHOT *)0)->member), battery }
+
+static int gTestGroup = 4;
+static int gTestID = 9;
+
+extern int init_mta_hal_init(void);
+
+/* Only in the HAL libraries implementing the prototype */
+extern INT mta_hal_GetSnapshot(PMTAMGMT_MTA_SNAPSHOT pSnapshot) __attribute__((weak));
+
+typedef enum
+{
+    SNAPSHOT_FIELD_BYTES = 0,
+    SNAPSHOT_FIELD_STRING,
+    SNAPSHOT_FIELD_LINES            /*!< NumberOfLines entries */
+} snapshot_field_kind_t;
+
+typedef struct
+{
+    const char *pName;
+    snapshot_field_kind_t kind;
+    size_t offset;
+    size_t size;
+    bool battery;
+} snapshot_field_t;
+
+static const snapshot_field_t gFields[] =
+{
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, DhcpInfo, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, DhcpV6Info, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, Ipv4Status, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, Ipv6Status, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, OperationalStatus, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, ProvisioningStatus, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, ConfigFileStatus, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, NumberOfLines, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_LINES, LineRegisterStatus, false),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryInstalled, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryTotalCapacity, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryActualCapacity, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryRemainingCharge, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryRemainingTime, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryNumberofCycles, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_STRING, BatteryPowerStatus, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_STRING, BatteryCondition, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_STRING, BatteryStatus, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_STRING, BatteryLife, true),
+    SNAPSHOT_FIELD(SNAPSHOT_FIELD_BYTES, BatteryInfo, true),
+};
+
+#define SNAPSHOT_NUM_FIELDS     (sizeof(gFields) / sizeof(gFields[0]))
+
+/* Context of a timed refresh */
+typedef struct
+{
+    bool battery;
+    MTAMGMT_MTA_SNAPSHOT snapshot;
+} snapshot_refresh_t;
+
+static int snapshot_string(INT (*read)(CHAR *, ULONG *), CHAR *pValue, size_t size)
+{
+    ULONG len = (ULONG)size;
+
+    return (read(pValue, &len) == RETURN_OK) ? 0 : -1;
+}
+
+/* The refresh of the agent, one call per value */
+static int snapshot_individual(void *pContext)
+{
+    snapshot_refresh_t *pRefresh = (snapshot_refresh_t *)pContext;
+    PMTAMGMT_MTA_SNAPSHOT pSnapshot = &pRefresh->snapshot;
+    int failed = 0;
+
+    memset(pSnapshot, 0, sizeof(*pSnapshot));
+    failed |= (mta_hal_GetDHCPInfo(&pSnapshot->DhcpInfo) != RETURN_OK);
+    failed |= (mta_hal_GetDHCPV6Info(&pSnapshot->DhcpV6Info) != RETURN_OK);
+    failed |= (mta_hal_getDhcpStatus(&pSnapshot->Ipv4Status, &pSnapshot->Ipv6Status) != RETURN_OK);
+    failed |= (mta_hal_getMtaOperationalStatus(&pSnapshot->OperationalStatus) != RETURN_OK);
+    failed |= (mta_hal_getMtaProvisioningStatus(&pSnapshot->ProvisioningStatus) != RETURN_OK);
+    failed |= (mta_hal_getConfigFileStatus(&pSnapshot->ConfigFileStatus) != RETURN_OK);
+    pSnapshot->NumberOfLines = mta_hal_LineTableGetNumberOfEntries();
+    if (pSnapshot->NumberOfLines > MTA_HAL_SNAPSHOT_MAX_LINES)
+    {
+        pSnapshot->NumberOfLines = MTA_HAL_SNAPSHOT_MAX_LINES;
+    }
+    failed |= (mta_hal_getLineRegisterStatus(pSnapshot->LineRegisterStatus, (int)pSnapshot->NumberOfLines) != RETURN_OK);
+    if (pRefresh->battery == true)
+    {
+        failed |= (mta_hal_BatteryGetInstalled(&pSnapshot->BatteryInstalled) != RETURN_OK);
+        failed |= (mta_hal_BatteryGetTotalCapacity(&pSnapshot->BatteryTotalCapacity) != RETURN_OK);
+        failed |= (mta_hal_BatteryGetActualCapacity(&pSnapshot->BatteryActualCapacity) != RETURN_OK);
+        failed |= (mta_hal_BatteryGetRemainingCharge(&pSnapshot->BatteryRemainingCharge) != RETURN_OK);
+        failed |= (mta_hal_BatteryGetRemainingTime(&pSnapshot->BatteryRemainingTime) != RETURN_OK);
+        failed |= (mta_hal_BatteryGetNumberofCycles(&pSnapshot->BatteryNumberofCycles) != RETURN_OK);
+        failed |= snapshot_string(mta_hal_BatteryGetPowerStatus, pSnapshot->BatteryPowerStatus, sizeof(pSnapshot->BatteryPowerStatus));
+        failed |= snapshot_string(mta_hal_BatteryGetCondition, pSnapshot->BatteryCondition, sizeof(pSnapshot->BatteryCondition));
+        failed |= snapshot_string(mta_hal_BatteryGetStatus, pSnapshot->BatteryStatus, sizeof(pSnapshot->BatteryStatus));
+        failed |= snapshot_string(mta_hal_BatteryGetLife, pSnapshot->BatteryLife, sizeof(pSnapshot->BatteryLife));
+        failed |= (mta_hal_BatteryGetInfo(&pSnapshot->BatteryInfo) != RETURN_OK);
+    }
+    return (failed != 0) ? -1 : 0;
+}
+
+static int snapshot_bulk(void *pContext)
+{
+    snapshot_refresh_t *pRefresh = (snapshot_refresh_t *)pContext;
+
+    return (mta_hal_GetSnapshot(&pRefresh->snapshot) == RETURN_OK) ? 0 : -1;
+}
+
+/* Members of the snapshot differing from the individual calls, each logged */
+static int snapshot_compare(const MTAMGMT_MTA_SNAPSHOT *pIndividual, const MTAMGMT_MTA_SNAPSHOT *pBulk, bool battery)
+{
+    const snapshot_field_t *pField;
+    const char *pExpected;
+    const char *pActual;
+    size_t size;
+    int differences = 0;
+    size_t i;
+
+    for (i = 0; i < SNAPSHOT_NUM_FIELDS; i++)
+    {
+        pField = &gFields[i];
+        if ((pField->battery == true) && (battery == false))
+        {
+            continue;
+        }
+        pExpected = (const char *)pIndividual + pField->offset;
+        pActual = (const char *)pBulk + pField->offset;
+        switch (pField->kind)
+        {
+            case SNAPSHOT_FIELD_STRING:
+                if (strncmp(pExpected, pActual, pField->size) == 0)
+                {
+                    continue;
+                }
+                UT_LOG_ERROR("%s: \"%.*s\" in the snapshot, \"%.*s\" from the individual call", pField->pName, (int)pField->size,
+                             pActual, (int)pField->size, pExpected);
+                break;
+            case SNAPSHOT_FIELD_LINES:
+                size = pIndividual->NumberOfLines * sizeof(pIndividual->LineRegisterStatus[0]);
+                if ((pIndividual->NumberOfLines != pBulk->NumberOfLines) || (memcmp(pExpected, pActual, size) == 0))
+                {
+                    continue;
+                }
+                UT_LOG_ERROR("%s differs from the individual call", pField->pName);
+                break;
+            default:
+                if (memcmp(pExpected, pActual, pField->size) == 0)
+                {
+                    continue;
+                }
+                UT_LOG_ERROR("%s differs from the individual call", pField->pName);
+                break;
+        }
+        differences++;
+    }
+    return differences;
+}
+
+/**
+* @brief Time a status refresh by individual calls and by mta_hal_GetSnapshot()
+*
+* The refresh of the agent, the calls of mta_hal_snapshot.h in turn (the battery ones when
+* "mta.batterySupported" is true), is timed with the "mta.perf.bench" settings. When the HAL provides
+* mta_hal_GetSnapshot(), its values are checked against the individual calls, a second time before a
+* difference fails so that a status changing in between does not, and it is timed the same way; it may
+* not be slower than the individual calls on the 95% intervals of the medians.
+*
+* **Test Group ID:** Benchmark: 04 @n
+* **Test Case ID:** 009 @n
+* **Priority:** Low @n@n
+*
+* **Pre-Conditions:** "mta.perf.bench.snapshot" is true @n
+* **Dependencies:** None @n
+* **User Interaction:** If user chose to run the test in interactive mode, then the test case has to be selected via console. @n
+*
+* **Test Procedure:** @n
+* | Variation / Step | Description | Test Data | Expected Result | Notes |
+* | :----: | :---------: | :----------: |:--------------: | :-----: |
+* | 01 | Time the refresh by individual calls | mta.perf.bench | Every call returns RETURN_OK, median logged | Should Pass |
+* | 02 | Compare mta_hal_GetSnapshot() with the individual calls | Valid pointer | RETURN_OK, same values | Should Pass, skipped without mta_hal_GetSnapshot() |
+* | 03 | Time mta_hal_GetSnapshot() | mta.perf.bench | Not slower than the individual calls | Should Pass, skipped without mta_hal_GetSnapshot() |
+*/
+void test_perf_mta_hal_snapshot_Refresh(void)
+{
+    static snapshot_refresh_t individual;
+    static snapshot_refresh_t bulk;
+    test_bench_config_t config;
+    test_bench_result_t calls;
+    test_bench_result_t snapshot;
+    uint32_t callsPerRefresh;
+    int differences;
+
+    gTestID = 9;
+    UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+    individual.battery = UT_KVP_PROFILE_GET_BOOL("mta.batterySupported");
+    bulk.battery = individual.battery;
+    callsPerRefresh = SNAPSHOT_STATUS_CALLS + ((individual.battery == true) ? SNAPSHOT_BATTERY_CALLS : 0);
+    test_bench_config_load(&config);
+
+    test_bench_log_header();
+    if (test_bench_run(&config, snapshot_individual, &individual, &calls) != 0)
+    {
+        UT_FAIL("Unable to allocate the benchmark samples");
+        return;
+    }
+    test_bench_log("individual calls", &calls);
+    UT_LOG_INFO("A refresh of %u calls takes %.3f us, %.3f us per call", callsPerRefresh, calls.medianNs / 1000.0,
+                calls.medianNs / 1000.0 / callsPerRefresh);
+    if (calls.errors > 0)
+    {
+        UT_LOG_ERROR("%llu refreshes had a call failing", (unsigned long long)calls.errors);
+    }
+    UT_ASSERT_EQUAL(calls.errors, 0);
+
+    if (mta_hal_GetSnapshot == NULL)
+    {
+        UT_LOG_INFO("mta_hal_GetSnapshot() is not provided by the HAL, only the individual calls are timed");
+        UT_LOG_INFO("Out %s\n", __FUNCTION__);
+        return;
+    }
+
+    UT_LOG_DEBUG("Invoking mta_hal_GetSnapshot() with a valid pointer");
+    differences = 0;
+    if ((snapshot_individual(&individual) == 0) && (snapshot_bulk(&bulk) == 0))
+    {
+        differences = snapshot_compare(&individual.snapshot, &bulk.snapshot, bulk.battery);
+        if ((differences > 0) && (snapshot_individual(&individual) == 0) && (snapshot_bulk(&bulk) == 0))
+        {
+            UT_LOG_DEBUG("The snapshot differs from the individual calls, compared again in case the status changed");
+            differences = snapshot_compare(&individual.snapshot, &bulk.snapshot, bulk.battery);
+        }
+    }
+    else
+    {
+        UT_LOG_ERROR("mta_hal_GetSnapshot() or an individual call failed");
+        differences = -1;
+    }
+    UT_ASSERT_EQUAL(differences, 0);
+    UT_ASSERT_EQUAL(mta_hal_GetSnapshot(NULL), RETURN_ERR);
+
+    if (test_bench_run(&config, snapshot_bulk, &bulk, &snapshot) != 0)
+    {
+        UT_FAIL("Unable to allocate the benchmark samples");
+        return;
+    }
+    test_bench_log("mta_hal_GetSnapshot", &snapshot);
+    UT_LOG_INFO("mta_hal_GetSnapshot() takes %.3f us, %.1f times faster than the %u calls it replaces", snapshot.medianNs / 1000.0,
+                (snapshot.medianNs > 0.0) ? (calls.medianNs / snapshot.medianNs) : 0.0, callsPerRefresh);
+    UT_ASSERT_EQUAL(snapshot.errors, 0);
+    if (snapshot.ciLowNs > calls.ciHighNs)
+    {
+        UT_LOG_ERROR("mta_hal_GetSnapshot() is slower than the individual calls");
+    }
+    UT_ASSERT_TRUE(snapshot.ciLowNs <= calls.ciHighNs);
+
+    UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static test_runner_suite_t * pSuite = NULL;
+
+/**
+ * @brief Register the status snapshot benchmark
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_mta_hal_perf_snapshot_register(void)
+{
+    if (UT_KVP_PROFILE_GET_BOOL("mta.perf.bench.snapshot") == false)
+    {
+        UT_LOG_DEBUG("mta.perf.bench.snapshot not set, snapshot benchmark not registered");
+        return 0;
+    }
+
+    pSuite = test_runner_add_suite("[PERF mta_hal snapshot]", init_mta_hal_init, NULL);
+    if (pSuite == NULL)
+    {
+        return -1;
+    }
+    test_runner_suite_exclusive(pSuite);
+
+    test_runner_add_test( pSuite, "perf_mta_hal_snapshot_Refresh", test_perf_mta_hal_snapshot_Refresh);
+    return 0;
+}
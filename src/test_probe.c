@@ -0,0 +1,345 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include "test_probe.h"
+#include "test_alloc.h"
+#include "test_trace.h"
+#include "test_counters.h"
+#include "test_record.h"
+
+static test_probe_slot_t gLocalSlot = { TEST_PROBE_API_NONE, 0, TEST_PROBE_API_NONE, 0 };
+static test_probe_slot_t *gpSlot = &gLocalSlot;
+
+static test_probe_timing_t gLocalTiming[TEST_PROBE_API_COUNT];
+static test_probe_timing_t *gpTiming = NULL;    /*!< NULL while timing is off */
+
+static test_histogram_t gLocalHistograms[TEST_PROBE_API_COUNT];
+static test_histogram_t *gpHistograms = NULL;   /*!< NULL while histograms are off */
+static const char *gpHistogramPath;
+static volatile sig_atomic_t gHistogramRequest;
+
+static test_counter_totals_t gLocalCounters[TEST_PROBE_API_COUNT];
+static test_counter_totals_t *gpCounters = NULL;    /*!< NULL while counters are off */
+
+/* Entry times of the call the thread is executing, a HAL may be called from several threads */
+static __thread uint64_t tEnterNs;
+static __thread uint64_t tEnterCpuNs;
+static __thread test_counter_sample_t tEnterCounters;
+
+static const char *gApiNames[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) #name,
+#define MTA_HAL_API_VOID(name, parameters, arguments) #name,
+#include "mta_hal_api_list.h"
+};
+
+uint64_t test_probe_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+void test_probe_attach(test_probe_slot_t *pSlot)
+{
+    gpSlot = (pSlot != NULL) ? pSlot : &gLocalSlot;
+    gpSlot->api = TEST_PROBE_API_NONE;
+    gpSlot->lastApi = TEST_PROBE_API_NONE;
+    gpSlot->enterNs = 0;
+    gpSlot->calls = 0;
+}
+
+const test_probe_slot_t *test_probe_slot(void)
+{
+    return gpSlot;
+}
+
+const char *test_probe_api_name(int api)
+{
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT))
+    {
+        return "none";
+    }
+    return gApiNames[api];
+}
+
+int test_probe_api_find(const char *name)
+{
+    int api;
+
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        if (strcmp(gApiNames[api], name) == 0)
+        {
+            return api;
+        }
+    }
+    return TEST_PROBE_API_NONE;
+}
+
+static uint64_t probe_thread_cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+void test_probe_timing_start(test_probe_timing_t *pTable)
+{
+    if (pTable == NULL)
+    {
+        memset(gLocalTiming, 0, sizeof(gLocalTiming));
+        pTable = gLocalTiming;
+    }
+    gpTiming = pTable;
+}
+
+void test_probe_timing_report(void)
+{
+    test_probe_timing_t *pTiming;
+    double ratio;
+    bool blocking;
+    int api;
+
+    if (gpTiming == NULL)
+    {
+        return;
+    }
+    UT_LOG_INFO("%-40s %8s %12s %12s %12s %8s %s", "HAL timing", "calls", "wall us/call", "cpu us/call", "max wall us", "cpu/wall", "class");
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        pTiming = &gpTiming[api];
+        if (pTiming->calls == 0)
+        {
+            continue;
+        }
+        ratio = (pTiming->wallNs > 0) ? ((double)pTiming->cpuNs / (double)pTiming->wallNs) : 1.0;
+        blocking = ((ratio < TEST_PROBE_COMPUTE_RATIO) && ((pTiming->wallNs / pTiming->calls) >= TEST_PROBE_BLOCKING_MIN_NS));
+        UT_LOG_INFO("%-40s %8llu %12.3f %12.3f %12.3f %8.2f %s", gApiNames[api], (unsigned long long)pTiming->calls,
+                    (double)pTiming->wallNs / 1000.0 / (double)pTiming->calls,
+                    (double)pTiming->cpuNs / 1000.0 / (double)pTiming->calls,
+                    (double)pTiming->maxWallNs / 1000.0, ratio,
+                    (blocking == true) ? "blocking" : "compute-bound");
+    }
+}
+
+static void probe_histogram_signal(int signum)
+{
+    (void)signum;
+    gHistogramRequest = 1;
+}
+
+void test_probe_histograms_start(test_histogram_t *pTable, const char *pPath)
+{
+    struct sigaction action;
+
+    if (pTable == NULL)
+    {
+        memset(gLocalHistograms, 0, sizeof(gLocalHistograms));
+        pTable = gLocalHistograms;
+    }
+    gpHistogramPath = pPath;
+    gpHistograms = pTable;
+
+    /* No SA_RESTART, so that a runner waiting for its children wakes up to write the histograms */
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = probe_histogram_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+}
+
+void test_probe_histograms_write(void)
+{
+    if (gpHistograms == NULL)
+    {
+        return;
+    }
+    if (test_histogram_dump(gpHistogramPath, gApiNames, gpHistograms, TEST_PROBE_API_COUNT) != 0)
+    {
+        UT_LOG_ERROR("Unable to write the HAL latency histograms to %s", gpHistogramPath);
+    }
+}
+
+void test_probe_histograms_poll(void)
+{
+    if (gHistogramRequest != 0)
+    {
+        gHistogramRequest = 0;
+        test_probe_histograms_write();
+    }
+}
+
+void test_probe_counters_start(test_counter_totals_t *pTable)
+{
+    if (pTable == NULL)
+    {
+        memset(gLocalCounters, 0, sizeof(gLocalCounters));
+        pTable = gLocalCounters;
+    }
+    gpCounters = pTable;
+}
+
+void test_probe_counters_report(void)
+{
+    if (gpCounters == NULL)
+    {
+        return;
+    }
+    test_counters_report(gpCounters, gApiNames, TEST_PROBE_API_COUNT);
+}
+
+static void probe_enter(int api)
+{
+    /* The wall interval encloses the CPU interval, so that clock overhead never makes a call look compute-bound */
+    tEnterNs = test_probe_now_ns();
+    if (gpTiming != NULL)
+    {
+        tEnterCpuNs = probe_thread_cpu_ns();
+    }
+    gpSlot->enterNs = tEnterNs;
+    gpSlot->api = api;
+    test_alloc_enter(api);
+    /* Read last, so that the counters exclude the probe itself */
+    if (gpCounters != NULL)
+    {
+        (void)test_counters_read(&tEnterCounters);
+    }
+}
+
+static void probe_timing_add(int api, uint64_t wallNs, uint64_t cpuNs)
+{
+    test_probe_timing_t *pTiming = &gpTiming[api];
+    uint64_t max;
+
+    __sync_fetch_and_add(&pTiming->calls, 1);
+    __sync_fetch_and_add(&pTiming->wallNs, wallNs);
+    __sync_fetch_and_add(&pTiming->cpuNs, cpuNs);
+    max = pTiming->maxWallNs;
+    while ((wallNs > max) && (__sync_bool_compare_and_swap(&pTiming->maxWallNs, max, wallNs) == 0))
+    {
+        max = pTiming->maxWallNs;
+    }
+}
+
+static uint64_t probe_exit(int api)
+{
+    test_counter_sample_t counters;
+    uint64_t cpuNs = 0;
+    uint64_t wallNs = 0;
+
+    if (gpCounters != NULL)
+    {
+        (void)test_counters_read(&counters);
+    }
+    if (gpTiming != NULL)
+    {
+        cpuNs = probe_thread_cpu_ns() - tEnterCpuNs;
+    }
+    if ((gpTiming != NULL) || (gpHistograms != NULL) || (gpCounters != NULL) || (test_trace_enabled() == true) ||
+        (test_record_enabled() == true))
+    {
+        wallNs = test_probe_now_ns() - tEnterNs;
+    }
+    if (gpTiming != NULL)
+    {
+        probe_timing_add(api, wallNs, cpuNs);
+    }
+    if (gpHistograms != NULL)
+    {
+        test_histogram_record(&gpHistograms[api], wallNs);
+        test_probe_histograms_poll();
+    }
+    if (gpCounters != NULL)
+    {
+        test_counters_delta(&tEnterCounters, &counters, &counters);
+        test_counters_add(&gpCounters[api], &counters, wallNs);
+    }
+    test_trace_complete(gApiNames[api], "hal", tEnterNs, wallNs, NULL, NULL);
+    test_alloc_exit(api);
+    gpSlot->api = TEST_PROBE_API_NONE;
+    gpSlot->lastApi = api;
+    gpSlot->calls++;
+    return wallNs;
+}
+
+/* Probes, see -Wl,--wrap in the Makefile */
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    extern returnType __real_##name parameters; \
+    returnType __wrap_##name parameters; \
+    returnType __wrap_##name parameters \
+    { \
+        returnType result; \
+        uint64_t wallNs; \
+        probe_enter(TEST_PROBE_ID(name)); \
+        result = __real_##name arguments; \
+        wallNs = probe_exit(TEST_PROBE_ID(name)); \
+        if (test_record_enabled() == true) \
+        { \
+            uintptr_t args[] = { TEST_RECORD_ARGS(arguments) 0 }; \
+            test_record_call(TEST_PROBE_ID(name), (int64_t)result, wallNs, args); \
+        } \
+        return result; \
+    }
+/* The void APIs register callbacks, their probes are written out below */
+#define MTA_HAL_API_VOID(name, parameters, arguments)
+#include "mta_hal_api_list.h"
+
+/*
+ * While a trace is written the registered callback is replaced by a trampoline, so that every invocation
+ * appears as a slice on the thread of the HAL, linked by a flow to the registration.
+ */
+static mta_hal_getLineRegisterStatus_callback volatile gpLineRegisterStatusCallback;
+static volatile uint64_t gLineRegisterStatusFlow;
+static uint32_t gFlowCount;
+
+static INT probe_line_register_status_callback(MTAMGMT_MTA_STATUS* output_status_array, int array_size)
+{
+    uint64_t startNs = test_probe_now_ns();
+    INT result;
+
+    test_trace_flow('t', gLineRegisterStatusFlow, "LineRegisterStatus", startNs);
+    result = gpLineRegisterStatusCallback(output_status_array, array_size);
+    test_trace_complete("LineRegisterStatus callback", "callback", startNs, test_probe_now_ns() - startNs, NULL, NULL);
+    return result;
+}
+
+extern void __real_mta_hal_LineRegisterStatus_callback_register(mta_hal_getLineRegisterStatus_callback callback_proc);
+void __wrap_mta_hal_LineRegisterStatus_callback_register(mta_hal_getLineRegisterStatus_callback callback_proc);
+void __wrap_mta_hal_LineRegisterStatus_callback_register(mta_hal_getLineRegisterStatus_callback callback_proc)
+{
+    probe_enter(TEST_PROBE_ID(mta_hal_LineRegisterStatus_callback_register));
+    if ((test_trace_enabled() == true) && (callback_proc != NULL))
+    {
+        /* Flow identifiers are unique across the processes of a forked run */
+        gLineRegisterStatusFlow = ((uint64_t)getpid() << 32) | ++gFlowCount;
+        gpLineRegisterStatusCallback = callback_proc;
+        test_trace_flow('s', gLineRegisterStatusFlow, "LineRegisterStatus", test_probe_now_ns());
+        callback_proc = probe_line_register_status_callback;
+    }
+    __real_mta_hal_LineRegisterStatus_callback_register(callback_proc);
+    (void)probe_exit(TEST_PROBE_ID(mta_hal_LineRegisterStatus_callback_register));
+}
@@ -0,0 +1,154 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_probe.h
+*
+* Call probes around every mta_hal API.
+*
+* The test binary is linked with -Wl,--wrap for each API in mta_hal_api_list.h, so every call made
+* by the tests, whether to the skeleton or to the vendor libhal_mta, passes through a probe. The probe
+* publishes the API currently executing into a slot, which the test runner places in memory shared
+* with the parent process so that a watchdog can tell which call a hung test is stuck in.
+*/
+
+#ifndef TEST_PROBE_H
+#define TEST_PROBE_H
+
+#include <stdint.h>
+#include "mta_hal.h"
+#include "test_histogram.h"
+#include "test_counters.h"
+
+#define TEST_PROBE_ID(name)     test_probe_id_##name
+
+typedef enum
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) TEST_PROBE_ID(name),
+#define MTA_HAL_API_VOID(name, parameters, arguments) TEST_PROBE_ID(name),
+#include "mta_hal_api_list.h"
+    TEST_PROBE_API_COUNT
+} test_probe_api_t;
+
+#define TEST_PROBE_API_NONE     (-1)
+
+/* State of the calling process, written by the probes */
+typedef struct
+{
+    volatile int api;               /*!< API being executed, TEST_PROBE_API_NONE outside the HAL */
+    volatile uint64_t enterNs;      /*!< CLOCK_MONOTONIC time the API was entered */
+    volatile int lastApi;           /*!< Last API that returned */
+    volatile uint32_t calls;        /*!< Number of API calls made */
+} test_probe_slot_t;
+
+/* Time spent in one API, accumulated by the probes when timing is on */
+typedef struct
+{
+    volatile uint64_t calls;
+    volatile uint64_t wallNs;       /*!< CLOCK_MONOTONIC time inside the API */
+    volatile uint64_t cpuNs;        /*!< CLOCK_THREAD_CPUTIME_ID time of the calling thread inside the API */
+    volatile uint64_t maxWallNs;
+} test_probe_timing_t;
+
+/*
+ * An API is labelled blocking when its calls spend less than TEST_PROBE_COMPUTE_RATIO of their wall time on
+ * the CPU. Calls shorter than TEST_PROBE_BLOCKING_MIN_NS on average cannot have waited for another process
+ * and are always compute-bound, their ratio being dominated by clock overhead.
+ */
+#define TEST_PROBE_COMPUTE_RATIO        (0.5)
+#define TEST_PROBE_BLOCKING_MIN_NS      (20000ULL)
+
+/**
+ * @brief Select where the probes publish their state
+ *
+ * @param[in] pSlot - slot to write, NULL selects the process local slot
+ */
+void test_probe_attach(test_probe_slot_t *pSlot);
+
+/**
+ * @brief Slot the probes currently publish to
+ */
+const test_probe_slot_t *test_probe_slot(void);
+
+/**
+ * @brief Start timing every API call
+ *
+ * @param[in] pTable - TEST_PROBE_API_COUNT zeroed entries to accumulate into, which may be shared between
+ *                     processes, NULL for a process local table
+ */
+void test_probe_timing_start(test_probe_timing_t *pTable);
+
+/**
+ * @brief Log wall and CPU time per API and label each API compute-bound or blocking
+ */
+void test_probe_timing_report(void);
+
+/**
+ * @brief Record a latency histogram of every API call
+ *
+ * Installs a SIGUSR1 handler; after the signal the histograms are written by the next probe or by
+ * test_probe_histograms_poll().
+ *
+ * @param[in] pTable - TEST_PROBE_API_COUNT zeroed histograms, which may be shared between processes,
+ *                     NULL for a process local table
+ * @param[in] pPath - file the histograms are written to
+ */
+void test_probe_histograms_start(test_histogram_t *pTable, const char *pPath);
+
+/**
+ * @brief Write the histograms to their file, if histograms are being recorded
+ */
+void test_probe_histograms_write(void);
+
+/**
+ * @brief Write the histograms if SIGUSR1 was received since the last call
+ */
+void test_probe_histograms_poll(void);
+
+/**
+ * @brief Accumulate the hardware counters of every API call, see test_counters.h
+ *
+ * @param[in] pTable - TEST_PROBE_API_COUNT zeroed entries, which may be shared between processes,
+ *                     NULL for a process local table
+ */
+void test_probe_counters_start(test_counter_totals_t *pTable);
+
+/**
+ * @brief Log the counters per call of each API, and the cycles per microsecond of wall time, which is
+ *        close to the clock rate for a compute-bound API and far below it for one that waits
+ */
+void test_probe_counters_report(void);
+
+/**
+ * @brief Name of an API, "none" for TEST_PROBE_API_NONE
+ */
+const char *test_probe_api_name(int api);
+
+/**
+ * @brief Look up an API by name
+ *
+ * @return int - API identifier, TEST_PROBE_API_NONE if unknown
+ */
+int test_probe_api_find(const char *name);
+
+/**
+ * @brief CLOCK_MONOTONIC time in nanoseconds
+ */
+uint64_t test_probe_now_ns(void);
+
+#endif /* TEST_PROBE_H */
@@ -0,0 +1,1253 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mta_hal.h"
+#include "test_probe.h"
+#include "test_record.h"
+
+#define RECORD_NO_ARG           (0xFF)
+#define RECORD_ARRAY_MAX        (256)       /*!< Longest integer array output recorded */
+
+typedef enum
+{
+    RECORD_FIELD_UINT = 0,      /*!< Integer, enumeration or BOOLEAN */
+    RECORD_FIELD_BYTES,         /*!< Character or byte array */
+    RECORD_FIELD_STRING,        /*!< CHAR* to a heap string, released by the caller */
+    RECORD_FIELD_NULL           /*!< Pointer not recorded, replayed as NULL */
+} record_field_kind_t;
+
+typedef struct
+{
+    uint16_t offset;
+    uint16_t size;
+    uint8_t kind;               /*!< record_field_kind_t */
+    const char *pName;
+} record_field_t;
+
+typedef struct
+{
+    size_t size;
+    const record_field_t *pFields;
+    int count;
+} record_struct_t;
+
+typedef enum
+{
+    RECORD_ARG_NONE = 0,
+    RECORD_ARG_VALUE,           /*!< Scalar input, part of the key of the call */
+    RECORD_ARG_IN,              /*!< Input buffer, not recorded */
+    RECORD_ARG_OUT_UINT,        /*!< Pointer to an integer output */
+    RECORD_ARG_OUT_STRUCT,      /*!< Pointer to a structure output */
+    RECORD_ARG_OUT_LIST,        /*!< Pointer to a heap array of structures, its length in the output aux */
+    RECORD_ARG_OUT_STRING,      /*!< Character buffer, its capacity in the input value of the output aux */
+    RECORD_ARG_OUT_ARRAY        /*!< Array of integers, its capacity in the scalar input aux */
+} record_arg_kind_t;
+
+typedef struct
+{
+    uint8_t kind;               /*!< record_arg_kind_t */
+    uint8_t aux;                /*!< Argument holding the length or capacity, RECORD_NO_ARG for none */
+    uint16_t size;              /*!< Bytes of an integer output or array element */
+    const record_struct_t *pStruct;
+} record_arg_t;
+
+typedef struct
+{
+    record_arg_t args[TEST_RECORD_MAX_ARGS];
+} record_api_t;
+
+typedef struct
+{
+    uint8_t *pData;
+    size_t used;
+    size_t size;
+    bool failed;
+} record_buffer_t;
+
+#define RECORD_FIELD(kind, type, member)    { (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type *)0)->member), (kind), #member }
+#define RECORD_UINT(type, member)           RECORD_FIELD(RECORD_FIELD_UINT, type, member)
+#define RECORD_BYTES(type, member)          RECORD_FIELD(RECORD_FIELD_BYTES, type, member)
+#define RECORD_STRUCT(name, type)           static const record_struct_t name = { sizeof(type), name##Fields, (int)(sizeof(name##Fields) / sizeof(name##Fields[0])) }
+
+#define RECORD_VALUE                        { RECORD_ARG_VALUE, RECORD_NO_ARG, 0, NULL }
+#define RECORD_IN                           { RECORD_ARG_IN, RECORD_NO_ARG, 0, NULL }
+#define RECORD_OUT_UINT(type)               { RECORD_ARG_OUT_UINT, RECORD_NO_ARG, sizeof(type), NULL }
+#define RECORD_OUT_STRUCT(desc)             { RECORD_ARG_OUT_STRUCT, RECORD_NO_ARG, 0, &(desc) }
+#define RECORD_OUT_LIST(desc, countArg)     { RECORD_ARG_OUT_LIST, (countArg), 0, &(desc) }
+#define RECORD_OUT_STRING(lengthArg)        { RECORD_ARG_OUT_STRING, (lengthArg), 0, NULL }
+#define RECORD_OUT_ARRAY(type, countArg)    { RECORD_ARG_OUT_ARRAY, (countArg), sizeof(type), NULL }
+
+static const record_field_t gDhcpInfoFields[] =
+{
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, IPAddress.Dot),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, SubnetMask.Dot),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, Gateway.Dot),
+    RECORD_UINT(MTAMGMT_MTA_DHCP_INFO, LeaseTimeRemaining),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, RebindTimeRemaining),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, RenewTimeRemaining),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, PrimaryDNS.Dot),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, SecondaryDNS.Dot),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, DHCPOption3),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, DHCPOption6),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, DHCPOption7),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, DHCPOption8),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, PCVersion),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, MACAddress),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, PrimaryDHCPServer.Dot),
+    RECORD_BYTES(MTAMGMT_MTA_DHCP_INFO, SecondaryDHCPServer.Dot)
+};
+RECORD_STRUCT(gDhcpInfo, MTAMGMT_MTA_DHCP_INFO);
+
+static const record_field_t gDhcpV6InfoFields[] =
+{
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, IPV6Address),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, Prefix),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, Gateway),
+    RECORD_UINT(MTAMGMT_MTA_DHCPv6_INFO, LeaseTimeRemaining),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, RebindTimeRemaining),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, RenewTimeRemaining),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, PrimaryDNS),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, SecondaryDNS),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, DHCPOption3),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, DHCPOption6),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, DHCPOption7),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, DHCPOption8),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, PCVersion),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, MACAddress),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, PrimaryDHCPv6Server),
+    RECORD_BYTES(MTAMGMT_MTA_DHCPv6_INFO, SecondaryDHCPv6Server)
+};
+RECORD_STRUCT(gDhcpV6Info, MTAMGMT_MTA_DHCPv6_INFO);
+
+static const record_field_t gCallsFields[] =
+{
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, Codec),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, RemoteCodec),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, CallStartTime),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, CallEndTime),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, CWErrorRate),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, PktLossConcealment),
+    RECORD_UINT(MTAMGMT_MTA_CALLS, JitterBufferAdaptive),
+    RECORD_UINT(MTAMGMT_MTA_CALLS, Originator),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, RemoteIPAddress.Dot),
+    RECORD_UINT(MTAMGMT_MTA_CALLS, CallDuration),
+    RECORD_BYTES(MTAMGMT_MTA_CALLS, CWErrors)
+};
+RECORD_STRUCT(gCalls, MTAMGMT_MTA_CALLS);
+
+/* pCalls is not filled by mta_hal_LineTableGetEntry, the calls of a line come from mta_hal_GetCalls */
+static const record_field_t gLineTableInfoFields[] =
+{
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, InstanceNumber),
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, LineNumber),
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, Status),
+    RECORD_BYTES(MTAMGMT_MTA_LINETABLE_INFO, HazardousPotential),
+    RECORD_BYTES(MTAMGMT_MTA_LINETABLE_INFO, ForeignEMF),
+    RECORD_BYTES(MTAMGMT_MTA_LINETABLE_INFO, ResistiveFaults),
+    RECORD_BYTES(MTAMGMT_MTA_LINETABLE_INFO, ReceiverOffHook),
+    RECORD_BYTES(MTAMGMT_MTA_LINETABLE_INFO, RingerEquivalency),
+    RECORD_BYTES(MTAMGMT_MTA_LINETABLE_INFO, CAName),
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, CAPort),
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, MWD),
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, CallsNumber),
+    RECORD_FIELD(RECORD_FIELD_NULL, MTAMGMT_MTA_LINETABLE_INFO, pCalls),
+    RECORD_UINT(MTAMGMT_MTA_LINETABLE_INFO, CallsUpdateTime)
+};
+RECORD_STRUCT(gLineTableInfo, MTAMGMT_MTA_LINETABLE_INFO);
+
+static const record_field_t gServiceFlowFields[] =
+{
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, SFID),
+    RECORD_BYTES(MTAMGMT_MTA_SERVICE_FLOW, ServiceClassName),
+    RECORD_BYTES(MTAMGMT_MTA_SERVICE_FLOW, Direction),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, ScheduleType),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, DefaultFlow),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, NomGrantInterval),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, UnsolicitGrantSize),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, TolGrantJitter),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, NomPollInterval),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, MinReservedPkt),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, MaxTrafficRate),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, MinReservedRate),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, MaxTrafficBurst),
+    RECORD_BYTES(MTAMGMT_MTA_SERVICE_FLOW, TrafficType),
+    RECORD_UINT(MTAMGMT_MTA_SERVICE_FLOW, NumberOfPackets)
+};
+RECORD_STRUCT(gServiceFlow, MTAMGMT_MTA_SERVICE_FLOW);
+
+static const record_field_t gDectFields[] =
+{
+    RECORD_UINT(MTAMGMT_MTA_DECT, RegisterDectHandset),
+    RECORD_UINT(MTAMGMT_MTA_DECT, DeregisterDectHandset),
+    RECORD_BYTES(MTAMGMT_MTA_DECT, HardwareVersion),
+    RECORD_BYTES(MTAMGMT_MTA_DECT, RFPI),
+    RECORD_BYTES(MTAMGMT_MTA_DECT, SoftwareVersion)
+};
+RECORD_STRUCT(gDect, MTAMGMT_MTA_DECT);
+
+static const record_field_t gHandsetsInfoFields[] =
+{
+    RECORD_UINT(MTAMGMT_MTA_HANDSETS_INFO, InstanceNumber),
+    RECORD_UINT(MTAMGMT_MTA_HANDSETS_INFO, Status),
+    RECORD_BYTES(MTAMGMT_MTA_HANDSETS_INFO, LastActiveTime),
+    RECORD_BYTES(MTAMGMT_MTA_HANDSETS_INFO, HandsetName),
+    RECORD_BYTES(MTAMGMT_MTA_HANDSETS_INFO, HandsetFirmware),
+    RECORD_BYTES(MTAMGMT_MTA_HANDSETS_INFO, OperatingTN),
+    RECORD_BYTES(MTAMGMT_MTA_HANDSETS_INFO, SupportedTN)
+};
+RECORD_STRUCT(gHandsetsInfo, MTAMGMT_MTA_HANDSETS_INFO);
+
+static const record_field_t gCallpFields[] =
+{
+    RECORD_BYTES(MTAMGMT_MTA_CALLP, LCState),
+    RECORD_BYTES(MTAMGMT_MTA_CALLP, CallPState),
+    RECORD_BYTES(MTAMGMT_MTA_CALLP, LoopCurrent)
+};
+RECORD_STRUCT(gCallp, MTAMGMT_MTA_CALLP);
+
+static const record_field_t gDsxLogFields[] =
+{
+    RECORD_BYTES(MTAMGMT_MTA_DSXLOG, Time),
+    RECORD_BYTES(MTAMGMT_MTA_DSXLOG, Description),
+    RECORD_UINT(MTAMGMT_MTA_DSXLOG, ID),
+    RECORD_UINT(MTAMGMT_MTA_DSXLOG, Level)
+};
+RECORD_STRUCT(gDsxLog, MTAMGMT_MTA_DSXLOG);
+
+static const record_field_t gMtaLogFields[] =
+{
+    RECORD_UINT(MTAMGMT_MTA_MTALOG_FULL, Index),
+    RECORD_UINT(MTAMGMT_MTA_MTALOG_FULL, EventID),
+    RECORD_BYTES(MTAMGMT_MTA_MTALOG_FULL, EventLevel),
+    RECORD_BYTES(MTAMGMT_MTA_MTALOG_FULL, Time),
+    RECORD_FIELD(RECORD_FIELD_STRING, MTAMGMT_MTA_MTALOG_FULL, pDescription)
+};
+RECORD_STRUCT(gMtaLog, MTAMGMT_MTA_MTALOG_FULL);
+
+static const record_field_t gBatteryInfoFields[] =
+{
+    RECORD_BYTES(MTAMGMT_MTA_BATTERY_INFO, ModelNumber),
+    RECORD_BYTES(MTAMGMT_MTA_BATTERY_INFO, SerialNumber),
+    RECORD_BYTES(MTAMGMT_MTA_BATTERY_INFO, PartNumber),
+    RECORD_BYTES(MTAMGMT_MTA_BATTERY_INFO, ChargerFirmwareRevision)
+};
+RECORD_STRUCT(gBatteryInfo, MTAMGMT_MTA_BATTERY_INFO);
+
+/* Arguments of every API, in the order of mta_hal_api_list.h; APIs not listed take no argument */
+static const record_api_t gApis[TEST_PROBE_API_COUNT] =
+{
+    [TEST_PROBE_ID(mta_hal_GetDHCPInfo)] = { { RECORD_OUT_STRUCT(gDhcpInfo) } },
+    [TEST_PROBE_ID(mta_hal_GetDHCPV6Info)] = { { RECORD_OUT_STRUCT(gDhcpV6Info) } },
+    [TEST_PROBE_ID(mta_hal_LineTableGetEntry)] = { { RECORD_VALUE, RECORD_OUT_STRUCT(gLineTableInfo) } },
+    [TEST_PROBE_ID(mta_hal_TriggerDiagnostics)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_GetServiceFlow)] = { { RECORD_OUT_UINT(ULONG), RECORD_OUT_LIST(gServiceFlow, 0) } },
+    [TEST_PROBE_ID(mta_hal_DectGetEnable)] = { { RECORD_OUT_UINT(BOOLEAN) } },
+    [TEST_PROBE_ID(mta_hal_DectSetEnable)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_DectGetRegistrationMode)] = { { RECORD_OUT_UINT(BOOLEAN) } },
+    [TEST_PROBE_ID(mta_hal_DectSetRegistrationMode)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_DectDeregisterDectHandset)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_GetDect)] = { { RECORD_OUT_STRUCT(gDect) } },
+    [TEST_PROBE_ID(mta_hal_GetDectPIN)] = { { RECORD_OUT_STRING(RECORD_NO_ARG) } },
+    [TEST_PROBE_ID(mta_hal_SetDectPIN)] = { { RECORD_IN } },
+    [TEST_PROBE_ID(mta_hal_GetHandsets)] = { { RECORD_OUT_UINT(ULONG), RECORD_OUT_LIST(gHandsetsInfo, 0) } },
+    [TEST_PROBE_ID(mta_hal_GetCalls)] = { { RECORD_VALUE, RECORD_OUT_UINT(ULONG), RECORD_OUT_LIST(gCalls, 1) } },
+    [TEST_PROBE_ID(mta_hal_GetCALLP)] = { { RECORD_VALUE, RECORD_OUT_STRUCT(gCallp) } },
+    [TEST_PROBE_ID(mta_hal_GetDSXLogs)] = { { RECORD_OUT_UINT(ULONG), RECORD_OUT_LIST(gDsxLog, 0) } },
+    [TEST_PROBE_ID(mta_hal_GetDSXLogEnable)] = { { RECORD_OUT_UINT(BOOLEAN) } },
+    [TEST_PROBE_ID(mta_hal_SetDSXLogEnable)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_ClearDSXLog)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_GetCallSignallingLogEnable)] = { { RECORD_OUT_UINT(BOOLEAN) } },
+    [TEST_PROBE_ID(mta_hal_SetCallSignallingLogEnable)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_ClearCallSignallingLog)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_GetMtaLog)] = { { RECORD_OUT_UINT(ULONG), RECORD_OUT_LIST(gMtaLog, 0) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetInstalled)] = { { RECORD_OUT_UINT(BOOLEAN) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetTotalCapacity)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetActualCapacity)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetRemainingCharge)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetRemainingTime)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetNumberofCycles)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetPowerStatus)] = { { RECORD_OUT_STRING(1), RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetCondition)] = { { RECORD_OUT_STRING(1), RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetStatus)] = { { RECORD_OUT_STRING(1), RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetLife)] = { { RECORD_OUT_STRING(1), RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetInfo)] = { { RECORD_OUT_STRUCT(gBatteryInfo) } },
+    [TEST_PROBE_ID(mta_hal_BatteryGetPowerSavingModeStatus)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_Get_MTAResetCount)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_Get_LineResetCount)] = { { RECORD_OUT_UINT(ULONG) } },
+    [TEST_PROBE_ID(mta_hal_ClearCalls)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_getDhcpStatus)] = { { RECORD_OUT_UINT(MTAMGMT_MTA_STATUS), RECORD_OUT_UINT(MTAMGMT_MTA_STATUS) } },
+    [TEST_PROBE_ID(mta_hal_getConfigFileStatus)] = { { RECORD_OUT_UINT(MTAMGMT_MTA_STATUS) } },
+    [TEST_PROBE_ID(mta_hal_getLineRegisterStatus)] = { { RECORD_OUT_ARRAY(MTAMGMT_MTA_STATUS, 1), RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_devResetNow)] = { { RECORD_VALUE } },
+    [TEST_PROBE_ID(mta_hal_getMtaOperationalStatus)] = { { RECORD_OUT_UINT(MTAMGMT_MTA_STATUS) } },
+    [TEST_PROBE_ID(mta_hal_getMtaProvisioningStatus)] = { { RECORD_OUT_UINT(MTAMGMT_MTA_PROVISION_STATUS) } },
+    [TEST_PROBE_ID(mta_hal_start_provisioning)] = { { RECORD_IN } },
+};
+
+static const char *gApiNames[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) #name,
+#define MTA_HAL_API_VOID(name, parameters, arguments) #name,
+#include "mta_hal_api_list.h"
+};
+
+/* Argument names of every API, "(Index, pEntry)" */
+static const char *gArgNames[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) #arguments,
+#define MTA_HAL_API_VOID(name, parameters, arguments) #arguments,
+#include "mta_hal_api_list.h"
+};
+
+static int gFd = -1;
+
+const char *test_record_api_name(int api)
+{
+    if ((api < 0) || (api >= TEST_PROBE_API_COUNT))
+    {
+        return NULL;
+    }
+    return gApiNames[api];
+}
+
+static uint64_t record_get_uint(const void *pValue, size_t size)
+{
+    switch (size)
+    {
+        case 1:
+            return *(const uint8_t *)pValue;
+        case 2:
+            return *(const uint16_t *)pValue;
+        case 4:
+            return *(const uint32_t *)pValue;
+        default:
+            return *(const uint64_t *)pValue;
+    }
+}
+
+static void record_set_uint(void *pValue, size_t size, uint64_t value)
+{
+    switch (size)
+    {
+        case 1:
+            *(uint8_t *)pValue = (uint8_t)value;
+            break;
+        case 2:
+            *(uint16_t *)pValue = (uint16_t)value;
+            break;
+        case 4:
+            *(uint32_t *)pValue = (uint32_t)value;
+            break;
+        default:
+            *(uint64_t *)pValue = value;
+            break;
+    }
+}
+
+/* Encoding */
+
+static void record_put(record_buffer_t *pBuffer, const void *pData, size_t length)
+{
+    uint8_t *pGrown;
+    size_t size;
+
+    if (pBuffer->failed == true)
+    {
+        return;
+    }
+    if ((pBuffer->used + length) > pBuffer->size)
+    {
+        size = (pBuffer->size > 0) ? pBuffer->size : 256;
+        while (size < (pBuffer->used + length))
+        {
+            size *= 2;
+        }
+        pGrown = realloc(pBuffer->pData, size);
+        if (pGrown == NULL)
+        {
+            pBuffer->failed = true;
+            return;
+        }
+        pBuffer->pData = pGrown;
+        pBuffer->size = size;
+    }
+    memcpy(&pBuffer->pData[pBuffer->used], pData, length);
+    pBuffer->used += length;
+}
+
+static void record_put_u8(record_buffer_t *pBuffer, uint8_t value)
+{
+    record_put(pBuffer, &value, sizeof(value));
+}
+
+static void record_put_u16(record_buffer_t *pBuffer, uint16_t value)
+{
+    record_put(pBuffer, &value, sizeof(value));
+}
+
+static void record_put_u32(record_buffer_t *pBuffer, uint32_t value)
+{
+    record_put(pBuffer, &value, sizeof(value));
+}
+
+static void record_put_u64(record_buffer_t *pBuffer, uint64_t value)
+{
+    record_put(pBuffer, &value, sizeof(value));
+}
+
+static void record_put_string(record_buffer_t *pBuffer, const char *pString)
+{
+    uint32_t length = 0;
+
+    if (pString != NULL)
+    {
+        length = (uint32_t)strnlen(pString, TEST_RECORD_STRING_MAX - 1);
+    }
+    record_put_u32(pBuffer, length);
+    record_put(pBuffer, pString, length);
+}
+
+static void record_put_struct(record_buffer_t *pBuffer, const record_struct_t *pStruct, const uint8_t *pValue)
+{
+    const record_field_t *pField;
+    uint16_t length;
+    int i;
+
+    for (i = 0; i < pStruct->count; i++)
+    {
+        pField = &pStruct->pFields[i];
+        switch (pField->kind)
+        {
+            case RECORD_FIELD_UINT:
+                record_put_u64(pBuffer, record_get_uint(&pValue[pField->offset], pField->size));
+                break;
+            case RECORD_FIELD_BYTES:
+                /* Trailing zeros are implied */
+                length = pField->size;
+                while ((length > 0) && (pValue[pField->offset + length - 1] == 0))
+                {
+                    length--;
+                }
+                record_put_u16(pBuffer, length);
+                record_put(pBuffer, &pValue[pField->offset], length);
+                break;
+            case RECORD_FIELD_STRING:
+                record_put_string(pBuffer, *(char *const *)&pValue[pField->offset]);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void record_put_arg(record_buffer_t *pBuffer, const record_api_t *pApi, int arg, const uintptr_t *pArgs)
+{
+    const record_arg_t *pArg = &pApi->args[arg];
+    const void *pValue = (const void *)pArgs[arg];
+    const uint8_t *pList;
+    uint32_t count;
+    uint32_t i;
+
+    /* Every output starts with whether the caller passed it */
+    record_put_u8(pBuffer, (pValue != NULL) ? 1 : 0);
+    if (pValue == NULL)
+    {
+        return;
+    }
+    switch (pArg->kind)
+    {
+        case RECORD_ARG_OUT_UINT:
+            record_put_u64(pBuffer, record_get_uint(pValue, pArg->size));
+            break;
+        case RECORD_ARG_OUT_STRUCT:
+            record_put_struct(pBuffer, pArg->pStruct, pValue);
+            break;
+        case RECORD_ARG_OUT_LIST:
+            pList = *(const uint8_t *const *)pValue;
+            count = 0;
+            if ((pList != NULL) && (pArgs[pArg->aux] != 0))
+            {
+                count = (uint32_t)record_get_uint((const void *)pArgs[pArg->aux], pApi->args[pArg->aux].size);
+            }
+            record_put_u32(pBuffer, count);
+            for (i = 0; i < count; i++)
+            {
+                record_put_struct(pBuffer, pArg->pStruct, &pList[i * pArg->pStruct->size]);
+            }
+            break;
+        case RECORD_ARG_OUT_STRING:
+            record_put_string(pBuffer, pValue);
+            break;
+        case RECORD_ARG_OUT_ARRAY:
+            /* The capacity is a signed int, a negative one is rejected by the HAL */
+            count = (((intptr_t)pArgs[pArg->aux] > 0) && (pArgs[pArg->aux] <= RECORD_ARRAY_MAX)) ? (uint32_t)pArgs[pArg->aux] : 0;
+            record_put_u32(pBuffer, count);
+            for (i = 0; i < count; i++)
+            {
+                record_put_u64(pBuffer, record_get_uint((const uint8_t *)pValue + (i * pArg->size), pArg->size));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static bool record_is_output(uint8_t kind)
+{
+    return (kind >= RECORD_ARG_OUT_UINT);
+}
+
+void test_record_key(int api, const uintptr_t *pArgs, uint64_t *pKey)
+{
+    int arg;
+
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        pKey[arg] = (gApis[api].args[arg].kind == RECORD_ARG_VALUE) ? (uint64_t)pArgs[arg] : 0;
+    }
+}
+
+int test_record_open(const char *pPath)
+{
+    record_buffer_t buffer = { NULL, 0, 0, false };
+    uint8_t length;
+    int api;
+
+    gFd = open(pPath, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (gFd < 0)
+    {
+        return -1;
+    }
+    record_put(&buffer, TEST_RECORD_MAGIC, strlen(TEST_RECORD_MAGIC));
+    record_put_u32(&buffer, TEST_RECORD_VERSION);
+    record_put_u32(&buffer, TEST_RECORD_BYTE_ORDER);
+    record_put_u32(&buffer, TEST_PROBE_API_COUNT);
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        length = (uint8_t)strlen(gApiNames[api]);
+        record_put_u8(&buffer, length);
+        record_put(&buffer, gApiNames[api], length);
+    }
+    if ((buffer.failed == true) || (write(gFd, buffer.pData, buffer.used) != (ssize_t)buffer.used))
+    {
+        free(buffer.pData);
+        close(gFd);
+        gFd = -1;
+        return -1;
+    }
+    free(buffer.pData);
+    return 0;
+}
+
+void test_record_close(void)
+{
+    if (gFd >= 0)
+    {
+        close(gFd);
+        gFd = -1;
+    }
+}
+
+bool test_record_enabled(void)
+{
+    return (gFd >= 0);
+}
+
+void test_record_call(int api, int64_t result, uint64_t latencyNs, const uintptr_t *pArgs)
+{
+    record_buffer_t buffer = { NULL, 0, 0, false };
+    test_record_header_t header;
+    int arg;
+
+    if (gFd < 0)
+    {
+        return;
+    }
+    memset(&header, 0, sizeof(header));
+    header.api = (uint16_t)api;
+    header.result = result;
+    header.latencyNs = latencyNs;
+    test_record_key(api, pArgs, header.key);
+    record_put(&buffer, &header, sizeof(header));
+    if (result == RETURN_OK)
+    {
+        for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+        {
+            if (record_is_output(gApis[api].args[arg].kind) == true)
+            {
+                record_put_arg(&buffer, &gApis[api], arg, pArgs);
+            }
+        }
+    }
+    if (buffer.failed == false)
+    {
+        /* The length is known once the outputs are encoded */
+        ((test_record_header_t *)buffer.pData)->length = (uint32_t)buffer.used;
+        (void)write(gFd, buffer.pData, buffer.used);
+    }
+    free(buffer.pData);
+}
+
+/* Decoding */
+
+typedef struct
+{
+    const uint8_t *pData;
+    size_t length;
+    size_t offset;
+    bool failed;
+} record_reader_t;
+
+static const uint8_t *record_get(record_reader_t *pReader, size_t length)
+{
+    const uint8_t *pData;
+
+    if ((pReader->failed == true) || ((pReader->offset + length) > pReader->length))
+    {
+        pReader->failed = true;
+        return NULL;
+    }
+    pData = &pReader->pData[pReader->offset];
+    pReader->offset += length;
+    return pData;
+}
+
+static uint64_t record_get_number(record_reader_t *pReader, size_t size)
+{
+    const uint8_t *pData = record_get(pReader, size);
+    uint64_t value = 0;
+
+    if (pData != NULL)
+    {
+        memcpy(&value, pData, size);
+    }
+    return value;
+}
+
+static void record_get_struct(record_reader_t *pReader, const record_struct_t *pStruct, uint8_t *pValue)
+{
+    const record_field_t *pField;
+    const uint8_t *pBytes;
+    char *pString;
+    uint32_t length;
+    int i;
+
+    memset(pValue, 0, pStruct->size);
+    for (i = 0; i < pStruct->count; i++)
+    {
+        pField = &pStruct->pFields[i];
+        switch (pField->kind)
+        {
+            case RECORD_FIELD_UINT:
+                record_set_uint(&pValue[pField->offset], pField->size, record_get_number(pReader, sizeof(uint64_t)));
+                break;
+            case RECORD_FIELD_BYTES:
+                length = (uint32_t)record_get_number(pReader, sizeof(uint16_t));
+                pBytes = record_get(pReader, length);
+                if (pBytes != NULL)
+                {
+                    memcpy(&pValue[pField->offset], pBytes, (length < pField->size) ? length : pField->size);
+                }
+                break;
+            case RECORD_FIELD_STRING:
+                length = (uint32_t)record_get_number(pReader, sizeof(uint32_t));
+                pBytes = record_get(pReader, length);
+                pString = (pBytes != NULL) ? malloc(length + 1) : NULL;
+                if (pString != NULL)
+                {
+                    memcpy(pString, pBytes, length);
+                    pString[length] = '\0';
+                }
+                memcpy(&pValue[pField->offset], &pString, sizeof(pString));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+static void record_get_arg(record_reader_t *pReader, const record_api_t *pApi, int arg, const uintptr_t *pArgs)
+{
+    const record_arg_t *pArg = &pApi->args[arg];
+    void *pValue = (void *)pArgs[arg];
+    const uint8_t *pBytes;
+    uint8_t *pList = NULL;
+    uint64_t capacity;
+    uint64_t value;
+    uint32_t count;
+    uint32_t i;
+
+    if (record_get_number(pReader, sizeof(uint8_t)) == 0)
+    {
+        /* Not passed when recorded */
+        return;
+    }
+    switch (pArg->kind)
+    {
+        case RECORD_ARG_OUT_UINT:
+            value = record_get_number(pReader, sizeof(uint64_t));
+            if (pValue != NULL)
+            {
+                record_set_uint(pValue, pArg->size, value);
+            }
+            break;
+        case RECORD_ARG_OUT_STRUCT:
+            if (pValue != NULL)
+            {
+                record_get_struct(pReader, pArg->pStruct, pValue);
+            }
+            break;
+        case RECORD_ARG_OUT_LIST:
+            count = (uint32_t)record_get_number(pReader, sizeof(uint32_t));
+            if (count > 0)
+            {
+                pList = calloc(count, pArg->pStruct->size);
+                if (pList == NULL)
+                {
+                    pReader->failed = true;
+                }
+            }
+            for (i = 0; (i < count) && (pList != NULL); i++)
+            {
+                record_get_struct(pReader, pArg->pStruct, &pList[i * pArg->pStruct->size]);
+            }
+            if (pValue != NULL)
+            {
+                *(uint8_t **)pValue = pList;
+            }
+            else
+            {
+                free(pList);
+            }
+            break;
+        case RECORD_ARG_OUT_STRING:
+            count = (uint32_t)record_get_number(pReader, sizeof(uint32_t));
+            pBytes = record_get(pReader, count);
+            if ((pValue == NULL) || (pBytes == NULL))
+            {
+                break;
+            }
+            /* Bounded by the capacity the caller passed in the length argument, if the API has one */
+            capacity = TEST_RECORD_STRING_MAX;
+            if ((pArg->aux != RECORD_NO_ARG) && (pArgs[pArg->aux] != 0))
+            {
+                capacity = record_get_uint((const void *)pArgs[pArg->aux], pApi->args[pArg->aux].size);
+            }
+            if (capacity == 0)
+            {
+                break;
+            }
+            if (count >= capacity)
+            {
+                count = (uint32_t)(capacity - 1);
+            }
+            memcpy(pValue, pBytes, count);
+            ((char *)pValue)[count] = '\0';
+            break;
+        case RECORD_ARG_OUT_ARRAY:
+            count = (uint32_t)record_get_number(pReader, sizeof(uint32_t));
+            capacity = (uint64_t)pArgs[pArg->aux];
+            for (i = 0; i < count; i++)
+            {
+                value = record_get_number(pReader, sizeof(uint64_t));
+                if ((pValue != NULL) && (i < capacity))
+                {
+                    record_set_uint((uint8_t *)pValue + (i * pArg->size), pArg->size, value);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+int test_record_decode(int api, const uint8_t *pOutputs, size_t length, const uintptr_t *pArgs)
+{
+    record_reader_t reader = { pOutputs, length, 0, false };
+    int arg;
+
+    if (length == 0)
+    {
+        /* The recorded call failed, the outputs are left as they are */
+        return 0;
+    }
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        if (record_is_output(gApis[api].args[arg].kind) == true)
+        {
+            record_get_arg(&reader, &gApis[api], arg, pArgs);
+        }
+    }
+    return (reader.failed == true) ? -1 : 0;
+}
+
+size_t test_record_map(const uint8_t *pData, size_t size, int *pApiMap, int *pApiCount)
+{
+    record_reader_t reader = { pData, size, 0, false };
+    const uint8_t *pName;
+    uint32_t count;
+    uint8_t length;
+    uint32_t i;
+    int api;
+
+    pName = record_get(&reader, strlen(TEST_RECORD_MAGIC));
+    if ((pName == NULL) || (memcmp(pName, TEST_RECORD_MAGIC, strlen(TEST_RECORD_MAGIC)) != 0) ||
+        (record_get_number(&reader, sizeof(uint32_t)) != TEST_RECORD_VERSION) ||
+        (record_get_number(&reader, sizeof(uint32_t)) != TEST_RECORD_BYTE_ORDER))
+    {
+        return 0;
+    }
+    count = (uint32_t)record_get_number(&reader, sizeof(uint32_t));
+    for (i = 0; (i < count) && (reader.failed == false); i++)
+    {
+        length = (uint8_t)record_get_number(&reader, sizeof(uint8_t));
+        pName = record_get(&reader, length);
+        if ((pName == NULL) || (i >= TEST_PROBE_API_COUNT))
+        {
+            continue;
+        }
+        pApiMap[i] = TEST_PROBE_API_NONE;
+        for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+        {
+            if ((strlen(gApiNames[api]) == length) && (memcmp(gApiNames[api], pName, length) == 0))
+            {
+                pApiMap[i] = api;
+                break;
+            }
+        }
+    }
+    if (reader.failed == true)
+    {
+        return 0;
+    }
+    *pApiCount = (count < TEST_PROBE_API_COUNT) ? (int)count : TEST_PROBE_API_COUNT;
+    return reader.offset;
+}
+
+/* Storage and comparison of call arguments */
+
+int test_record_arg_count(int api)
+{
+    const char *pNames = gArgNames[api];
+    int count = 1;
+
+    if (strcmp(pNames, "()") == 0)
+    {
+        return 0;
+    }
+    while ((pNames = strchr(pNames, ',')) != NULL)
+    {
+        count++;
+        pNames++;
+    }
+    return count;
+}
+
+bool test_record_api_is_query(int api)
+{
+    int outputs = 0;
+    int arg;
+
+    for (arg = 0; arg < test_record_arg_count(api); arg++)
+    {
+        if ((gApis[api].args[arg].kind == RECORD_ARG_IN) || (gApis[api].args[arg].kind == RECORD_ARG_NONE))
+        {
+            /* An input buffer, or a callback */
+            return false;
+        }
+        if (record_is_output(gApis[api].args[arg].kind) == true)
+        {
+            outputs++;
+        }
+    }
+    return (outputs > 0) || (test_record_arg_count(api) == 0);
+}
+
+bool test_record_arg_is_output(int api, int arg)
+{
+    if ((arg < 0) || (arg >= TEST_RECORD_MAX_ARGS))
+    {
+        return false;
+    }
+    return record_is_output(gApis[api].args[arg].kind);
+}
+
+uint64_t test_record_arg_elements(int api, int arg, const uintptr_t *pArgs)
+{
+    const record_arg_t *pArg;
+
+    if ((arg < 0) || (arg >= TEST_RECORD_MAX_ARGS) || (pArgs[arg] == 0))
+    {
+        return 0;
+    }
+    pArg = &gApis[api].args[arg];
+    if (pArg->kind == RECORD_ARG_OUT_UINT)
+    {
+        return 1;
+    }
+    if (pArg->kind == RECORD_ARG_OUT_ARRAY)
+    {
+        return (pArgs[pArg->aux] > RECORD_ARRAY_MAX) ? RECORD_ARRAY_MAX : (uint64_t)pArgs[pArg->aux];
+    }
+    return 0;
+}
+
+int test_record_args_alloc(int api, uint64_t value, uintptr_t *pArgs)
+{
+    const record_arg_t *pArg;
+    void *pStorage;
+    int arg;
+
+    memset(pArgs, 0, sizeof(uintptr_t) * (TEST_RECORD_MAX_ARGS + 1));
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        pArg = &gApis[api].args[arg];
+        pStorage = NULL;
+        switch (pArg->kind)
+        {
+            case RECORD_ARG_VALUE:
+                pArgs[arg] = (uintptr_t)value;
+                continue;
+            case RECORD_ARG_IN:
+                test_record_args_free(api, pArgs);
+                return -1;
+            case RECORD_ARG_OUT_UINT:
+                pStorage = calloc(1, sizeof(uint64_t));
+                break;
+            case RECORD_ARG_OUT_STRUCT:
+                pStorage = calloc(1, pArg->pStruct->size);
+                break;
+            case RECORD_ARG_OUT_LIST:
+                pStorage = calloc(1, sizeof(void *));
+                break;
+            case RECORD_ARG_OUT_STRING:
+                pStorage = calloc(1, TEST_RECORD_STRING_MAX);
+                break;
+            case RECORD_ARG_OUT_ARRAY:
+                pStorage = calloc(RECORD_ARRAY_MAX, pArg->size);
+                break;
+            default:
+                continue;
+        }
+        if (pStorage == NULL)
+        {
+            test_record_args_free(api, pArgs);
+            return -1;
+        }
+        pArgs[arg] = (uintptr_t)pStorage;
+    }
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        pArg = &gApis[api].args[arg];
+        if ((pArg->kind == RECORD_ARG_OUT_STRING) && (pArg->aux != RECORD_NO_ARG))
+        {
+            /* The length argument carries the capacity of the buffer in */
+            record_set_uint((void *)pArgs[pArg->aux], gApis[api].args[pArg->aux].size, TEST_RECORD_STRING_MAX);
+        }
+        if ((pArg->kind == RECORD_ARG_OUT_ARRAY) && (pArgs[pArg->aux] > RECORD_ARRAY_MAX))
+        {
+            pArgs[pArg->aux] = RECORD_ARRAY_MAX;
+        }
+    }
+    return 0;
+}
+
+static void record_free_list(const record_arg_t *pArg, uint8_t *pList, uint64_t count)
+{
+    const record_field_t *pField;
+    uint64_t i;
+    int field;
+
+    if (pList == NULL)
+    {
+        return;
+    }
+    for (field = 0; field < pArg->pStruct->count; field++)
+    {
+        pField = &pArg->pStruct->pFields[field];
+        for (i = 0; (pField->kind == RECORD_FIELD_STRING) && (i < count); i++)
+        {
+            free(*(char **)&pList[(i * pArg->pStruct->size) + pField->offset]);
+        }
+    }
+    free(pList);
+}
+
+void test_record_args_release(int api, const uintptr_t *pArgs)
+{
+    const record_arg_t *pArg;
+    int arg;
+
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        pArg = &gApis[api].args[arg];
+        if ((pArg->kind == RECORD_ARG_OUT_LIST) && (pArgs[arg] != 0))
+        {
+            record_free_list(pArg, *(uint8_t **)pArgs[arg],
+                             (pArgs[pArg->aux] != 0) ? record_get_uint((const void *)pArgs[pArg->aux], gApis[api].args[pArg->aux].size) : 0);
+            *(uint8_t **)pArgs[arg] = NULL;
+        }
+    }
+}
+
+void test_record_args_free(int api, uintptr_t *pArgs)
+{
+    int arg;
+
+    /* Lists first, their length is held by another output */
+    test_record_args_release(api, pArgs);
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        if (record_is_output(gApis[api].args[arg].kind) == true)
+        {
+            free((void *)pArgs[arg]);
+        }
+        pArgs[arg] = 0;
+    }
+}
+
+static void record_arg_name(char *pOut, size_t size, int api, int arg)
+{
+    const char *pName = gArgNames[api] + 1;
+    size_t length;
+    int i;
+
+    for (i = 0; (i < arg) && (pName != NULL); i++)
+    {
+        pName = strchr(pName, ',');
+        pName = (pName != NULL) ? (pName + 1) : NULL;
+    }
+    if (pName == NULL)
+    {
+        snprintf(pOut, size, "arg%d", arg);
+        return;
+    }
+    while (*pName == ' ')
+    {
+        pName++;
+    }
+    length = strcspn(pName, ",)");
+    snprintf(pOut, size, "%.*s", (int)length, pName);
+}
+
+/* Printable text of a character array or string, bytes outside ASCII as \xNN */
+static void record_format_bytes(char *pOut, size_t size, const uint8_t *pBytes, size_t length)
+{
+    size_t used = 0;
+    size_t i;
+
+    while ((length > 0) && (pBytes[length - 1] == 0))
+    {
+        length--;
+    }
+    used += (size_t)snprintf(&pOut[used], size - used, "\"");
+    for (i = 0; (i < length) && ((used + 6) < size); i++)
+    {
+        if ((pBytes[i] >= 0x20) && (pBytes[i] < 0x7F) && (pBytes[i] != '"'))
+        {
+            pOut[used++] = (char)pBytes[i];
+        }
+        else
+        {
+            used += (size_t)snprintf(&pOut[used], size - used, "\\x%02X", pBytes[i]);
+        }
+    }
+    snprintf(&pOut[used], size - used, "\"");
+}
+
+typedef struct
+{
+    const char *const *pIgnored;
+    int numIgnored;
+    test_record_difference_fn_t report;
+    void *pContext;
+    int differences;
+} record_compare_t;
+
+static bool record_ignored(const record_compare_t *pCompare, const char *pName)
+{
+    int i;
+
+    for (i = 0; i < pCompare->numIgnored; i++)
+    {
+        if (strcmp(pCompare->pIgnored[i], pName) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void record_difference(record_compare_t *pCompare, const char *pPath, const char *pLeft, const char *pRight)
+{
+    pCompare->differences++;
+    if (pCompare->report != NULL)
+    {
+        pCompare->report(pCompare->pContext, pPath, pLeft, pRight);
+    }
+}
+
+static void record_compare_uint(record_compare_t *pCompare, const char *pPath, uint64_t left, uint64_t right)
+{
+    char leftText[24];
+    char rightText[24];
+
+    if (left != right)
+    {
+        snprintf(leftText, sizeof(leftText), "%llu", (unsigned long long)left);
+        snprintf(rightText, sizeof(rightText), "%llu", (unsigned long long)right);
+        record_difference(pCompare, pPath, leftText, rightText);
+    }
+}
+
+static void record_compare_text(record_compare_t *pCompare, const char *pPath, const uint8_t *pLeft, size_t leftLength,
+                                const uint8_t *pRight, size_t rightLength)
+{
+    char leftText[TEST_RECORD_TEXT_SIZE];
+    char rightText[TEST_RECORD_TEXT_SIZE];
+
+    while ((leftLength > 0) && (pLeft[leftLength - 1] == 0))
+    {
+        leftLength--;
+    }
+    while ((rightLength > 0) && (pRight[rightLength - 1] == 0))
+    {
+        rightLength--;
+    }
+    if ((leftLength != rightLength) || (memcmp(pLeft, pRight, leftLength) != 0))
+    {
+        record_format_bytes(leftText, sizeof(leftText), pLeft, leftLength);
+        record_format_bytes(rightText, sizeof(rightText), pRight, rightLength);
+        record_difference(pCompare, pPath, leftText, rightText);
+    }
+}
+
+static size_t record_string_length(const char *pString)
+{
+    return (pString != NULL) ? strnlen(pString, TEST_RECORD_STRING_MAX) : 0;
+}
+
+static void record_compare_struct(record_compare_t *pCompare, const char *pPrefix, const record_struct_t *pStruct,
+                                  const uint8_t *pLeft, const uint8_t *pRight)
+{
+    const record_field_t *pField;
+    const char *pLeftString;
+    const char *pRightString;
+    char path[TEST_RECORD_TEXT_SIZE];
+    int i;
+
+    for (i = 0; i < pStruct->count; i++)
+    {
+        pField = &pStruct->pFields[i];
+        if (record_ignored(pCompare, pField->pName) == true)
+        {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s.%s", pPrefix, pField->pName);
+        switch (pField->kind)
+        {
+            case RECORD_FIELD_UINT:
+                record_compare_uint(pCompare, path, record_get_uint(&pLeft[pField->offset], pField->size),
+                                    record_get_uint(&pRight[pField->offset], pField->size));
+                break;
+            case RECORD_FIELD_BYTES:
+                record_compare_text(pCompare, path, &pLeft[pField->offset], pField->size, &pRight[pField->offset], pField->size);
+                break;
+            case RECORD_FIELD_STRING:
+                memcpy(&pLeftString, &pLeft[pField->offset], sizeof(pLeftString));
+                memcpy(&pRightString, &pRight[pField->offset], sizeof(pRightString));
+                record_compare_text(pCompare, path, (const uint8_t *)pLeftString, record_string_length(pLeftString),
+                                    (const uint8_t *)pRightString, record_string_length(pRightString));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+int test_record_compare(int api, const uintptr_t *pLeft, const uintptr_t *pRight, const char *const *pIgnored, int numIgnored,
+                        test_record_difference_fn_t report, void *pContext)
+{
+    record_compare_t compare = { pIgnored, numIgnored, report, pContext, 0 };
+    const record_arg_t *pArg;
+    const uint8_t *pLeftList;
+    const uint8_t *pRightList;
+    char name[TEST_RECORD_TEXT_SIZE / 2];
+    char path[TEST_RECORD_TEXT_SIZE];
+    uint64_t leftCount;
+    uint64_t rightCount;
+    uint64_t i;
+    int arg;
+
+    for (arg = 0; arg < TEST_RECORD_MAX_ARGS; arg++)
+    {
+        pArg = &gApis[api].args[arg];
+        if ((record_is_output(pArg->kind) == false) || (pLeft[arg] == 0) || (pRight[arg] == 0))
+        {
+            continue;
+        }
+        record_arg_name(name, sizeof(name), api, arg);
+        if (record_ignored(&compare, name) == true)
+        {
+            continue;
+        }
+        switch (pArg->kind)
+        {
+            case RECORD_ARG_OUT_UINT:
+                record_compare_uint(&compare, name, record_get_uint((const void *)pLeft[arg], pArg->size),
+                                    record_get_uint((const void *)pRight[arg], pArg->size));
+                break;
+            case RECORD_ARG_OUT_STRUCT:
+                record_compare_struct(&compare, name, pArg->pStruct, (const uint8_t *)pLeft[arg], (const uint8_t *)pRight[arg]);
+                break;
+            case RECORD_ARG_OUT_LIST:
+                pLeftList = *(const uint8_t *const *)pLeft[arg];
+                pRightList = *(const uint8_t *const *)pRight[arg];
+                leftCount = (pLeftList != NULL) ? record_get_uint((const void *)pLeft[pArg->aux], gApis[api].args[pArg->aux].size) : 0;
+                rightCount = (pRightList != NULL) ? record_get_uint((const void *)pRight[pArg->aux], gApis[api].args[pArg->aux].size) : 0;
+                /* A count difference is reported with the count output, the common entries are compared */
+                for (i = 0; (i < leftCount) && (i < rightCount); i++)
+                {
+                    snprintf(path, sizeof(path), "(*%s)[%llu]", name, (unsigned long long)i);
+                    record_compare_struct(&compare, path, pArg->pStruct, &pLeftList[i * pArg->pStruct->size],
+                                          &pRightList[i * pArg->pStruct->size]);
+                }
+                break;
+            case RECORD_ARG_OUT_STRING:
+                record_compare_text(&compare, name, (const uint8_t *)pLeft[arg], record_string_length((const char *)pLeft[arg]),
+                                    (const uint8_t *)pRight[arg], record_string_length((const char *)pRight[arg]));
+                break;
+            case RECORD_ARG_OUT_ARRAY:
+                for (i = 0; i < (uint64_t)pLeft[pArg->aux]; i++)
+                {
+                    snprintf(path, sizeof(path), "%s[%llu]", name, (unsigned long long)i);
+                    record_compare_uint(&compare, path, record_get_uint((const uint8_t *)pLeft[arg] + (i * pArg->size), pArg->size),
+                                        record_get_uint((const uint8_t *)pRight[arg] + (i * pArg->size), pArg->size));
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return compare.differences;
+}
@@ -0,0 +1,214 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_record.h
+*
+* Recording of HAL calls, and the codec shared with the replay backend (replay/src/mta_hal_replay.c).
+*
+* A recording starts with a header naming every API of the recording build, followed by one record per
+* call: a test_record_header_t, then the outputs of the call. Outputs are encoded field by field, integers
+* as 64 bits and character arrays without their trailing zeros, so that a recording made on a 32 bit
+* device replays on a 64 bit host. Outputs are recorded only for calls returning RETURN_OK; the caller
+* may not read them otherwise.
+*
+* Every record is written with a single write() to a descriptor opened with O_APPEND, so forked tests
+* and threads share one file.
+*/
+
+#ifndef TEST_RECORD_H
+#define TEST_RECORD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TEST_RECORD_MAGIC           "MTAHALRC"
+#define TEST_RECORD_VERSION         (1)
+#define TEST_RECORD_BYTE_ORDER      (0x01020304U)
+#define TEST_RECORD_MAX_ARGS        (3)
+#define TEST_RECORD_STRING_MAX      (1024)      /*!< Longest output string recorded, including the NUL */
+#define TEST_RECORD_TEXT_SIZE       (256)       /*!< Output values and paths reported by test_record_compare() */
+
+/* Fixed part of every record, the outputs follow */
+typedef struct
+{
+    uint32_t length;                /*!< Bytes of the record, including this header */
+    uint16_t api;                   /*!< Index of the API in the name table of the file */
+    uint16_t flags;                 /*!< Reserved, 0 */
+    int64_t result;                 /*!< Return value of the API */
+    uint64_t latencyNs;             /*!< CLOCK_MONOTONIC time inside the API */
+    uint64_t key[TEST_RECORD_MAX_ARGS];     /*!< Scalar arguments of the call, 0 for the others */
+} test_record_header_t;
+
+/*
+ * Array initialiser of the arguments of a call, as listed in mta_hal_api_list.h, followed by a comma:
+ * uintptr_t args[] = { TEST_RECORD_ARGS(arguments) 0 };
+ */
+#define TEST_RECORD_ARG(a)                  (uintptr_t)(a),
+#define TEST_RECORD_ARGS_0(unused)
+#define TEST_RECORD_ARGS_1(unused, a)       TEST_RECORD_ARG(a)
+#define TEST_RECORD_ARGS_2(unused, a, b)    TEST_RECORD_ARG(a) TEST_RECORD_ARG(b)
+#define TEST_RECORD_ARGS_3(unused, a, b, c) TEST_RECORD_ARG(a) TEST_RECORD_ARG(b) TEST_RECORD_ARG(c)
+/* The GNU comma elision of TEST_RECORD_ARGS_PREPEND drops the comma of an empty "()" list, selecting TEST_RECORD_ARGS_0 */
+#define TEST_RECORD_ARGS_PREPEND(...)       , ##__VA_ARGS__
+#define TEST_RECORD_ARGS_SELECT(unused, a, b, c, selected, ...) selected
+#define TEST_RECORD_ARGS_APPLY(...)         TEST_RECORD_ARGS_SELECT(__VA_ARGS__, TEST_RECORD_ARGS_3, TEST_RECORD_ARGS_2, \
+                                                                    TEST_RECORD_ARGS_1, TEST_RECORD_ARGS_0)(__VA_ARGS__)
+#define TEST_RECORD_ARGS(arguments)         TEST_RECORD_ARGS_APPLY(0 TEST_RECORD_ARGS_PREPEND arguments)
+
+/**
+ * @brief Create a recording and start recording every call passing through the probes
+ *
+ * @param[in] pPath - file to write
+ *
+ * @return int - 0 on success, -1 if the file cannot be created
+ */
+int test_record_open(const char *pPath);
+
+/**
+ * @brief Stop recording and close the file
+ */
+void test_record_close(void);
+
+/**
+ * @brief Whether calls are being recorded
+ */
+bool test_record_enabled(void);
+
+/**
+ * @brief Append a call to the recording
+ *
+ * @param[in] api - test_probe_api_t of the call
+ * @param[in] result - return value
+ * @param[in] latencyNs - time inside the API
+ * @param[in] pArgs - arguments, see TEST_RECORD_ARGS()
+ */
+void test_record_call(int api, int64_t result, uint64_t latencyNs, const uintptr_t *pArgs);
+
+/**
+ * @brief Scalar arguments of a call, in the layout of test_record_header_t.key
+ */
+void test_record_key(int api, const uintptr_t *pArgs, uint64_t *pKey);
+
+/**
+ * @brief Check the header of a recording and map its name table to test_probe_api_t
+ *
+ * @param[in] pData - recording
+ * @param[in] size - bytes of the recording
+ * @param[out] pApiMap - test_probe_api_t of each API of the file, TEST_PROBE_API_NONE when unknown to
+ *                       this build; TEST_PROBE_API_COUNT entries, APIs beyond are ignored
+ * @param[out] pApiCount - number of APIs of the file
+ *
+ * @return size_t - offset of the first record, 0 if the file is not a recording this build can read
+ */
+size_t test_record_map(const uint8_t *pData, size_t size, int *pApiMap, int *pApiCount);
+
+/**
+ * @brief Write the recorded outputs of a call to the output arguments of a new call
+ *
+ * Lists are allocated with malloc(), as the HAL would, and released by the caller.
+ *
+ * @param[in] api - test_probe_api_t of the call
+ * @param[in] pOutputs - outputs following the record header
+ * @param[in] length - bytes of pOutputs
+ * @param[in] pArgs - arguments of the new call, see TEST_RECORD_ARGS()
+ *
+ * @return int - 0 on success, -1 if the outputs are truncated
+ */
+int test_record_decode(int api, const uint8_t *pOutputs, size_t length, const uintptr_t *pArgs);
+
+/**
+ * @brief Name of an API in the naming of mta_hal_api_list.h, NULL if out of range
+ */
+const char *test_record_api_name(int api);
+
+/**
+ * @brief Called for each output that differs between two calls
+ *
+ * @param[in] pContext - context given to test_record_compare()
+ * @param[in] pPath - output, e.g. "pInfo.MACAddress" or "(*ppCfg)[2].pDescription"
+ * @param[in] pLeft - value of the first call, as text
+ * @param[in] pRight - value of the second call, as text
+ */
+typedef void (*test_record_difference_fn_t)(void *pContext, const char *pPath, const char *pLeft, const char *pRight);
+
+/**
+ * @brief Whether an API only reads state: every argument is an output or a scalar, and it has an output or
+ *        no argument at all
+ */
+bool test_record_api_is_query(int api);
+
+/**
+ * @brief Number of arguments of an API
+ */
+int test_record_arg_count(int api);
+
+/**
+ * @brief Whether an argument is a pointer the API writes its outputs to
+ */
+bool test_record_arg_is_output(int api, int arg);
+
+/**
+ * @brief Number of integers an output argument points to: 1 for an integer output, the length argument
+ *        for an integer array, capped at the recordable length, 0 for other outputs and scalars
+ */
+uint64_t test_record_arg_elements(int api, int arg, const uintptr_t *pArgs);
+
+/**
+ * @brief Allocate zeroed storage for every output of an API, as a caller would pass it
+ *
+ * @param[in] api - test_probe_api_t
+ * @param[in] value - value of the scalar arguments; array capacities are capped at the recordable length
+ * @param[out] pArgs - TEST_RECORD_MAX_ARGS + 1 arguments, see TEST_RECORD_ARGS()
+ *
+ * @return int - 0 on success, -1 if the API takes an input buffer or memory is short
+ */
+int test_record_args_alloc(int api, uint64_t value, uintptr_t *pArgs);
+
+/**
+ * @brief Release the lists the HAL returned in the storage of test_record_args_alloc(), keeping the storage
+ *        for another call
+ */
+void test_record_args_release(int api, const uintptr_t *pArgs);
+
+/**
+ * @brief Release the storage of test_record_args_alloc(), and the lists the HAL returned in it
+ */
+void test_record_args_free(int api, uintptr_t *pArgs);
+
+/**
+ * @brief Compare the outputs of two calls of an API field by field
+ *
+ * The lengths of returned lists are compared as outputs of their own, and the entries both lists hold
+ * field by field.
+ *
+ * @param[in] api - test_probe_api_t
+ * @param[in] pLeft - arguments of the first call
+ * @param[in] pRight - arguments of the second call
+ * @param[in] pIgnored - names of fields or arguments not compared, e.g. "LeaseTimeRemaining"
+ * @param[in] numIgnored - number of pIgnored entries
+ * @param[in] report - called for each difference, may be NULL
+ * @param[in] pContext - passed to report
+ *
+ * @return int - number of differences
+ */
+int test_record_compare(int api, const uintptr_t *pLeft, const uintptr_t *pRight, const char *const *pIgnored, int numIgnored,
+                        test_record_difference_fn_t report, void *pContext);
+
+#endif /* TEST_RECORD_H */
@@ -18,12 +18,34 @@
 
 /* L1 Testing Functions */
 extern int test_mta_hal_l1_register(void);
+extern int test_mta_hal_l1_alloc_register(void);
+extern int test_mta_hal_l1_spec_register(void);
+
+/* Performance Testing Functions */
+extern int test_mta_hal_perf_replay_register(void);
+extern int test_mta_hal_perf_concurrency_register(void);
+extern int test_mta_hal_perf_logmem_register(void);
+extern int test_mta_hal_perf_heapsoak_register(void);
+extern int test_mta_hal_perf_latency_register(void);
+extern int test_mta_hal_perf_indexsweep_register(void);
+extern int test_mta_hal_perf_fastfail_register(void);
+extern int test_mta_hal_perf_snapshot_register(void);
 
 int register_hal_l1_tests( void )
 {
     int registerFailed=0;
 
     registerFailed |= test_mta_hal_l1_register();
+    registerFailed |= test_mta_hal_l1_alloc_register();
+    registerFailed |= test_mta_hal_l1_spec_register();
+    registerFailed |= test_mta_hal_perf_replay_register();
+    registerFailed |= test_mta_hal_perf_concurrency_register();
+    registerFailed |= test_mta_hal_perf_logmem_register();
+    registerFailed |= test_mta_hal_perf_heapsoak_register();
+    registerFailed |= test_mta_hal_perf_latency_register();
+    registerFailed |= test_mta_hal_perf_indexsweep_register();
+    registerFailed |= test_mta_hal_perf_fastfail_register();
+    registerFailed |= test_mta_hal_perf_snapshot_register();
 
     return registerFailed;
 }
\ No newline at end of file
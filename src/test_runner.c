@@ -0,0 +1,1014 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <ut.h>
+#include <ut_log.h>
+#include <ut_kvp_profile.h>
+#include <CUnit/CUnit.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "test_runner.h"
+#include "test_probe.h"
+#include "test_alloc.h"
+#include "test_trace.h"
+#include "test_counters.h"
+#include "test_record.h"
+#include "test_log.h"
+
+#define TEST_RUNNER_MAX_SUITES      (32)
+#define TEST_RUNNER_MAX_TESTS       (500)
+#define TEST_RUNNER_PATH_SIZE       (256)
+#define TEST_RUNNER_LOG_TEMPLATE    "/tmp/mta_hal_test.XXXXXX"
+#define TEST_RUNNER_POLL_NS         (5000000L)
+#define TEST_RUNNER_KEY_SIZE        (128)
+#define TEST_RUNNER_COUNTERS_LABEL_SIZE (160)
+
+struct test_runner_suite_s
+{
+    const char *pTitle;
+    test_runner_suite_fn_t pInit;
+    test_runner_suite_fn_t pClean;
+    UT_test_suite_t *pUtSuite;      /*!< Created when the first selected test is added */
+    bool exclusive;
+};
+
+typedef struct
+{
+    test_runner_suite_t *pSuite;
+    const char *pTitle;
+    test_runner_test_fn_t pFunction;
+} runner_test_t;
+
+typedef enum
+{
+    RUNNER_SELECT_ALL = 0,  /*!< Register every test with the UT framework */
+    RUNNER_SELECT_NONE,     /*!< Only list the tests */
+    RUNNER_SELECT_ONE       /*!< Register the single test selectIndex */
+} runner_select_t;
+
+/* Resource usage of the process over one test, from getrusage() */
+typedef struct
+{
+    long maxRssKb;                  /*!< Peak resident set size of the process at the end of the test */
+    long rssGrowthKb;               /*!< Growth of the peak during the test */
+    long minorFaults;
+    long majorFaults;
+    long voluntarySwitches;         /*!< Blocking waits, e.g. on IPC */
+    long involuntarySwitches;       /*!< Preemptions */
+} runner_usage_t;
+
+/* Outcome of one test, written by the child process into memory shared with the parent */
+typedef struct
+{
+    volatile int started;
+    volatile int completed;
+    volatile unsigned int failures;
+    test_probe_slot_t probe;        /*!< HAL call in progress, see test_probe.h */
+    runner_usage_t usage;           /*!< Valid when completed */
+    test_counter_sample_t counters; /*!< Hardware counters of the test thread, valid when completed */
+} runner_result_t;
+
+/* Child process of one test, owned by the parent */
+typedef struct
+{
+    pid_t pid;                      /*!< 0 when the test belongs to another shard, negative if fork failed */
+    bool reaped;
+    int waitStatus;
+    uint64_t startNs;
+    uint64_t elapsedNs;
+    bool timedOut;                  /*!< Killed by the watchdog */
+    int timeoutApi;                 /*!< API executing when killed, TEST_PROBE_API_NONE outside the HAL */
+    uint64_t timeoutApiNs;          /*!< Time spent in timeoutApi when killed */
+    int lastApi;
+} runner_child_t;
+
+typedef enum
+{
+    RUNNER_STATUS_PASSED = 0,
+    RUNNER_STATUS_FAILED,
+    RUNNER_STATUS_CRASHED,
+    RUNNER_STATUS_TIMEOUT,
+    RUNNER_STATUS_NOT_RUN,
+    RUNNER_STATUS_COUNT
+} runner_status_t;
+
+static const char *gStatusNames[RUNNER_STATUS_COUNT] = { "PASSED", "FAILED", "CRASHED", "TIMEOUT", "NOT RUN" };
+
+static struct
+{
+    bool fork;
+    int jobs;
+    int shardIndex;                 /*!< Zero based shard run by this instance */
+    int shardCount;                 /*!< Number of shards, 0 when sharding is off */
+    runner_select_t select;
+    int selectIndex;
+    test_runner_suite_t suites[TEST_RUNNER_MAX_SUITES];
+    int numSuites;
+    runner_test_t tests[TEST_RUNNER_MAX_TESTS];
+    int numTests;
+    runner_result_t *pResults;      /*!< Shared with the children in fork mode, NULL otherwise */
+    uint32_t testTimeoutMs;         /*!< Watchdog limit per test, 0 when off */
+    bool testTimeoutSet;            /*!< testTimeoutMs given on the command line */
+    uint32_t apiDefaultTimeoutMs;   /*!< Watchdog limit for HAL calls without their own limit, 0 when off */
+    uint32_t apiTimeoutMs[TEST_PROBE_API_COUNT];    /*!< Watchdog limit per HAL call, 0 when off */
+    bool watchdog;
+    bool halTiming;                 /*!< Time every HAL call, --hal-timing */
+    const char *pHistogramPath;     /*!< Latency histogram file, --hal-histograms, NULL when off */
+    const char *pTracePath;         /*!< Chrome trace file, --trace-json, NULL when off */
+    const char *pRecordPath;        /*!< HAL call recording, --hal-record, NULL when off */
+    bool halCounters;               /*!< Hardware counters per test and per HAL call, --hal-counters, when available */
+    test_log_mode_t logMode;        /*!< Queueing of the UT_LOG_* lines, --log-async */
+    bool traceOpen;                 /*!< The slice of traceIndex is not written yet */
+    int traceIndex;
+    uint64_t traceStartNs;
+} gRunner;
+
+static void runner_invoke(int index);
+
+/*
+ * The UT framework calls test functions without any context, so every registered test is given its own
+ * trampoline which passes the test index to runner_invoke().
+ */
+#define RUNNER_TRAMPOLINE(a,b,c) static void runner_trampoline_##a##b##c(void) { runner_invoke(((a) * 100) + ((b) * 10) + (c)); }
+#define RUNNER_TRAMPOLINE10(a,b) RUNNER_TRAMPOLINE(a,b,0) RUNNER_TRAMPOLINE(a,b,1) RUNNER_TRAMPOLINE(a,b,2) RUNNER_TRAMPOLINE(a,b,3) RUNNER_TRAMPOLINE(a,b,4) \
+                                 RUNNER_TRAMPOLINE(a,b,5) RUNNER_TRAMPOLINE(a,b,6) RUNNER_TRAMPOLINE(a,b,7) RUNNER_TRAMPOLINE(a,b,8) RUNNER_TRAMPOLINE(a,b,9)
+#define RUNNER_TRAMPOLINE100(a)  RUNNER_TRAMPOLINE10(a,0) RUNNER_TRAMPOLINE10(a,1) RUNNER_TRAMPOLINE10(a,2) RUNNER_TRAMPOLINE10(a,3) RUNNER_TRAMPOLINE10(a,4) \
+                                 RUNNER_TRAMPOLINE10(a,5) RUNNER_TRAMPOLINE10(a,6) RUNNER_TRAMPOLINE10(a,7) RUNNER_TRAMPOLINE10(a,8) RUNNER_TRAMPOLINE10(a,9)
+
+#define RUNNER_ENTRY(a,b,c)      runner_trampoline_##a##b##c,
+#define RUNNER_ENTRY10(a,b)      RUNNER_ENTRY(a,b,0) RUNNER_ENTRY(a,b,1) RUNNER_ENTRY(a,b,2) RUNNER_ENTRY(a,b,3) RUNNER_ENTRY(a,b,4) \
+                                 RUNNER_ENTRY(a,b,5) RUNNER_ENTRY(a,b,6) RUNNER_ENTRY(a,b,7) RUNNER_ENTRY(a,b,8) RUNNER_ENTRY(a,b,9)
+#define RUNNER_ENTRY100(a)       RUNNER_ENTRY10(a,0) RUNNER_ENTRY10(a,1) RUNNER_ENTRY10(a,2) RUNNER_ENTRY10(a,3) RUNNER_ENTRY10(a,4) \
+                                 RUNNER_ENTRY10(a,5) RUNNER_ENTRY10(a,6) RUNNER_ENTRY10(a,7) RUNNER_ENTRY10(a,8) RUNNER_ENTRY10(a,9)
+
+RUNNER_TRAMPOLINE100(0)
+RUNNER_TRAMPOLINE100(1)
+RUNNER_TRAMPOLINE100(2)
+RUNNER_TRAMPOLINE100(3)
+RUNNER_TRAMPOLINE100(4)
+
+static const test_runner_test_fn_t gTrampolines[TEST_RUNNER_MAX_TESTS] =
+{
+    RUNNER_ENTRY100(0)
+    RUNNER_ENTRY100(1)
+    RUNNER_ENTRY100(2)
+    RUNNER_ENTRY100(3)
+    RUNNER_ENTRY100(4)
+};
+
+static void runner_usage_delta(runner_usage_t *pUsage, const struct rusage *pBefore, const struct rusage *pAfter)
+{
+    pUsage->maxRssKb = pAfter->ru_maxrss;
+    pUsage->rssGrowthKb = pAfter->ru_maxrss - pBefore->ru_maxrss;
+    pUsage->minorFaults = pAfter->ru_minflt - pBefore->ru_minflt;
+    pUsage->majorFaults = pAfter->ru_majflt - pBefore->ru_majflt;
+    pUsage->voluntarySwitches = pAfter->ru_nvcsw - pBefore->ru_nvcsw;
+    pUsage->involuntarySwitches = pAfter->ru_nivcsw - pBefore->ru_nivcsw;
+}
+
+/*
+ * Write the slice of the test started last as one complete event. A test aborted by a fatal assertion
+ * never returns to runner_invoke(), its slice is written when the runner next has control: at the start
+ * of the following test, or once the tests have run.
+ */
+static void runner_trace_test(void)
+{
+    const runner_test_t *pTest = &gRunner.tests[gRunner.traceIndex];
+
+    if (gRunner.traceOpen == false)
+    {
+        return;
+    }
+    gRunner.traceOpen = false;
+    test_trace_complete(pTest->pTitle, "test", gRunner.traceStartNs, test_probe_now_ns() - gRunner.traceStartNs,
+                        "suite", pTest->pSuite->pTitle);
+}
+
+static void runner_invoke(int index)
+{
+    runner_result_t *pResult = NULL;
+    runner_usage_t usage;
+    struct rusage before;
+    struct rusage after;
+    test_counter_sample_t countersBefore;
+    test_counter_sample_t counters;
+    unsigned int failures;
+
+    if (gRunner.pResults != NULL)
+    {
+        pResult = &gRunner.pResults[index];
+        pResult->started = 1;
+    }
+
+    runner_trace_test();
+    failures = CU_get_number_of_failures();
+    test_alloc_begin_test();
+    if (test_trace_enabled() == true)
+    {
+        gRunner.traceIndex = index;
+        gRunner.traceStartNs = test_probe_now_ns();
+        gRunner.traceOpen = true;
+    }
+    getrusage(RUSAGE_SELF, &before);
+    (void)test_counters_read(&countersBefore);
+    gRunner.tests[index].pFunction();
+    (void)test_counters_read(&counters);
+    getrusage(RUSAGE_SELF, &after);
+    runner_trace_test();
+
+    /* Not reached when a fatal assertion aborts the test */
+    runner_usage_delta(&usage, &before, &after);
+    test_counters_delta(&countersBefore, &counters, &counters);
+    if (pResult != NULL)
+    {
+        pResult->usage = usage;
+        pResult->counters = counters;
+        pResult->failures = CU_get_number_of_failures() - failures;
+        pResult->completed = 1;
+    }
+    else
+    {
+        UT_LOG_INFO("Usage: max RSS %ld KB (+%ld), faults %ld minor %ld major, context switches %ld voluntary %ld involuntary",
+                    usage.maxRssKb, usage.rssGrowthKb, usage.minorFaults, usage.majorFaults,
+                    usage.voluntarySwitches, usage.involuntarySwitches);
+        test_counters_log("Counters", &counters);
+    }
+    test_probe_histograms_poll();
+}
+
+/*
+ * Shards are assigned from a hash of the suite and test titles, so every device computes the same partition
+ * whatever the registration order and whichever optional tests the profile enables.
+ */
+static bool runner_in_shard(int index)
+{
+    const char *pText;
+    uint32_t hash = 2166136261U;    /* FNV-1a */
+
+    if (gRunner.shardCount <= 1)
+    {
+        return true;
+    }
+    for (pText = gRunner.tests[index].pSuite->pTitle; *pText != '\0'; pText++)
+    {
+        hash = (hash ^ (uint8_t)*pText) * 16777619U;
+    }
+    hash = (hash ^ (uint8_t)'/') * 16777619U;
+    for (pText = gRunner.tests[index].pTitle; *pText != '\0'; pText++)
+    {
+        hash = (hash ^ (uint8_t)*pText) * 16777619U;
+    }
+    return ((int)(hash % (uint32_t)gRunner.shardCount) == gRunner.shardIndex);
+}
+
+static int runner_count_in_shard(void)
+{
+    int i;
+    int count = 0;
+
+    for (i = 0; i < gRunner.numTests; i++)
+    {
+        if (runner_in_shard(i) == true)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static bool runner_is_selected(int index)
+{
+    switch (gRunner.select)
+    {
+        case RUNNER_SELECT_ALL:
+            return runner_in_shard(index);
+        case RUNNER_SELECT_ONE:
+            return (index == gRunner.selectIndex);
+        default:
+            return false;
+    }
+}
+
+static void runner_reset(void)
+{
+    memset(gRunner.suites, 0, sizeof(gRunner.suites));
+    memset(gRunner.tests, 0, sizeof(gRunner.tests));
+    gRunner.numSuites = 0;
+    gRunner.numTests = 0;
+}
+
+int test_runner_parse_args(int *pArgc, char **argv)
+{
+    const char *pValue;
+    char *pEnd;
+    unsigned long timeoutMs;
+    int in;
+    int out = 1;
+    long cpus;
+
+    for (in = 1; in < *pArgc; in++)
+    {
+        if (strcmp(argv[in], "--fork") == 0)
+        {
+            gRunner.fork = true;
+            gRunner.jobs = 1;
+        }
+        else if (strcmp(argv[in], "--jobs") == 0)
+        {
+            cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            gRunner.fork = true;
+            gRunner.jobs = (cpus > 0) ? (int)cpus : 1;
+        }
+        else if (strncmp(argv[in], "--jobs=", strlen("--jobs=")) == 0)
+        {
+            gRunner.fork = true;
+            gRunner.jobs = atoi(argv[in] + strlen("--jobs="));
+            if (gRunner.jobs <= 0)
+            {
+                printf("Invalid value for %s\n", argv[in]);
+                return -1;
+            }
+        }
+        else if (strncmp(argv[in], "--shard=", strlen("--shard=")) == 0)
+        {
+            if ((sscanf(argv[in] + strlen("--shard="), "%d/%d", &gRunner.shardIndex, &gRunner.shardCount) != 2) ||
+                (gRunner.shardCount <= 0) || (gRunner.shardIndex < 1) || (gRunner.shardIndex > gRunner.shardCount))
+            {
+                printf("Invalid value for %s, expected --shard=i/n with 1 <= i <= n\n", argv[in]);
+                return -1;
+            }
+            gRunner.shardIndex--;
+        }
+        else if (strcmp(argv[in], "--hal-timing") == 0)
+        {
+            gRunner.halTiming = true;
+        }
+        else if (strncmp(argv[in], "--hal-histograms=", strlen("--hal-histograms=")) == 0)
+        {
+            gRunner.pHistogramPath = argv[in] + strlen("--hal-histograms=");
+            if (gRunner.pHistogramPath[0] == '\0')
+            {
+                printf("Invalid value for %s, expected --hal-histograms=file\n", argv[in]);
+                return -1;
+            }
+        }
+        else if (strncmp(argv[in], "--trace-json=", strlen("--trace-json=")) == 0)
+        {
+            gRunner.pTracePath = argv[in] + strlen("--trace-json=");
+            if (gRunner.pTracePath[0] == '\0')
+            {
+                printf("Invalid value for %s, expected --trace-json=file\n", argv[in]);
+                return -1;
+            }
+        }
+        else if (strncmp(argv[in], "--hal-record=", strlen("--hal-record=")) == 0)
+        {
+            gRunner.pRecordPath = argv[in] + strlen("--hal-record=");
+            if (gRunner.pRecordPath[0] == '\0')
+            {
+                printf("Invalid value for %s, expected --hal-record=file\n", argv[in]);
+                return -1;
+            }
+        }
+        else if (strcmp(argv[in], "--hal-counters") == 0)
+        {
+            gRunner.halCounters = true;
+        }
+        else if (strcmp(argv[in], "--log-async") == 0)
+        {
+            gRunner.logMode = TEST_LOG_BACKGROUND;
+        }
+        else if (strcmp(argv[in], "--log-async=deferred") == 0)
+        {
+            gRunner.logMode = TEST_LOG_DEFERRED;
+        }
+        else if (strncmp(argv[in], "--timeout=", strlen("--timeout=")) == 0)
+        {
+            pValue = argv[in] + strlen("--timeout=");
+            errno = 0;
+            timeoutMs = strtoul(pValue, &pEnd, 10);
+            if ((isdigit((unsigned char)pValue[0]) == 0) || (*pEnd != '\0') || (errno != 0) || (timeoutMs > UINT32_MAX))
+            {
+                printf("Invalid value for %s, expected --timeout=ms\n", argv[in]);
+                return -1;
+            }
+            gRunner.testTimeoutMs = (uint32_t)timeoutMs;
+            gRunner.testTimeoutSet = true;
+        }
+        else
+        {
+            argv[out++] = argv[in];
+        }
+    }
+    argv[out] = NULL;
+    *pArgc = out;
+    return 0;
+}
+
+test_runner_suite_t *test_runner_add_suite(const char *pTitle, test_runner_suite_fn_t pInit, test_runner_suite_fn_t pClean)
+{
+    test_runner_suite_t *pSuite;
+
+    if (gRunner.numSuites >= TEST_RUNNER_MAX_SUITES)
+    {
+        UT_LOG_ERROR("Too many suites, [%s] not added", pTitle);
+        return NULL;
+    }
+    pSuite = &gRunner.suites[gRunner.numSuites++];
+    pSuite->pTitle = pTitle;
+    pSuite->pInit = pInit;
+    pSuite->pClean = pClean;
+    pSuite->pUtSuite = NULL;
+    pSuite->exclusive = false;
+    return pSuite;
+}
+
+void test_runner_suite_exclusive(test_runner_suite_t *pSuite)
+{
+    if (pSuite != NULL)
+    {
+        pSuite->exclusive = true;
+    }
+}
+
+int test_runner_add_test(test_runner_suite_t *pSuite, const char *pTitle, test_runner_test_fn_t pFunction)
+{
+    int index;
+
+    if ((pSuite == NULL) || (pFunction == NULL))
+    {
+        return -1;
+    }
+    if (gRunner.numTests >= TEST_RUNNER_MAX_TESTS)
+    {
+        UT_LOG_ERROR("Too many tests, [%s] not added", pTitle);
+        return -1;
+    }
+
+    index = gRunner.numTests++;
+    gRunner.tests[index].pSuite = pSuite;
+    gRunner.tests[index].pTitle = pTitle;
+    gRunner.tests[index].pFunction = pFunction;
+
+    if (runner_is_selected(index) == false)
+    {
+        return 0;
+    }
+
+    if (pSuite->pUtSuite == NULL)
+    {
+        pSuite->pUtSuite = UT_add_suite(pSuite->pTitle, pSuite->pInit, pSuite->pClean);
+        if (pSuite->pUtSuite == NULL)
+        {
+            return -1;
+        }
+    }
+    UT_add_test(pSuite->pUtSuite, pTitle, gTrampolines[index]);
+    return 0;
+}
+
+static void runner_log_path(char *pPath, size_t size, const char *pDir, int index)
+{
+    snprintf(pPath, size, "%s/%03d.log", pDir, index);
+}
+
+/* Runs in the child process, never returns */
+static void runner_child(test_runner_register_fn_t registerFunction, int index, const char *pLogPath)
+{
+    int fd;
+
+    fd = open(pLogPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        /* A file is fully buffered: the last lines of a child killed by the watchdog or a signal would be lost */
+        setvbuf(stdout, NULL, _IOLBF, 0);
+    }
+
+    /* The sink of the parent stopped at the fork */
+    test_log_start(gRunner.logMode);
+    test_probe_attach(&gRunner.pResults[index].probe);
+    test_trace_process_name(gRunner.tests[index].pTitle);
+    runner_reset();
+    gRunner.select = RUNNER_SELECT_ONE;
+    gRunner.selectIndex = index;
+    if (registerFunction() == 0)
+    {
+        UT_run_tests();
+        runner_trace_test();
+        test_alloc_report();
+    }
+    test_log_stop();
+    fflush(NULL);
+    _exit(0);
+}
+
+static runner_status_t runner_status(const runner_result_t *pResult, const runner_child_t *pChild)
+{
+    if (pChild->pid < 0)
+    {
+        return RUNNER_STATUS_NOT_RUN;
+    }
+    if (pChild->timedOut == true)
+    {
+        return RUNNER_STATUS_TIMEOUT;
+    }
+    if (WIFSIGNALED(pChild->waitStatus))
+    {
+        return RUNNER_STATUS_CRASHED;
+    }
+    if (pResult->started == 0)
+    {
+        return RUNNER_STATUS_NOT_RUN;
+    }
+    if ((pResult->completed == 0) || (pResult->failures > 0))
+    {
+        return RUNNER_STATUS_FAILED;
+    }
+    return RUNNER_STATUS_PASSED;
+}
+
+/* Append the output of every child to stdout in registration order */
+static void runner_merge_logs(const char *pDir, int numTests)
+{
+    char path[TEST_RUNNER_PATH_SIZE];
+    char buffer[4096];
+    size_t length;
+    FILE *pFile;
+    int i;
+
+    for (i = 0; i < numTests; i++)
+    {
+        runner_log_path(path, sizeof(path), pDir, i);
+        pFile = fopen(path, "r");
+        if (pFile == NULL)
+        {
+            continue;
+        }
+        printf("\n==== %s / %s ====\n", gRunner.tests[i].pSuite->pTitle, gRunner.tests[i].pTitle);
+        while ((length = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        {
+            fwrite(buffer, 1, length, stdout);
+        }
+        fclose(pFile);
+        unlink(path);
+    }
+    rmdir(pDir);
+}
+
+static void runner_print_shard(int numSelected, int numTests)
+{
+    if (gRunner.shardCount > 1)
+    {
+        printf("Shard %d/%d: %d of %d tests\n", gRunner.shardIndex + 1, gRunner.shardCount, numSelected, numTests);
+    }
+}
+
+/*
+ * Watchdog limits come from the profile, mta.timeouts.testMs and mta.timeouts.apiMs, with per API overrides in
+ * mta.timeouts.api.<name>. --timeout=ms on the command line takes precedence over mta.timeouts.testMs.
+ */
+static void runner_load_timeouts(void)
+{
+    char key[TEST_RUNNER_KEY_SIZE];
+    uint32_t value;
+    int api;
+
+    if (gRunner.testTimeoutSet == false)
+    {
+        gRunner.testTimeoutMs = UT_KVP_PROFILE_GET_UINT32("mta.timeouts.testMs");
+    }
+    gRunner.apiDefaultTimeoutMs = UT_KVP_PROFILE_GET_UINT32("mta.timeouts.apiMs");
+    gRunner.watchdog = (gRunner.testTimeoutMs > 0);
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        snprintf(key, sizeof(key), "mta.timeouts.api.%s", test_probe_api_name(api));
+        value = UT_KVP_PROFILE_GET_UINT32(key);
+        gRunner.apiTimeoutMs[api] = (value > 0) ? value : gRunner.apiDefaultTimeoutMs;
+        if (gRunner.apiTimeoutMs[api] > 0)
+        {
+            gRunner.watchdog = true;
+        }
+    }
+}
+
+/* Check a running test against its limits, returns true when it has to be killed */
+static bool runner_watchdog_expired(int index, runner_child_t *pChild, uint64_t nowNs)
+{
+    const test_probe_slot_t *pProbe = &gRunner.pResults[index].probe;
+    int api = pProbe->api;
+    uint64_t enterNs = pProbe->enterNs;
+    bool expired = false;
+
+    if ((gRunner.testTimeoutMs > 0) && ((nowNs - pChild->startNs) >= ((uint64_t)gRunner.testTimeoutMs * 1000000ULL)))
+    {
+        expired = true;
+    }
+    if ((api >= 0) && (api < TEST_PROBE_API_COUNT) && (gRunner.apiTimeoutMs[api] > 0) &&
+        (enterNs > 0) && (nowNs > enterNs) && ((nowNs - enterNs) >= ((uint64_t)gRunner.apiTimeoutMs[api] * 1000000ULL)))
+    {
+        expired = true;
+    }
+    if (expired == true)
+    {
+        pChild->timeoutApi = ((api >= 0) && (api < TEST_PROBE_API_COUNT)) ? api : TEST_PROBE_API_NONE;
+        pChild->timeoutApiNs = ((pChild->timeoutApi != TEST_PROBE_API_NONE) && (nowNs > enterNs)) ? (nowNs - enterNs) : 0;
+        pChild->lastApi = pProbe->lastApi;
+    }
+    return expired;
+}
+
+static void runner_print_timeout(const runner_child_t *pChild)
+{
+    if (pChild->timeoutApi != TEST_PROBE_API_NONE)
+    {
+        printf("  (killed in %s after %llu ms)", test_probe_api_name(pChild->timeoutApi),
+               (unsigned long long)(pChild->timeoutApiNs / 1000000ULL));
+    }
+    else
+    {
+        printf("  (killed outside the HAL, last call %s)", test_probe_api_name(pChild->lastApi));
+    }
+}
+
+static int runner_run_forked(test_runner_register_fn_t registerFunction)
+{
+    char logDir[] = TEST_RUNNER_LOG_TEMPLATE;
+    char path[TEST_RUNNER_PATH_SIZE];
+    runner_child_t children[TEST_RUNNER_MAX_TESTS];
+    int counts[RUNNER_STATUS_COUNT] = { 0 };
+    struct timespec poll = { 0, TEST_RUNNER_POLL_NS };
+    int numTests;
+    int numSelected;
+    int next = 0;
+    int running = 0;
+    bool exclusiveRunning = false;
+    runner_status_t status;
+    const runner_usage_t *pUsage;
+    test_probe_timing_t *pTiming = NULL;
+    test_histogram_t *pHistograms = NULL;
+    test_counter_totals_t *pCounters = NULL;
+    char label[TEST_RUNNER_COUNTERS_LABEL_SIZE];
+    uint64_t nowNs;
+    pid_t pid;
+    int wstatus;
+    int i;
+
+    /* List the tests without registering any of them with the UT framework */
+    runner_reset();
+    gRunner.select = RUNNER_SELECT_NONE;
+    if (registerFunction() != 0)
+    {
+        return -1;
+    }
+    numTests = gRunner.numTests;
+    numSelected = runner_count_in_shard();
+    memset(children, 0, sizeof(children));
+
+    gRunner.pResults = mmap(NULL, sizeof(runner_result_t) * TEST_RUNNER_MAX_TESTS, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (gRunner.pResults == MAP_FAILED)
+    {
+        gRunner.pResults = NULL;
+        printf("Unable to map shared results: %s\n", strerror(errno));
+        return -1;
+    }
+    memset(gRunner.pResults, 0, sizeof(runner_result_t) * TEST_RUNNER_MAX_TESTS);
+
+    if (mkdtemp(logDir) == NULL)
+    {
+        printf("Unable to create log directory: %s\n", strerror(errno));
+        munmap(gRunner.pResults, sizeof(runner_result_t) * TEST_RUNNER_MAX_TESTS);
+        gRunner.pResults = NULL;
+        return -1;
+    }
+
+    if (gRunner.halTiming == true)
+    {
+        pTiming = mmap(NULL, sizeof(test_probe_timing_t) * TEST_PROBE_API_COUNT, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (pTiming == MAP_FAILED)
+        {
+            printf("Unable to map shared timing table: %s\n", strerror(errno));
+            pTiming = NULL;
+        }
+        else
+        {
+            memset(pTiming, 0, sizeof(test_probe_timing_t) * TEST_PROBE_API_COUNT);
+            test_probe_timing_start(pTiming);
+        }
+    }
+
+    if (gRunner.pHistogramPath != NULL)
+    {
+        pHistograms = mmap(NULL, sizeof(test_histogram_t) * TEST_PROBE_API_COUNT, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (pHistograms == MAP_FAILED)
+        {
+            printf("Unable to map shared histograms: %s\n", strerror(errno));
+            pHistograms = NULL;
+        }
+        else
+        {
+            memset(pHistograms, 0, sizeof(test_histogram_t) * TEST_PROBE_API_COUNT);
+            test_probe_histograms_start(pHistograms, gRunner.pHistogramPath);
+        }
+    }
+
+    if (gRunner.halCounters == true)
+    {
+        pCounters = mmap(NULL, sizeof(test_counter_totals_t) * TEST_PROBE_API_COUNT, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (pCounters == MAP_FAILED)
+        {
+            printf("Unable to map shared counters: %s\n", strerror(errno));
+            pCounters = NULL;
+        }
+        else
+        {
+            memset(pCounters, 0, sizeof(test_counter_totals_t) * TEST_PROBE_API_COUNT);
+            test_probe_counters_start(pCounters);
+        }
+    }
+
+    printf("\nRunning %d of %d tests forked, %d in parallel\n", numSelected, numTests, gRunner.jobs);
+    runner_print_shard(numSelected, numTests);
+    if (gRunner.watchdog == true)
+    {
+        printf("Watchdog: test timeout %u ms, default HAL call timeout %u ms\n", gRunner.testTimeoutMs,
+               gRunner.apiDefaultTimeoutMs);
+    }
+
+    while ((next < numTests) || (running > 0))
+    {
+        test_probe_histograms_poll();
+        while ((next < numTests) && (running < gRunner.jobs) && (exclusiveRunning == false))
+        {
+            if (runner_in_shard(next) == false)
+            {
+                next++;
+                continue;
+            }
+            if ((gRunner.tests[next].pSuite->exclusive == true) && (running > 0))
+            {
+                /* Wait for the running tests to drain */
+                break;
+            }
+
+            gRunner.pResults[next].probe.api = TEST_PROBE_API_NONE;
+            gRunner.pResults[next].probe.lastApi = TEST_PROBE_API_NONE;
+            runner_log_path(path, sizeof(path), logDir, next);
+            fflush(NULL);
+            pid = fork();
+            if (pid == 0)
+            {
+                runner_child(registerFunction, next, path);
+            }
+            children[next].pid = pid;
+            children[next].startNs = test_probe_now_ns();
+            children[next].timeoutApi = TEST_PROBE_API_NONE;
+            children[next].lastApi = TEST_PROBE_API_NONE;
+            if (pid < 0)
+            {
+                printf("Unable to fork for %s: %s\n", gRunner.tests[next].pTitle, strerror(errno));
+            }
+            else
+            {
+                running++;
+                exclusiveRunning = gRunner.tests[next].pSuite->exclusive;
+            }
+            next++;
+        }
+
+        if (running == 0)
+        {
+            continue;
+        }
+
+        /* With the watchdog active the children are polled, so that a hung test can be killed */
+        pid = waitpid(-1, &wstatus, (gRunner.watchdog == true) ? WNOHANG : 0);
+        if (pid < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        if (pid == 0)
+        {
+            nowNs = test_probe_now_ns();
+            for (i = 0; i < next; i++)
+            {
+                if ((children[i].pid > 0) && (children[i].reaped == false) && (children[i].timedOut == false) &&
+                    (runner_watchdog_expired(i, &children[i], nowNs) == true))
+                {
+                    children[i].timedOut = true;
+                    kill(children[i].pid, SIGKILL);
+                }
+            }
+            nanosleep(&poll, NULL);
+            continue;
+        }
+        for (i = 0; i < next; i++)
+        {
+            if (children[i].pid == pid)
+            {
+                children[i].reaped = true;
+                children[i].waitStatus = wstatus;
+                children[i].elapsedNs = test_probe_now_ns() - children[i].startNs;
+                if (gRunner.tests[i].pSuite->exclusive == true)
+                {
+                    exclusiveRunning = false;
+                }
+                running--;
+                break;
+            }
+        }
+    }
+
+    runner_merge_logs(logDir, numTests);
+
+    printf("\n%-4s %-24s %-56s %-8s %10s %10s %8s %8s %8s %8s\n", "#", "Suite", "Test", "Result", "Wall ms",
+           "MaxRSS KB", "MinFlt", "MajFlt", "VolCsw", "InvCsw");
+    for (i = 0; i < numTests; i++)
+    {
+        if (children[i].pid == 0)
+        {
+            /* Belongs to another shard */
+            continue;
+        }
+        status = runner_status(&gRunner.pResults[i], &children[i]);
+        counts[status]++;
+        printf("%-4d %-24s %-56s %-8s %10llu", i, gRunner.tests[i].pSuite->pTitle, gRunner.tests[i].pTitle,
+               gStatusNames[status], (unsigned long long)(children[i].elapsedNs / 1000000ULL));
+        if (gRunner.pResults[i].completed != 0)
+        {
+            pUsage = &gRunner.pResults[i].usage;
+            printf(" %10ld %8ld %8ld %8ld %8ld", pUsage->maxRssKb, pUsage->minorFaults, pUsage->majorFaults,
+                   pUsage->voluntarySwitches, pUsage->involuntarySwitches);
+        }
+        else
+        {
+            printf(" %10s %8s %8s %8s %8s", "-", "-", "-", "-", "-");
+        }
+        if (status == RUNNER_STATUS_CRASHED)
+        {
+            printf("  (signal %d, %s)", WTERMSIG(children[i].waitStatus), strsignal(WTERMSIG(children[i].waitStatus)));
+        }
+        else if (status == RUNNER_STATUS_TIMEOUT)
+        {
+            runner_print_timeout(&children[i]);
+        }
+        printf("\n");
+    }
+    printf("\nRun Summary: %d tests, %d passed, %d failed, %d crashed, %d timed out, %d not run\n", numSelected,
+           counts[RUNNER_STATUS_PASSED], counts[RUNNER_STATUS_FAILED], counts[RUNNER_STATUS_CRASHED],
+           counts[RUNNER_STATUS_TIMEOUT], counts[RUNNER_STATUS_NOT_RUN]);
+
+    if (pCounters != NULL)
+    {
+        for (i = 0; i < numTests; i++)
+        {
+            if ((children[i].pid != 0) && (gRunner.pResults[i].completed != 0))
+            {
+                snprintf(label, sizeof(label), "Counters of %d %s", i, gRunner.tests[i].pTitle);
+                test_counters_log(label, &gRunner.pResults[i].counters);
+            }
+        }
+        test_probe_counters_report();
+        munmap(pCounters, sizeof(test_counter_totals_t) * TEST_PROBE_API_COUNT);
+    }
+    if (pTiming != NULL)
+    {
+        test_probe_timing_report();
+        munmap(pTiming, sizeof(test_probe_timing_t) * TEST_PROBE_API_COUNT);
+    }
+    if (pHistograms != NULL)
+    {
+        test_probe_histograms_write();
+        printf("HAL latency histograms written to %s\n", gRunner.pHistogramPath);
+        munmap(pHistograms, sizeof(test_histogram_t) * TEST_PROBE_API_COUNT);
+    }
+
+    munmap(gRunner.pResults, sizeof(runner_result_t) * TEST_RUNNER_MAX_TESTS);
+    gRunner.pResults = NULL;
+    return 0;
+}
+
+static int runner_run(test_runner_register_fn_t registerFunction)
+{
+    if ((gRunner.watchdog == true) && (gRunner.fork == false))
+    {
+        /* A hung HAL call can only be abandoned by killing the process making it */
+        printf("Watchdog enabled, running tests forked\n");
+        gRunner.fork = true;
+        gRunner.jobs = 1;
+    }
+
+    if (gRunner.fork == true)
+    {
+        return runner_run_forked(registerFunction);
+    }
+
+    runner_reset();
+    gRunner.select = RUNNER_SELECT_ALL;
+    if (registerFunction() != 0)
+    {
+        return -1;
+    }
+    runner_print_shard(runner_count_in_shard(), gRunner.numTests);
+    if (gRunner.halTiming == true)
+    {
+        test_probe_timing_start(NULL);
+    }
+    if (gRunner.pHistogramPath != NULL)
+    {
+        test_probe_histograms_start(NULL, gRunner.pHistogramPath);
+    }
+    if (gRunner.halCounters == true)
+    {
+        test_probe_counters_start(NULL);
+    }
+    UT_run_tests();
+    runner_trace_test();
+    test_alloc_report();
+    test_probe_timing_report();
+    test_probe_counters_report();
+    if (gRunner.pHistogramPath != NULL)
+    {
+        test_probe_histograms_write();
+        UT_LOG_INFO("HAL latency histograms written to %s", gRunner.pHistogramPath);
+    }
+    return 0;
+}
+
+int test_runner_run(test_runner_register_fn_t registerFunction)
+{
+    int result;
+
+    runner_load_timeouts();
+    test_alloc_load_budgets();
+    if (gRunner.halCounters == true)
+    {
+        /* Not an error, the run goes on without counters where the kernel or the container denies them */
+        gRunner.halCounters = test_counters_start();
+    }
+    if (gRunner.pTracePath != NULL)
+    {
+        if (test_trace_open(gRunner.pTracePath) != 0)
+        {
+            printf("Unable to create trace file %s: %s\n", gRunner.pTracePath, strerror(errno));
+            return -1;
+        }
+    }
+    if (gRunner.pRecordPath != NULL)
+    {
+        if (test_record_open(gRunner.pRecordPath) != 0)
+        {
+            printf("Unable to create recording %s: %s\n", gRunner.pRecordPath, strerror(errno));
+            test_trace_close();
+            return -1;
+        }
+    }
+    test_log_start(gRunner.logMode);
+    result = runner_run(registerFunction);
+    test_log_stop();
+    if (gRunner.pRecordPath != NULL)
+    {
+        test_record_close();
+        printf("HAL calls recorded to %s\n", gRunner.pRecordPath);
+    }
+    if (gRunner.pTracePath != NULL)
+    {
+        test_trace_close();
+        printf("Trace written to %s\n", gRunner.pTracePath);
+    }
+    return result;
+}
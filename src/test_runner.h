@@ -0,0 +1,103 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_runner.h
+*
+* Test registration and execution layer on top of the UT framework.
+*
+* Suites and tests are registered through this layer instead of directly with UT_add_suite() and
+* UT_add_test(). The runner keeps its own ordered list of every test, which lets it select a subset
+* of the tests for a run and execute each test in its own forked process, optionally in parallel.
+*
+* Runner switches are taken from the command line before it is handed to UT_init():
+*
+* | Switch | Description |
+* | :----- | :---------- |
+* | --fork | Run every test in its own child process, one at a time |
+* | --jobs=N | As --fork, with up to N tests in parallel. Without a value, one per online CPU |
+* | --shard=i/n | Run only shard i (1 to n) of n, the partition is derived from the suite and test titles |
+* | --hal-timing | Measure wall and thread CPU time of every HAL call and label each API compute-bound or blocking |
+* | --hal-histograms=file | Record a latency histogram per HAL API, written to file at exit and on SIGUSR1 |
+* | --trace-json=file | Write a Chrome trace of the run: a slice per test and per HAL call, and callback flows |
+* | --hal-record=file | Record every HAL call with its outputs and latency, for the replay backend of replay/src |
+* | --hal-counters | Count cycles, instructions, cache and branch misses per test and per HAL call, where perf_event_open() is allowed |
+* | --log-async | Queue the UT_LOG_* lines of every thread and format them on a background thread, see test_log.h |
+* | --log-async=deferred | As --log-async, the lines are formatted when the run ends |
+* | --timeout=ms | Kill any test running for longer than ms, overrides mta.timeouts.testMs of the profile |
+*
+* When a test or HAL call timeout is set, in the profile or with --timeout, the tests are run forked and a
+* watchdog kills any test exceeding a limit. The test is reported as TIMEOUT with the HAL call it was in,
+* taken from the call probes of test_probe.h, and the run continues with the next test.
+*/
+
+#ifndef TEST_RUNNER_H
+#define TEST_RUNNER_H
+
+typedef void (*test_runner_test_fn_t)(void);
+typedef int (*test_runner_suite_fn_t)(void);
+typedef int (*test_runner_register_fn_t)(void);
+
+typedef struct test_runner_suite_s test_runner_suite_t;
+
+/**
+ * @brief Take the runner switches out of the command line
+ *
+ * Must be called before UT_init(). Recognised switches are removed from argv and argc is updated.
+ *
+ * @param[in,out] pArgc - argument count
+ * @param[in,out] argv - argument vector
+ *
+ * @return int - 0 on success, -1 on an invalid switch value
+ */
+int test_runner_parse_args(int *pArgc, char **argv);
+
+/**
+ * @brief Add a suite, replaces UT_add_suite()
+ *
+ * The underlying UT suite is created on demand when the first selected test is added to it.
+ *
+ * @return test_runner_suite_t* - suite handle, NULL on failure
+ */
+test_runner_suite_t *test_runner_add_suite(const char *pTitle, test_runner_suite_fn_t pInit, test_runner_suite_fn_t pClean);
+
+/**
+ * @brief Mark a suite as exclusive
+ *
+ * Tests of an exclusive suite never run at the same time as any other test when tests are executed
+ * in parallel. Benchmarks must be exclusive so that concurrent tests do not disturb their timing.
+ */
+void test_runner_suite_exclusive(test_runner_suite_t *pSuite);
+
+/**
+ * @brief Add a test to a suite, replaces UT_add_test()
+ *
+ * @return int - 0 on success, -1 on failure
+ */
+int test_runner_add_test(test_runner_suite_t *pSuite, const char *pTitle, test_runner_test_fn_t pFunction);
+
+/**
+ * @brief Register the tests and run them, in process or forked as selected on the command line
+ *
+ * @param[in] registerFunction - function registering all suites through this layer
+ *
+ * @return int - 0 on success, -1 if registration failed
+ */
+int test_runner_run(test_runner_register_fn_t registerFunction);
+
+#endif /* TEST_RUNNER_H */
@@ -0,0 +1,146 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "test_trace.h"
+
+#define TRACE_EVENT_SIZE        (512)
+#define TRACE_TEXT_SIZE         (160)
+
+static int gFd = -1;
+
+static void trace_escape(char *pOut, size_t size, const char *pText)
+{
+    size_t used = 0;
+
+    while ((*pText != '\0') && ((used + 2) < size))
+    {
+        if ((*pText == '"') || (*pText == '\\'))
+        {
+            pOut[used++] = '\\';
+        }
+        pOut[used++] = ((unsigned char)*pText < 0x20) ? ' ' : *pText;
+        pText++;
+    }
+    pOut[used] = '\0';
+}
+
+static double trace_us(uint64_t ns)
+{
+    return (double)ns / 1000.0;
+}
+
+/* Every event ends with a comma, test_trace_close() terminates the array with an event that does not */
+static void trace_event(const char *pFormat, ...)
+{
+    char event[TRACE_EVENT_SIZE];
+    va_list args;
+    int length;
+
+    va_start(args, pFormat);
+    length = vsnprintf(event, sizeof(event) - 2, pFormat, args);
+    va_end(args);
+    if ((length <= 0) || (length >= (int)(sizeof(event) - 2)))
+    {
+        return;
+    }
+    event[length++] = ',';
+    event[length++] = '\n';
+    (void)write(gFd, event, (size_t)length);
+}
+
+int test_trace_open(const char *pPath)
+{
+    gFd = open(pPath, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (gFd < 0)
+    {
+        return -1;
+    }
+    (void)write(gFd, "[\n", 2);
+    return 0;
+}
+
+void test_trace_close(void)
+{
+    char event[TRACE_EVENT_SIZE];
+    int length;
+
+    if (gFd < 0)
+    {
+        return;
+    }
+    length = snprintf(event, sizeof(event), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"mta_hal_test\"}}\n]\n",
+                      (int)getpid());
+    (void)write(gFd, event, (size_t)length);
+    close(gFd);
+    gFd = -1;
+}
+
+bool test_trace_enabled(void)
+{
+    return (gFd >= 0);
+}
+
+void test_trace_process_name(const char *pName)
+{
+    char name[TRACE_TEXT_SIZE];
+
+    if (gFd < 0)
+    {
+        return;
+    }
+    trace_escape(name, sizeof(name), pName);
+    trace_event("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}", (int)getpid(), name);
+}
+
+void test_trace_complete(const char *pName, const char *pCategory, uint64_t startNs, uint64_t durationNs,
+                         const char *pArgName, const char *pArgValue)
+{
+    char name[TRACE_TEXT_SIZE];
+    char value[TRACE_TEXT_SIZE];
+
+    if (gFd < 0)
+    {
+        return;
+    }
+    trace_escape(name, sizeof(name), pName);
+    if (pArgName == NULL)
+    {
+        trace_event("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld}", name, pCategory,
+                    trace_us(startNs), trace_us(durationNs), (int)getpid(), (long)syscall(SYS_gettid));
+        return;
+    }
+    trace_escape(value, sizeof(value), pArgValue);
+    trace_event("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld,\"args\":{\"%s\":\"%s\"}}",
+                name, pCategory, trace_us(startNs), trace_us(durationNs), (int)getpid(), (long)syscall(SYS_gettid), pArgName, value);
+}
+
+void test_trace_flow(char phase, uint64_t id, const char *pName, uint64_t timeNs)
+{
+    if (gFd < 0)
+    {
+        return;
+    }
+    trace_event("{\"name\":\"%s\",\"cat\":\"flow\",\"ph\":\"%c\",\"id\":%llu,\"ts\":%.3f,\"pid\":%d,\"tid\":%ld}", pName, phase,
+                (unsigned long long)id, trace_us(timeNs), (int)getpid(), (long)syscall(SYS_gettid));
+}
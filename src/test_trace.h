@@ -0,0 +1,87 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file test_trace.h
+*
+* Timeline export in the Chrome trace event format (JSON array), which chrome://tracing and
+* ui.perfetto.dev open directly.
+*
+* The runner writes a slice per test and the call probes a slice per HAL call, on the thread that made
+* it; the viewer nests the HAL calls inside the test from their times. Every event is written with a
+* single write() to a descriptor opened with O_APPEND, so forked tests and threads share one file.
+* Timestamps are CLOCK_MONOTONIC, in microseconds.
+*/
+
+#ifndef TEST_TRACE_H
+#define TEST_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Create the trace file and start tracing
+ *
+ * @param[in] pPath - file to write
+ *
+ * @return int - 0 on success, -1 if the file cannot be created
+ */
+int test_trace_open(const char *pPath);
+
+/**
+ * @brief Terminate the JSON array and close the file, called once by the process that opened it
+ */
+void test_trace_close(void);
+
+/**
+ * @brief Whether events are being written
+ */
+bool test_trace_enabled(void);
+
+/**
+ * @brief Name the calling process in the viewer
+ */
+void test_trace_process_name(const char *pName);
+
+/**
+ * @brief Write a slice of the calling thread whose start and duration are known
+ *
+ * A single complete event, so that a slice whose end is never reached, such as a test aborted by a fatal
+ * assertion, cannot stay open to the end of the trace.
+ *
+ * @param[in] pName - slice name
+ * @param[in] pCategory - event category
+ * @param[in] startNs - CLOCK_MONOTONIC start time
+ * @param[in] durationNs - duration
+ * @param[in] pArgName - name of an argument shown with the slice, NULL for none
+ * @param[in] pArgValue - value of the argument
+ */
+void test_trace_complete(const char *pName, const char *pCategory, uint64_t startNs, uint64_t durationNs,
+                         const char *pArgName, const char *pArgValue);
+
+/**
+ * @brief Write a flow event, binding the slice of the calling thread enclosing timeNs to a flow
+ *
+ * @param[in] phase - 's' to start the flow, 't' for each further step
+ * @param[in] id - flow identifier, unique in the trace
+ * @param[in] pName - flow name
+ * @param[in] timeNs - CLOCK_MONOTONIC time inside the slice to bind
+ */
+void test_trace_flow(char phase, uint64_t id, const char *pName, uint64_t timeNs);
+
+#endif /* TEST_TRACE_H */
@@ -0,0 +1,519 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file mta_hal_diff.c
+* @page mta_hal_diff Differential Testing of Two HAL Backends
+*
+* ## Module's Role
+* mta_hal_diff loads two builds of libhal_mta.so side by side, a vendor library and the replay backend,
+* two vendor releases, or the skeleton and a new implementation, and runs the same sequence of calls
+* against both:
+*
+*     mta_hal_diff [-n iterations] [-s sequence] [-i field]... [-m max] libA.so libB.so
+*
+* Each call is made on A and on B with identical arguments, alternating which backend goes first. The
+* return codes are compared, and when both succeed every output is compared field by field with
+* test_record_compare(): integers by value, character arrays as text, returned lists entry by entry.
+* The latency of each call is recorded per API and backend, and a side by side table ends the run.
+*
+* The sequence file holds one call per line, "api [value]", where value is given to every scalar
+* argument (index, line number, array size) and defaults to 0; "#" starts a comment. Without a file
+* every API that only reads state (test_record_api_is_query()) is called with 0. APIs that take an
+* input buffer cannot be called, they change the state of the device.
+*
+* Fields differing by nature between two runs, such as lease timers, are excluded with -i, naming the
+* field ("LeaseTimeRemaining") or the argument ("pulCount"). The exit status is 1 when any call differs.
+*
+* The libraries are loaded with RTLD_LOCAL, and must have different paths: a path already loaded is
+* not loaded twice. Two replay backends read the same MTA_HAL_REPLAY_FILE.
+*/
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mta_hal.h"
+#include "test_histogram.h"
+#include "test_probe.h"
+#include "test_record.h"
+
+#define DIFF_BACKENDS           (2)
+#define DIFF_LINE_SIZE          (256)
+#define DIFF_MAX_IGNORED        (32)
+#define DIFF_DEFAULT_ITERATIONS (100)
+#define DIFF_DEFAULT_REPORTED   (10)        /*!< Differences printed per API */
+#define DIFF_SIMILAR_PERCENT    (5.0)       /*!< Median latencies closer than this are reported as similar */
+
+typedef int64_t (*diff_caller_fn_t)(void *pFunction, const uintptr_t *pArgs, uint64_t *pLatencyNs);
+
+typedef struct
+{
+    int api;
+    uint64_t value;
+} diff_step_t;
+
+typedef struct
+{
+    const char *pPath;
+    void *pHandle;
+    void *pFunctions[TEST_PROBE_API_COUNT];
+} diff_backend_t;
+
+typedef struct
+{
+    uint64_t calls;
+    uint64_t differences;       /*!< Calls with a different return code or output */
+    uint64_t reported;
+} diff_stats_t;
+
+/* Context of the difference callback of test_record_compare() */
+typedef struct
+{
+    int api;
+    uint64_t value;
+    int iteration;
+    int maxReported;
+    diff_stats_t *pStats;
+} diff_report_t;
+
+static diff_backend_t gBackends[DIFF_BACKENDS];
+static test_histogram_t gHistograms[DIFF_BACKENDS][TEST_PROBE_API_COUNT];
+static diff_stats_t gStats[TEST_PROBE_API_COUNT];
+
+static uint64_t diff_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * A caller per API, expanded from mta_hal_api_list.h: the parameters are declared as locals with their
+ * own types, assigned from the argument array, and the function is called through its real prototype.
+ */
+#define DIFF_CAT_EXPANDED(a, b)             a##b
+#define DIFF_CAT(a, b)                      DIFF_CAT_EXPANDED(a, b)
+/* The GNU comma elision of DIFF_COUNT_PREPEND drops the comma of an empty "()" list, counting 0 */
+#define DIFF_COUNT_PREPEND(...)             , ##__VA_ARGS__
+#define DIFF_COUNT_SELECT(unused, a, b, c, count, ...) count
+#define DIFF_COUNT_APPLY(...)               DIFF_COUNT_SELECT(__VA_ARGS__, 3, 2, 1, 0)
+#define DIFF_COUNT(arguments)               DIFF_COUNT_APPLY(0 DIFF_COUNT_PREPEND arguments)
+
+#define DIFF_DECLARE_0(...)
+#define DIFF_DECLARE_1(a)                   a;
+#define DIFF_DECLARE_2(a, b)                a; b;
+#define DIFF_DECLARE_3(a, b, c)             a; b; c;
+#define DIFF_DECLARE(parameters, arguments) DIFF_CAT(DIFF_DECLARE_, DIFF_COUNT(arguments)) parameters
+
+#define DIFF_ASSIGN_ONE(a, i)               a = (__typeof__(a))pArgs[i];
+#define DIFF_ASSIGN_0()                     (void)pArgs;
+#define DIFF_ASSIGN_1(a)                    DIFF_ASSIGN_ONE(a, 0)
+#define DIFF_ASSIGN_2(a, b)                 DIFF_ASSIGN_ONE(a, 0) DIFF_ASSIGN_ONE(b, 1)
+#define DIFF_ASSIGN_3(a, b, c)              DIFF_ASSIGN_ONE(a, 0) DIFF_ASSIGN_ONE(b, 1) DIFF_ASSIGN_ONE(c, 2)
+#define DIFF_ASSIGN(arguments)              DIFF_CAT(DIFF_ASSIGN_, DIFF_COUNT(arguments)) arguments
+
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    static int64_t diff_call_##name(void *pFunction, const uintptr_t *pArgs, uint64_t *pLatencyNs) \
+    { \
+        typedef returnType (*hal_fn_t) parameters; \
+        DIFF_DECLARE(parameters, arguments) \
+        returnType result; \
+        uint64_t startNs; \
+        DIFF_ASSIGN(arguments) \
+        startNs = diff_now_ns(); \
+        result = ((hal_fn_t)pFunction) arguments; \
+        *pLatencyNs = diff_now_ns() - startNs; \
+        return (int64_t)result; \
+    }
+/* The void APIs register callbacks, which cannot be compared */
+#define MTA_HAL_API_VOID(name, parameters, arguments)
+#include "mta_hal_api_list.h"
+
+static const diff_caller_fn_t gCallers[TEST_PROBE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) diff_call_##name,
+#define MTA_HAL_API_VOID(name, parameters, arguments) NULL,
+#include "mta_hal_api_list.h"
+};
+
+static void diff_usage(const char *pProgram)
+{
+    fprintf(stderr, "Usage: %s [options] libA.so libB.so\n"
+                    "  -n <count>   iterations of the sequence, default %d\n"
+                    "  -s <file>    sequence of calls, one \"api [value]\" per line, default every query API with 0\n"
+                    "  -i <field>   field or argument not compared, may be repeated\n"
+                    "  -m <count>   differences printed per API, default %d\n",
+            pProgram, DIFF_DEFAULT_ITERATIONS, DIFF_DEFAULT_REPORTED);
+}
+
+static int diff_open(diff_backend_t *pBackend, const char *pPath)
+{
+    const char *pName;
+    int flags = RTLD_NOW | RTLD_LOCAL;
+    int api;
+
+#ifdef RTLD_DEEPBIND
+    /* Calls a library makes to its own APIs stay within it */
+    flags |= RTLD_DEEPBIND;
+#endif
+    pBackend->pPath = pPath;
+    pBackend->pHandle = dlopen(pPath, flags);
+    if (pBackend->pHandle == NULL)
+    {
+        fprintf(stderr, "mta_hal_diff: %s\n", dlerror());
+        return -1;
+    }
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        pName = test_record_api_name(api);
+        pBackend->pFunctions[api] = dlsym(pBackend->pHandle, pName);
+    }
+    return 0;
+}
+
+static int diff_find_api(const char *pName)
+{
+    int api;
+
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        if (strcmp(test_record_api_name(api), pName) == 0)
+        {
+            return api;
+        }
+    }
+    return TEST_PROBE_API_NONE;
+}
+
+/* Whether both backends can run an API, printing why not otherwise */
+static bool diff_callable(int api, bool quiet)
+{
+    uintptr_t args[TEST_RECORD_MAX_ARGS + 1];
+    int backend;
+
+    if (gCallers[api] == NULL)
+    {
+        if (quiet == false)
+        {
+            fprintf(stderr, "mta_hal_diff: %s registers a callback, skipped\n", test_record_api_name(api));
+        }
+        return false;
+    }
+    if (test_record_args_alloc(api, 0, args) != 0)
+    {
+        if (quiet == false)
+        {
+            fprintf(stderr, "mta_hal_diff: %s takes an input buffer, skipped\n", test_record_api_name(api));
+        }
+        return false;
+    }
+    test_record_args_free(api, args);
+    for (backend = 0; backend < DIFF_BACKENDS; backend++)
+    {
+        if (gBackends[backend].pFunctions[api] == NULL)
+        {
+            fprintf(stderr, "mta_hal_diff: %s not found in %s, skipped\n", test_record_api_name(api), gBackends[backend].pPath);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int diff_load_sequence(const char *pPath, diff_step_t **ppSteps, int *pNumSteps)
+{
+    char line[DIFF_LINE_SIZE];
+    char name[DIFF_LINE_SIZE];
+    unsigned long long value;
+    diff_step_t *pSteps = NULL;
+    diff_step_t *pGrown;
+    FILE *pFile;
+    char *pComment;
+    int numSteps = 0;
+    int lineNumber = 0;
+    int fields;
+    int api;
+
+    pFile = fopen(pPath, "r");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "mta_hal_diff: cannot read %s\n", pPath);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), pFile) != NULL)
+    {
+        lineNumber++;
+        pComment = strchr(line, '#');
+        if (pComment != NULL)
+        {
+            *pComment = '\0';
+        }
+        value = 0;
+        fields = sscanf(line, "%255s %llu", name, &value);
+        if (fields < 1)
+        {
+            continue;
+        }
+        api = diff_find_api(name);
+        if (api == TEST_PROBE_API_NONE)
+        {
+            fprintf(stderr, "mta_hal_diff: %s:%d: unknown API %s\n", pPath, lineNumber, name);
+            continue;
+        }
+        if (diff_callable(api, false) == false)
+        {
+            continue;
+        }
+        pGrown = realloc(pSteps, sizeof(diff_step_t) * (size_t)(numSteps + 1));
+        if (pGrown == NULL)
+        {
+            break;
+        }
+        pSteps = pGrown;
+        pSteps[numSteps].api = api;
+        pSteps[numSteps].value = value;
+        numSteps++;
+    }
+    fclose(pFile);
+    *ppSteps = pSteps;
+    *pNumSteps = numSteps;
+    return 0;
+}
+
+static int diff_default_sequence(diff_step_t **ppSteps, int *pNumSteps)
+{
+    diff_step_t *pSteps = calloc(TEST_PROBE_API_COUNT, sizeof(diff_step_t));
+    int numSteps = 0;
+    int api;
+
+    if (pSteps == NULL)
+    {
+        return -1;
+    }
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        if ((test_record_api_is_query(api) == true) && (diff_callable(api, true) == true))
+        {
+            pSteps[numSteps].api = api;
+            pSteps[numSteps].value = 0;
+            numSteps++;
+        }
+    }
+    *ppSteps = pSteps;
+    *pNumSteps = numSteps;
+    return 0;
+}
+
+static void diff_report(void *pContext, const char *pPath, const char *pLeft, const char *pRight)
+{
+    diff_report_t *pReport = (diff_report_t *)pContext;
+
+    if (pReport->pStats->reported >= (uint64_t)pReport->maxReported)
+    {
+        return;
+    }
+    pReport->pStats->reported++;
+    printf("DIFF %s(%llu) iteration %d: %s: A %s, B %s\n", test_record_api_name(pReport->api), (unsigned long long)pReport->value,
+           pReport->iteration, pPath, pLeft, pRight);
+}
+
+static void diff_step(const diff_step_t *pStep, int iteration, const char *const *pIgnored, int numIgnored, int maxReported)
+{
+    uintptr_t args[DIFF_BACKENDS][TEST_RECORD_MAX_ARGS + 1];
+    diff_report_t report = { pStep->api, pStep->value, iteration, maxReported, &gStats[pStep->api] };
+    char results[DIFF_BACKENDS][24];
+    int64_t result[DIFF_BACKENDS];
+    uint64_t latencyNs;
+    int differences = 0;
+    int backend;
+    int i;
+
+    for (backend = 0; backend < DIFF_BACKENDS; backend++)
+    {
+        if (test_record_args_alloc(pStep->api, pStep->value, args[backend]) != 0)
+        {
+            fprintf(stderr, "mta_hal_diff: out of memory\n");
+            exit(2);
+        }
+    }
+    /* Alternate the first backend, so that neither always runs on a warm cache */
+    for (i = 0; i < DIFF_BACKENDS; i++)
+    {
+        backend = (i + iteration) % DIFF_BACKENDS;
+        result[backend] = gCallers[pStep->api](gBackends[backend].pFunctions[pStep->api], args[backend], &latencyNs);
+        test_histogram_record(&gHistograms[backend][pStep->api], latencyNs);
+    }
+
+    if (result[0] != result[1])
+    {
+        snprintf(results[0], sizeof(results[0]), "%lld", (long long)result[0]);
+        snprintf(results[1], sizeof(results[1]), "%lld", (long long)result[1]);
+        diff_report(&report, "return", results[0], results[1]);
+        differences++;
+    }
+    else if (result[0] == RETURN_OK)
+    {
+        /* Outputs are only defined on success */
+        differences += test_record_compare(pStep->api, args[0], args[1], pIgnored, numIgnored, diff_report, &report);
+    }
+    gStats[pStep->api].calls++;
+    if (differences > 0)
+    {
+        gStats[pStep->api].differences++;
+    }
+    for (backend = 0; backend < DIFF_BACKENDS; backend++)
+    {
+        test_record_args_free(pStep->api, args[backend]);
+    }
+}
+
+static void diff_summary(void)
+{
+    const test_histogram_t *pA;
+    const test_histogram_t *pB;
+    uint64_t medianA;
+    uint64_t medianB;
+    double change;
+    const char *pVerdict;
+    int api;
+
+    printf("\n%-40s %8s %8s %10s %10s %10s %10s %10s %10s %8s\n", "API", "calls", "differ", "A mean us", "A p50 us", "A p99 us",
+           "B mean us", "B p50 us", "B p99 us", "B/A p50");
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        if (gStats[api].calls == 0)
+        {
+            continue;
+        }
+        pA = &gHistograms[0][api];
+        pB = &gHistograms[1][api];
+        medianA = test_histogram_percentile(pA, 50.0);
+        medianB = test_histogram_percentile(pB, 50.0);
+        change = (medianA > 0) ? (((double)medianB / (double)medianA) - 1.0) * 100.0 : 0.0;
+        pVerdict = "similar";
+        if (change > DIFF_SIMILAR_PERCENT)
+        {
+            pVerdict = "B slower";
+        }
+        else if (change < -DIFF_SIMILAR_PERCENT)
+        {
+            pVerdict = "B faster";
+        }
+        printf("%-40s %8llu %8llu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %8.2f %s\n", test_record_api_name(api),
+               (unsigned long long)gStats[api].calls, (unsigned long long)gStats[api].differences,
+               (double)pA->sumNs / 1000.0 / (double)pA->count, (double)medianA / 1000.0,
+               (double)test_histogram_percentile(pA, 99.0) / 1000.0,
+               (double)pB->sumNs / 1000.0 / (double)pB->count, (double)medianB / 1000.0,
+               (double)test_histogram_percentile(pB, 99.0) / 1000.0,
+               (medianA > 0) ? ((double)medianB / (double)medianA) : 0.0, pVerdict);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *pIgnored[DIFF_MAX_IGNORED];
+    const char *pSequencePath = NULL;
+    diff_step_t *pSteps = NULL;
+    uint64_t differences = 0;
+    int iterations = DIFF_DEFAULT_ITERATIONS;
+    int maxReported = DIFF_DEFAULT_REPORTED;
+    int numIgnored = 0;
+    int numSteps = 0;
+    int iteration;
+    int option;
+    int step;
+    int api;
+
+    while ((option = getopt(argc, argv, "n:s:i:m:h")) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+            case 's':
+                pSequencePath = optarg;
+                break;
+            case 'i':
+                if (numIgnored == DIFF_MAX_IGNORED)
+                {
+                    fprintf(stderr, "mta_hal_diff: at most %d -i options\n", DIFF_MAX_IGNORED);
+                    return 2;
+                }
+                pIgnored[numIgnored++] = optarg;
+                break;
+            case 'm':
+                maxReported = atoi(optarg);
+                break;
+            default:
+                diff_usage(argv[0]);
+                return 2;
+        }
+    }
+    if (((argc - optind) != DIFF_BACKENDS) || (iterations <= 0))
+    {
+        diff_usage(argv[0]);
+        return 2;
+    }
+    if ((diff_open(&gBackends[0], argv[optind]) != 0) || (diff_open(&gBackends[1], argv[optind + 1]) != 0))
+    {
+        return 2;
+    }
+    if (gBackends[0].pHandle == gBackends[1].pHandle)
+    {
+        fprintf(stderr, "mta_hal_diff: %s and %s are the same library, copy one to another path\n", argv[optind], argv[optind + 1]);
+        return 2;
+    }
+
+    if (((pSequencePath != NULL) ? diff_load_sequence(pSequencePath, &pSteps, &numSteps) : diff_default_sequence(&pSteps, &numSteps)) != 0)
+    {
+        return 2;
+    }
+    if (numSteps == 0)
+    {
+        fprintf(stderr, "mta_hal_diff: no call to run\n");
+        free(pSteps);
+        return 2;
+    }
+    printf("A: %s\nB: %s\n%d calls, %d iterations\n\n", gBackends[0].pPath, gBackends[1].pPath, numSteps, iterations);
+
+    for (iteration = 0; iteration < iterations; iteration++)
+    {
+        for (step = 0; step < numSteps; step++)
+        {
+            diff_step(&pSteps[step], iteration, pIgnored, numIgnored, maxReported);
+        }
+    }
+    diff_summary();
+
+    for (api = 0; api < TEST_PROBE_API_COUNT; api++)
+    {
+        differences += gStats[api].differences;
+    }
+    printf("\n%llu of %llu calls differ\n", (unsigned long long)differences, (unsigned long long)numSteps * (unsigned long long)iterations);
+    free(pSteps);
+    return (differences > 0) ? 1 : 0;
+}
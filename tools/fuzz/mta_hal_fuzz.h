@@ -0,0 +1,66 @@
+/*
+* If not stated otherwise in this file or this component's LICENSE file the
+* following copyright and licenses apply:*
+* Copyright 2023 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/**
+* @file mta_hal_fuzz.h
+*
+* Entry points shared by the fuzz targets of tools/fuzz and the engine running them: libFuzzer when built
+* with clang, mta_hal_fuzz_main.c otherwise.
+*
+* A target reports a broken contract with mta_hal_fuzz_fail(), which aborts so that the engine keeps the
+* input as a crash, the same way AddressSanitizer reports a buffer overflow.
+*/
+
+#ifndef MTA_HAL_FUZZ_H
+#define MTA_HAL_FUZZ_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Called once by the engine before the first input
+ */
+int LLVMFuzzerInitialize(int *pArgc, char ***pArgv);
+
+/**
+ * @brief Run one input
+ *
+ * @return int - 0, the input is kept in the corpus if it reached new code
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *pData, size_t size);
+
+/**
+ * @brief Report a broken contract of the HAL and abort
+ */
+static void mta_hal_fuzz_fail(const char *pFormat, ...) __attribute__((noreturn, format(printf, 1, 2), unused));
+static void mta_hal_fuzz_fail(const char *pFormat, ...)
+{
+    va_list args;
+
+    va_start(args, pFormat);
+    fprintf(stderr, "mta_hal_fuzz: ");
+    vfprintf(stderr, pFormat, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    abort();
+}
+
+#endif /* MTA_HAL_FUZZ_H */
@@ -0,0 +1,210 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file mta_hal_fuzz_buffers.c
+* @page mta_hal_fuzz_buffers Fuzz Targets of the String and Buffer APIs
+*
+* ## Module's Role
+* Fuzz targets of the APIs exchanging character buffers with the caller. Each API is a target of its
+* own, the file is built once per API with MTA_HAL_FUZZ_API naming it (make fuzz):
+*
+* | API | Input | Buffer given to the API |
+* | :---- | :---- | :---- |
+* | mta_hal_SetDectPIN | the PIN | a copy of the input, terminated, allocated to its exact length |
+* | mta_hal_GetDectPIN | initial contents of the buffer | FUZZ_PIN_SIZE bytes, not terminated |
+* | mta_hal_BatteryGetPowerStatus, GetCondition, GetStatus, GetLife | 2 bytes of initial *len (little endian), then the initial contents | FUZZ_VALUE_SIZE bytes, not terminated |
+*
+* Buffers are allocated to the size the caller declares, or for the (Val, len) APIs, where len is an
+* output only, to the size the tests pass, so that AddressSanitizer reports any byte written or read
+* beyond it. The contents are the bytes of the input, without a terminator, as an agent reusing a buffer
+* would pass them, and the initial *len is whatever the input holds. Besides memory errors, the targets
+* abort on:
+* - a return value other than RETURN_OK or RETURN_ERR
+* - mta_hal_SetDectPIN modifying the caller's string
+* - a buffer returned with RETURN_OK and no terminator within its capacity
+* - *len returned other than the length of the string returned
+*
+* The seeds of each target are in tools/fuzz/corpus/<API>. tools/fuzz/run_fuzz.sh runs every target and
+* reports the executions per second of each.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "mta_hal.h"
+#include "mta_hal_fuzz.h"
+
+#ifndef MTA_HAL_FUZZ_API
+#error "MTA_HAL_FUZZ_API must name the API to fuzz, e.g. -DMTA_HAL_FUZZ_API=\"mta_hal_SetDectPIN\""
+#endif
+
+#define FUZZ_PIN_SIZE           (64)        /*!< Buffer of mta_hal_GetDectPIN, as the tests pass it */
+#define FUZZ_VALUE_SIZE         (64)        /*!< Buffer of the (Val, len) APIs, len is not its capacity */
+
+typedef INT (*fuzz_string_fn_t)(char *pString);
+typedef INT (*fuzz_string_len_fn_t)(CHAR *pValue, ULONG *pLength);
+
+typedef struct
+{
+    const char *pName;
+    void (*run)(const void *pFunction, const uint8_t *pData, size_t size);
+    const void *pFunction;
+} fuzz_target_t;
+
+static const fuzz_target_t *gTarget = NULL;
+
+static void fuzz_check_result(INT result)
+{
+    if ((result != RETURN_OK) && (result != RETURN_ERR))
+    {
+        mta_hal_fuzz_fail("%s returned %d", gTarget->pName, result);
+    }
+}
+
+static void fuzz_set_string(const void *pFunction, const uint8_t *pData, size_t size)
+{
+    char *pString;
+    char *pCopy;
+    INT result;
+
+    pString = malloc(size + 1);
+    pCopy = malloc(size + 1);
+    if ((pString == NULL) || (pCopy == NULL))
+    {
+        free(pString);
+        free(pCopy);
+        return;
+    }
+    memcpy(pString, pData, size);
+    pString[size] = '\0';
+    memcpy(pCopy, pString, size + 1);
+
+    result = ((fuzz_string_fn_t)pFunction)(pString);
+    fuzz_check_result(result);
+    if (memcmp(pString, pCopy, size + 1) != 0)
+    {
+        mta_hal_fuzz_fail("%s modified the string of the caller", gTarget->pName);
+    }
+    free(pString);
+    free(pCopy);
+}
+
+static void fuzz_get_string(const void *pFunction, const uint8_t *pData, size_t size)
+{
+    char *pString;
+    INT result;
+
+    pString = malloc(FUZZ_PIN_SIZE);
+    if (pString == NULL)
+    {
+        return;
+    }
+    memset(pString, 0, FUZZ_PIN_SIZE);
+    memcpy(pString, pData, (size < FUZZ_PIN_SIZE) ? size : FUZZ_PIN_SIZE);
+
+    result = ((fuzz_string_fn_t)pFunction)(pString);
+    fuzz_check_result(result);
+    if ((result == RETURN_OK) && (memchr(pString, '\0', FUZZ_PIN_SIZE) == NULL))
+    {
+        mta_hal_fuzz_fail("%s returned a string of %d bytes without a terminator", gTarget->pName, FUZZ_PIN_SIZE);
+    }
+    free(pString);
+}
+
+static void fuzz_get_string_len(const void *pFunction, const uint8_t *pData, size_t size)
+{
+    CHAR *pValue;
+    ULONG length;
+    INT result;
+
+    if (size < 2)
+    {
+        return;
+    }
+    /* len is an output, its initial value must not matter to the HAL */
+    length = (ULONG)pData[0] | ((ULONG)pData[1] << 8);
+    pData += 2;
+    size -= 2;
+
+    pValue = malloc(FUZZ_VALUE_SIZE);
+    if (pValue == NULL)
+    {
+        return;
+    }
+    memset(pValue, 0, FUZZ_VALUE_SIZE);
+    memcpy(pValue, pData, (size < FUZZ_VALUE_SIZE) ? size : FUZZ_VALUE_SIZE);
+
+    result = ((fuzz_string_len_fn_t)pFunction)(pValue, &length);
+    fuzz_check_result(result);
+    if (result == RETURN_OK)
+    {
+        if (memchr(pValue, '\0', FUZZ_VALUE_SIZE) == NULL)
+        {
+            mta_hal_fuzz_fail("%s returned RETURN_OK without a terminator within %d bytes", gTarget->pName, FUZZ_VALUE_SIZE);
+        }
+        if (length != (ULONG)strlen(pValue))
+        {
+            mta_hal_fuzz_fail("%s returned *len %lu for a string of %lu characters", gTarget->pName, (unsigned long)length,
+                              (unsigned long)strlen(pValue));
+        }
+    }
+    free(pValue);
+}
+
+static const fuzz_target_t gTargets[] =
+{
+    { "mta_hal_SetDectPIN", fuzz_set_string, (const void *)mta_hal_SetDectPIN },
+    { "mta_hal_GetDectPIN", fuzz_get_string, (const void *)mta_hal_GetDectPIN },
+    { "mta_hal_BatteryGetPowerStatus", fuzz_get_string_len, (const void *)mta_hal_BatteryGetPowerStatus },
+    { "mta_hal_BatteryGetCondition", fuzz_get_string_len, (const void *)mta_hal_BatteryGetCondition },
+    { "mta_hal_BatteryGetStatus", fuzz_get_string_len, (const void *)mta_hal_BatteryGetStatus },
+    { "mta_hal_BatteryGetLife", fuzz_get_string_len, (const void *)mta_hal_BatteryGetLife },
+};
+
+int LLVMFuzzerInitialize(int *pArgc, char ***pArgv)
+{
+    size_t i;
+
+    (void)pArgc;
+    (void)pArgv;
+    for (i = 0; i < sizeof(gTargets) / sizeof(gTargets[0]); i++)
+    {
+        if (strcmp(gTargets[i].pName, MTA_HAL_FUZZ_API) == 0)
+        {
+            gTarget = &gTargets[i];
+        }
+    }
+    if (gTarget == NULL)
+    {
+        mta_hal_fuzz_fail("%s is not a target of mta_hal_fuzz_buffers.c", MTA_HAL_FUZZ_API);
+    }
+    if (mta_hal_InitDB() != RETURN_OK)
+    {
+        mta_hal_fuzz_fail("mta_hal_InitDB failed");
+    }
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *pData, size_t size)
+{
+    gTarget->run(gTarget->pFunction, pData, size);
+    return 0;
+}
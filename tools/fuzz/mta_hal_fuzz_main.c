@@ -0,0 +1,196 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file mta_hal_fuzz_main.c
+* @page mta_hal_fuzz_main Corpus Replay Engine of the Fuzz Targets
+*
+* ## Module's Role
+* Engine of the fuzz targets for toolchains without libFuzzer, such as the gcc of a device SDK (make fuzz
+* FUZZ_ENGINE=replay). It does not mutate: the inputs given, files or directories of files, are run in turn
+* until -runs or -max_total_time is reached, at least once each:
+*
+*     mta_hal_SetDectPIN [-runs=N] [-max_total_time=S] tools/fuzz/corpus/mta_hal_SetDectPIN
+*
+* Other "-name=value" options of libFuzzer are accepted and ignored, so that tools/fuzz/run_fuzz.sh runs
+* both engines alike. The run ends with the "stat::" lines of libFuzzer's -print_final_stats=1.
+*
+* This regresses the checked in corpus and crash inputs on the device, with AddressSanitizer where the
+* toolchain has it.
+*/
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "mta_hal_fuzz.h"
+
+#define FUZZ_MAIN_PATH_SIZE     (4096)
+#define FUZZ_MAIN_MAX_INPUT     (1024 * 1024)
+
+typedef struct
+{
+    uint8_t *pData;
+    size_t size;
+} fuzz_input_t;
+
+static fuzz_input_t *gInputs = NULL;
+static size_t gNumInputs = 0;
+
+static uint64_t fuzz_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int fuzz_load_file(const char *pPath)
+{
+    fuzz_input_t *pInputs;
+    FILE *pFile;
+    uint8_t *pData;
+    size_t size;
+
+    pFile = fopen(pPath, "rb");
+    if (pFile == NULL)
+    {
+        fprintf(stderr, "mta_hal_fuzz: cannot open %s\n", pPath);
+        return -1;
+    }
+    pData = malloc(FUZZ_MAIN_MAX_INPUT);
+    pInputs = realloc(gInputs, (gNumInputs + 1) * sizeof(*gInputs));
+    if ((pData == NULL) || (pInputs == NULL))
+    {
+        free(pData);
+        fclose(pFile);
+        return -1;
+    }
+    gInputs = pInputs;
+    size = fread(pData, 1, FUZZ_MAIN_MAX_INPUT, pFile);
+    fclose(pFile);
+    /* Exactly the bytes read, so that AddressSanitizer reports a target reading beyond its input */
+    gInputs[gNumInputs].pData = realloc(pData, (size != 0) ? size : 1);
+    gInputs[gNumInputs].size = size;
+    gNumInputs++;
+    return 0;
+}
+
+static int fuzz_load(const char *pPath)
+{
+    char path[FUZZ_MAIN_PATH_SIZE];
+    struct dirent *pEntry;
+    struct stat status;
+    DIR *pDir;
+    int result = 0;
+
+    if (stat(pPath, &status) != 0)
+    {
+        fprintf(stderr, "mta_hal_fuzz: cannot open %s\n", pPath);
+        return -1;
+    }
+    if (S_ISDIR(status.st_mode) == 0)
+    {
+        return fuzz_load_file(pPath);
+    }
+    pDir = opendir(pPath);
+    if (pDir == NULL)
+    {
+        return -1;
+    }
+    while ((pEntry = readdir(pDir)) != NULL)
+    {
+        snprintf(path, sizeof(path), "%s/%s", pPath, pEntry->d_name);
+        if ((pEntry->d_name[0] == '.') || (stat(path, &status) != 0) || (S_ISREG(status.st_mode) == 0))
+        {
+            continue;
+        }
+        if (fuzz_load_file(path) != 0)
+        {
+            result = -1;
+        }
+    }
+    closedir(pDir);
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t maxRuns = 0;
+    uint64_t maxNs = 0;
+    uint64_t startNs;
+    uint64_t elapsedNs;
+    uint64_t runs = 0;
+    size_t i;
+    int arg;
+
+    LLVMFuzzerInitialize(&argc, &argv);
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (strncmp(argv[arg], "-runs=", strlen("-runs=")) == 0)
+        {
+            maxRuns = strtoull(argv[arg] + strlen("-runs="), NULL, 0);
+        }
+        else if (strncmp(argv[arg], "-max_total_time=", strlen("-max_total_time=")) == 0)
+        {
+            maxNs = strtoull(argv[arg] + strlen("-max_total_time="), NULL, 0) * 1000000000ULL;
+        }
+        else if (argv[arg][0] == '-')
+        {
+            continue;
+        }
+        else if (fuzz_load(argv[arg]) != 0)
+        {
+            return 1;
+        }
+    }
+    if (gNumInputs == 0)
+    {
+        fprintf(stderr, "Usage: %s [-runs=N] [-max_total_time=S] input|directory...\n", argv[0]);
+        return 1;
+    }
+
+    startNs = fuzz_now_ns();
+    do
+    {
+        for (i = 0; i < gNumInputs; i++)
+        {
+            LLVMFuzzerTestOneInput(gInputs[i].pData, gInputs[i].size);
+            runs++;
+        }
+        elapsedNs = fuzz_now_ns() - startNs;
+    } while (((maxRuns != 0) && (runs < maxRuns)) || ((maxRuns == 0) && (elapsedNs < maxNs)));
+
+    printf("Done %llu runs in %llu second(s)\n", (unsigned long long)runs, (unsigned long long)(elapsedNs / 1000000000ULL));
+    printf("stat::number_of_executed_units: %llu\n", (unsigned long long)runs);
+    printf("stat::average_exec_per_sec:     %llu\n",
+           (unsigned long long)((elapsedNs != 0) ? ((runs * 1000000000ULL) / elapsedNs) : runs));
+    printf("stat::new_units_added:          0\n");
+    for (i = 0; i < gNumInputs; i++)
+    {
+        free(gInputs[i].pData);
+    }
+    free(gInputs);
+    return 0;
+}
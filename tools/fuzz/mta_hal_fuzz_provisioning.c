@@ -0,0 +1,355 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file mta_hal_fuzz_provisioning.c
+* @page mta_hal_fuzz_provisioning Structure Aware Fuzz Target of mta_hal_start_provisioning
+*
+* ## Module's Role
+* Fuzz target of mta_hal_start_provisioning(). The input is not copied into MTAMGMT_MTA_PROVISIONING_PARAMS
+* as raw bytes: it is read as a sequence of choices building a parameter set, so that every input is a
+* plausible one and mutations move between the shapes a field can take. Each option field takes one of
+* these shapes, its bytes drawn from the input:
+*
+* | Shape | Contents |
+* | :---- | :---- |
+* | FUZZ_SHAPE_ZERO | all zeros |
+* | FUZZ_SHAPE_BYTES | a length, then that many bytes, zero padded |
+* | FUZZ_SHAPE_FULL | the whole field, without a terminator |
+* | FUZZ_SHAPE_ONES | all 0xFF |
+* | FUZZ_SHAPE_TEXT | printable characters, terminated |
+* | FUZZ_SHAPE_IPV4 | an IPv4 address in network order, as option 122 carries it |
+*
+* MtaIPMode is one of the three modes for most inputs, and any 32 bit value for the others.
+*
+* When the call succeeds, mta_hal_getMtaOperationalStatus() is polled until a final state (MTA_COMPLETE,
+* MTA_ERROR or MTA_REJECTED). The time from the call to the final state is recorded, and the target
+* aborts, keeping the input, when:
+* - the final state takes longer than MTA_HAL_FUZZ_SLOW_MS (default 1000 ms), a pathologically slow input
+* - no final state is reached within MTA_HAL_FUZZ_HANG_MS (default 10000 ms), a hang
+* - a MtaIPMode out of MTAMGMT_MTA_IP_MODE is accepted, or a status is out of MTAMGMT_MTA_STATUS
+*
+* Polls are MTA_HAL_FUZZ_POLL_MS (default 1 ms) apart. A call blocking in the HAL is caught by the -timeout
+* of libFuzzer. At exit, the accepted and rejected inputs, the final states reached and the distribution
+* of the time to the final state are printed, with the parameters of the slowest input.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mta_hal.h"
+#include "mta_hal_fuzz.h"
+#include "test_histogram.h"
+
+#define FUZZ_DEFAULT_SLOW_MS        (1000)
+#define FUZZ_DEFAULT_HANG_MS        (10000)
+#define FUZZ_DEFAULT_POLL_MS        (1)
+#define FUZZ_VALID_MODE_LIMIT       (240)       /*!< Mode bytes below select a valid MtaIPMode, above any value */
+#define FUZZ_STATUS_COUNT           (MTA_REJECTED + 1)
+
+typedef enum
+{
+    FUZZ_SHAPE_ZERO = 0,
+    FUZZ_SHAPE_BYTES,
+    FUZZ_SHAPE_FULL,
+    FUZZ_SHAPE_ONES,
+    FUZZ_SHAPE_TEXT,
+    FUZZ_SHAPE_IPV4,
+    FUZZ_SHAPE_COUNT
+} fuzz_shape_t;
+
+typedef struct
+{
+    const uint8_t *pData;
+    size_t size;
+} fuzz_reader_t;
+
+typedef struct
+{
+    const char *pName;
+    size_t offset;
+    size_t size;
+} fuzz_field_t;
+
+#define FUZZ_FIELD(member) { #member, offsetof(MTAMGMT_MTA_PROVISIONING_PARAMS, member), \
+                             sizeof(((MTAMGMT_MTA_PROVISIONING_PARAMS *)0)->member) }
+
+static const fuzz_field_t gFields[] =
+{
+    FUZZ_FIELD(DhcpOption122Suboption1),
+    FUZZ_FIELD(DhcpOption122Suboption2),
+    FUZZ_FIELD(DhcpOption2171CccV6DssID1),
+    FUZZ_FIELD(DhcpOption2171CccV6DssID2),
+};
+
+static const char *gStatusNames[FUZZ_STATUS_COUNT] = { "MTA_INIT", "MTA_START", "MTA_COMPLETE", "MTA_ERROR", "MTA_REJECTED" };
+
+static uint64_t gSlowNs;
+static uint64_t gHangNs;
+static uint64_t gPollNs;
+static uint64_t gAccepted;
+static uint64_t gRejected;
+static uint64_t gFinalStates[FUZZ_STATUS_COUNT];
+static test_histogram_t gFinalHistogram;
+static uint64_t gSlowestNs;
+static MTAMGMT_MTA_PROVISIONING_PARAMS gSlowest;
+
+static uint64_t fuzz_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t fuzz_env_ms(const char *pName, uint64_t defaultMs)
+{
+    const char *pValue = getenv(pName);
+
+    if ((pValue == NULL) || (*pValue == '\0'))
+    {
+        return defaultMs * 1000000ULL;
+    }
+    return strtoull(pValue, NULL, 0) * 1000000ULL;
+}
+
+/* 0 once the input is exhausted, so that every input builds a complete parameter set */
+static uint8_t fuzz_take(fuzz_reader_t *pReader)
+{
+    uint8_t value;
+
+    if (pReader->size == 0)
+    {
+        return 0;
+    }
+    value = *pReader->pData;
+    pReader->pData++;
+    pReader->size--;
+    return value;
+}
+
+static void fuzz_build_field(fuzz_reader_t *pReader, uint8_t *pField, size_t size)
+{
+    size_t length;
+    size_t i;
+
+    memset(pField, 0, size);
+    switch ((fuzz_shape_t)(fuzz_take(pReader) % FUZZ_SHAPE_COUNT))
+    {
+        case FUZZ_SHAPE_BYTES:
+            length = fuzz_take(pReader) % (size + 1);
+            for (i = 0; i < length; i++)
+            {
+                pField[i] = fuzz_take(pReader);
+            }
+            break;
+        case FUZZ_SHAPE_FULL:
+            for (i = 0; i < size; i++)
+            {
+                pField[i] = fuzz_take(pReader) | 0x01;
+            }
+            break;
+        case FUZZ_SHAPE_ONES:
+            memset(pField, 0xFF, size);
+            break;
+        case FUZZ_SHAPE_TEXT:
+            length = fuzz_take(pReader) % size;
+            for (i = 0; i < length; i++)
+            {
+                pField[i] = (uint8_t)(' ' + (fuzz_take(pReader) % ('~' - ' ' + 1)));
+            }
+            break;
+        case FUZZ_SHAPE_IPV4:
+            for (i = 0; (i < 4) && (i < size); i++)
+            {
+                pField[i] = fuzz_take(pReader);
+            }
+            break;
+        case FUZZ_SHAPE_ZERO:
+        default:
+            break;
+    }
+}
+
+static void fuzz_build(fuzz_reader_t *pReader, MTAMGMT_MTA_PROVISIONING_PARAMS *pParams)
+{
+    uint32_t mode;
+    size_t i;
+
+    memset(pParams, 0, sizeof(*pParams));
+    for (i = 0; i < sizeof(gFields) / sizeof(gFields[0]); i++)
+    {
+        fuzz_build_field(pReader, (uint8_t *)pParams + gFields[i].offset, gFields[i].size);
+    }
+    mode = fuzz_take(pReader);
+    if (mode < FUZZ_VALID_MODE_LIMIT)
+    {
+        pParams->MtaIPMode = (MTAMGMT_MTA_IP_MODE)(mode % (MTA_DUAL_STACK + 1));
+    }
+    else
+    {
+        /* One byte per statement, the order of evaluation of an expression is unspecified */
+        mode = 0;
+        for (i = 0; i < sizeof(mode); i++)
+        {
+            mode = (mode << 8) | fuzz_take(pReader);
+        }
+        pParams->MtaIPMode = (MTAMGMT_MTA_IP_MODE)mode;
+    }
+}
+
+static void fuzz_print_params(FILE *pFile, const MTAMGMT_MTA_PROVISIONING_PARAMS *pParams)
+{
+    const uint8_t *pField;
+    size_t i;
+    size_t j;
+
+    for (i = 0; i < sizeof(gFields) / sizeof(gFields[0]); i++)
+    {
+        pField = (const uint8_t *)pParams + gFields[i].offset;
+        fprintf(pFile, "  %-26s ", gFields[i].pName);
+        for (j = 0; j < gFields[i].size; j++)
+        {
+            fprintf(pFile, "%02x", pField[j]);
+        }
+        fprintf(pFile, "\n");
+    }
+    fprintf(pFile, "  %-26s %u\n", "MtaIPMode", (unsigned int)pParams->MtaIPMode);
+}
+
+static void fuzz_summary(void)
+{
+    int status;
+
+    fprintf(stderr, "mta_hal_start_provisioning: %llu accepted, %llu rejected\n", (unsigned long long)gAccepted,
+            (unsigned long long)gRejected);
+    for (status = 0; status < FUZZ_STATUS_COUNT; status++)
+    {
+        if (gFinalStates[status] != 0)
+        {
+            fprintf(stderr, "  final state %-12s %llu\n", gStatusNames[status], (unsigned long long)gFinalStates[status]);
+        }
+    }
+    if (gFinalHistogram.count == 0)
+    {
+        return;
+    }
+    fprintf(stderr, "  time to final state: median %llu us, 99%% %llu us, max %llu us\n",
+            (unsigned long long)(test_histogram_percentile(&gFinalHistogram, 50.0) / 1000ULL),
+            (unsigned long long)(test_histogram_percentile(&gFinalHistogram, 99.0) / 1000ULL),
+            (unsigned long long)(gFinalHistogram.maxNs / 1000ULL));
+    fprintf(stderr, "  slowest parameters (%llu us):\n", (unsigned long long)(gSlowestNs / 1000ULL));
+    fuzz_print_params(stderr, &gSlowest);
+}
+
+static void fuzz_fail_params(const MTAMGMT_MTA_PROVISIONING_PARAMS *pParams, const char *pReason, uint64_t valueNs)
+{
+    fprintf(stderr, "mta_hal_start_provisioning parameters:\n");
+    fuzz_print_params(stderr, pParams);
+    mta_hal_fuzz_fail("%s after %llu ms", pReason, (unsigned long long)(valueNs / 1000000ULL));
+}
+
+int LLVMFuzzerInitialize(int *pArgc, char ***pArgv)
+{
+    (void)pArgc;
+    (void)pArgv;
+    gSlowNs = fuzz_env_ms("MTA_HAL_FUZZ_SLOW_MS", FUZZ_DEFAULT_SLOW_MS);
+    gHangNs = fuzz_env_ms("MTA_HAL_FUZZ_HANG_MS", FUZZ_DEFAULT_HANG_MS);
+    gPollNs = fuzz_env_ms("MTA_HAL_FUZZ_POLL_MS", FUZZ_DEFAULT_POLL_MS);
+    if (mta_hal_InitDB() != RETURN_OK)
+    {
+        mta_hal_fuzz_fail("mta_hal_InitDB failed");
+    }
+    atexit(fuzz_summary);
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *pData, size_t size)
+{
+    MTAMGMT_MTA_PROVISIONING_PARAMS params;
+    MTAMGMT_MTA_STATUS status;
+    fuzz_reader_t reader = { pData, size };
+    struct timespec pause;
+    uint64_t startNs;
+    uint64_t elapsedNs;
+    INT result;
+
+    fuzz_build(&reader, &params);
+
+    startNs = fuzz_now_ns();
+    result = mta_hal_start_provisioning(&params);
+    if ((result != RETURN_OK) && (result != RETURN_ERR))
+    {
+        mta_hal_fuzz_fail("mta_hal_start_provisioning returned %d", result);
+    }
+    if (result == RETURN_ERR)
+    {
+        gRejected++;
+        return 0;
+    }
+    gAccepted++;
+    if ((unsigned int)params.MtaIPMode > (unsigned int)MTA_DUAL_STACK)
+    {
+        fuzz_fail_params(&params, "MtaIPMode out of MTAMGMT_MTA_IP_MODE accepted", fuzz_now_ns() - startNs);
+    }
+
+    pause.tv_sec = (time_t)(gPollNs / 1000000000ULL);
+    pause.tv_nsec = (long)(gPollNs % 1000000000ULL);
+    for (;;)
+    {
+        status = MTA_INIT;
+        result = mta_hal_getMtaOperationalStatus(&status);
+        elapsedNs = fuzz_now_ns() - startNs;
+        if (result != RETURN_OK)
+        {
+            fuzz_fail_params(&params, "mta_hal_getMtaOperationalStatus failed while provisioning", elapsedNs);
+        }
+        if ((unsigned int)status >= FUZZ_STATUS_COUNT)
+        {
+            fuzz_fail_params(&params, "operational status out of MTAMGMT_MTA_STATUS", elapsedNs);
+        }
+        if ((status == MTA_COMPLETE) || (status == MTA_ERROR) || (status == MTA_REJECTED))
+        {
+            break;
+        }
+        if (elapsedNs >= gHangNs)
+        {
+            fuzz_fail_params(&params, "no final provisioning state", elapsedNs);
+        }
+        nanosleep(&pause, NULL);
+    }
+
+    gFinalStates[status]++;
+    test_histogram_record(&gFinalHistogram, elapsedNs);
+    if (elapsedNs > gSlowestNs)
+    {
+        gSlowestNs = elapsedNs;
+        gSlowest = params;
+    }
+    if (elapsedNs > gSlowNs)
+    {
+        fuzz_fail_params(&params, "final provisioning state reached slowly", elapsedNs);
+    }
+    return 0;
+}
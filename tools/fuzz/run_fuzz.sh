@@ -0,0 +1,64 @@
+#!/bin/bash
+
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# *
+
+# Runs every fuzz target built by "make fuzz" for a while and reports its executions per second.
+#
+#   run_fuzz.sh [seconds per target] [target...]
+#
+# Each target starts from its seeds in tools/fuzz/corpus/<target>; the inputs it adds and the crashes it
+# finds are written under FUZZ_OUT (default /tmp/mta_hal_fuzz), the checked in corpus is not modified.
+# The exit status is 1 when a target crashed.
+
+ROOT_DIR="$(cd "$(dirname "$0")/../.." && pwd)"
+FUZZ_BIN="${FUZZ_BIN:-${ROOT_DIR}/bin/fuzz}"
+FUZZ_OUT="${FUZZ_OUT:-/tmp/mta_hal_fuzz}"
+SECONDS_PER_TARGET="${1:-60}"
+shift
+TARGETS="$@"
+if [ -z "${TARGETS}" ]; then
+    TARGETS=$(cd "${FUZZ_BIN}" 2>/dev/null && ls)
+fi
+if [ -z "${TARGETS}" ]; then
+    echo "No target in ${FUZZ_BIN}, run make fuzz first" >&2
+    exit 1
+fi
+
+export ASAN_OPTIONS="${ASAN_OPTIONS:-abort_on_error=1:detect_leaks=1}"
+status=0
+printf "%-34s %12s %10s %10s %s\n" "Target" "Runs" "Exec/s" "New units" "Result"
+for target in ${TARGETS}; do
+    mkdir -p "${FUZZ_OUT}/${target}/corpus"
+    log="${FUZZ_OUT}/${target}/fuzz.log"
+    "${FUZZ_BIN}/${target}" -max_total_time="${SECONDS_PER_TARGET}" -print_final_stats=1 \
+        -artifact_prefix="${FUZZ_OUT}/${target}/" "${FUZZ_OUT}/${target}/corpus" \
+        "${ROOT_DIR}/tools/fuzz/corpus/${target}" > "${log}" 2>&1
+    if [ $? -eq 0 ]; then
+        result="ok"
+    else
+        result="CRASH, see ${log}"
+        status=1
+    fi
+    runs=$(sed -n 's/^stat::number_of_executed_units: *//p' "${log}")
+    rate=$(sed -n 's/^stat::average_exec_per_sec: *//p' "${log}")
+    added=$(sed -n 's/^stat::new_units_added: *//p' "${log}")
+    printf "%-34s %12s %10s %10s %s\n" "${target}" "${runs:--}" "${rate:--}" "${added:--}" "${result}"
+done
+exit ${status}
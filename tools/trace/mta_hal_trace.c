@@ -0,0 +1,550 @@
+/*
+# *
+# * If not stated otherwise in this file or this component's LICENSE file the
+# * following copyright and licenses apply:
+# *
+# * Copyright 2023 RDK Management
+# *
+# * Licensed under the Apache License, Version 2.0 (the "License");
+# * you may not use this file except in compliance with the License.
+# * You may obtain a copy of the License at
+# *
+# * http://www.apache.org/licenses/LICENSE-2.0
+# *
+# * Unless required by applicable law or agreed to in writing, software
+# * distributed under the License is distributed on an "AS IS" BASIS,
+# * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# * See the License for the specific language governing permissions and
+# * limitations under the License.
+# */
+
+/**
+* @file mta_hal_trace.c
+* @page mta_hal_trace LD_PRELOAD Tracing Shim
+*
+* ## Module's Role
+* libmta_hal_trace.so interposes every API of src/mta_hal_api_list.h in any process linked against a
+* vendor libhal_mta, mta_hal_test built with TARGET=arm as well as the MTA agent or any other daemon:
+*
+*     LD_PRELOAD=/usr/lib/libmta_hal_trace.so CcspMtaAgentSsp ...
+*
+* Each call is forwarded to the next definition of the symbol, found with dlsym(RTLD_NEXT), and recorded
+* with its arguments, return code and latency. Scalar arguments are logged by value, pointers by address.
+* When the process exits a summary of the calls, errors and latency per API is appended. It is also
+* appended on SIGTERM, SIGINT and SIGHUP before the handler of the process, or the default action, runs,
+* and every MTA_HAL_TRACE_SUMMARY_SECONDS: a process killed with SIGKILL, or replacing the handlers of
+* the library with its own, leaves the last periodic summary. The last summary of a pid is the latest.
+*
+* Environment:
+* - MTA_HAL_TRACE_FILE - output file, "-" for stderr, default /tmp/mta_hal_trace.<pid>.log
+* - MTA_HAL_TRACE_CALLS - 0 records the summary only
+* - MTA_HAL_TRACE_HISTOGRAMS - file receiving a latency histogram per API (src/test_histogram.h) at exit
+*   and on SIGUSR1. A SIGUSR1 handler installed by the process before the library is still called.
+* - MTA_HAL_TRACE_SUMMARY_SECONDS - period of the summary while the process runs, default 0 for none
+*
+* A HAL compiled into the executable (the skeleton of the linux target) cannot be interposed, the
+* executable resolves its own definitions first.
+*/
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "mta_hal.h"
+#include "test_histogram.h"
+
+#define TRACE_LINE_SIZE         (512)
+#define TRACE_ARGS_SIZE         (256)
+#define TRACE_PATH_SIZE         (128)
+#define TRACE_NUMBER_SIZE       (24)
+
+enum
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) TRACE_ID_##name,
+#define MTA_HAL_API_VOID(name, parameters, arguments) TRACE_ID_##name,
+#include "mta_hal_api_list.h"
+    TRACE_API_COUNT
+};
+
+typedef struct
+{
+    volatile uint64_t calls;
+    volatile uint64_t errors;       /*!< Calls of an INT API that did not return RETURN_OK */
+    volatile uint64_t totalNs;
+    volatile uint64_t maxNs;
+} trace_stats_t;
+
+typedef enum
+{
+    TRACE_ARG_SIGNED = 0,
+    TRACE_ARG_UNSIGNED,
+    TRACE_ARG_POINTER
+} trace_arg_kind_t;
+
+typedef struct
+{
+    int api;
+    uint64_t enterNs;
+    int length;                     /*!< Characters written to args */
+    char args[TRACE_ARGS_SIZE];
+} trace_call_t;
+
+static const char *gApiNames[TRACE_API_COUNT] =
+{
+#define MTA_HAL_API(returnType, name, parameters, arguments) #name,
+#define MTA_HAL_API_VOID(name, parameters, arguments) #name,
+#include "mta_hal_api_list.h"
+};
+
+static void *gpReal[TRACE_API_COUNT];
+static trace_stats_t gStats[TRACE_API_COUNT];
+
+static int gFd = -1;
+static bool gTraceCalls = true;
+
+static test_histogram_t gHistograms[TRACE_API_COUNT];
+static const char *gpHistogramPath;             /*!< NULL while histograms are off */
+static volatile sig_atomic_t gHistogramRequest;
+static struct sigaction gPreviousAction;        /*!< SIGUSR1 handler of the process */
+
+/* Signals ending the process by default, the summary is written before they are delivered on */
+static const int gExitSignals[] = { SIGTERM, SIGINT, SIGHUP };
+static struct sigaction gPreviousExitActions[sizeof(gExitSignals) / sizeof(gExitSignals[0])];
+
+static uint64_t gSummaryPeriodNs;               /*!< 0 while periodic summaries are off */
+static volatile uint64_t gNextSummaryNs;
+
+/* Nesting of HAL calls on this thread, a vendor library may call its own APIs through the PLT */
+static __thread int tDepth;
+
+static uint64_t trace_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* One write() per line, so that lines of concurrent threads and processes sharing the file never interleave */
+static void trace_write(const char *pFormat, ...)
+{
+    char line[TRACE_LINE_SIZE];
+    va_list args;
+    int length;
+
+    if (gFd < 0)
+    {
+        return;
+    }
+    va_start(args, pFormat);
+    length = vsnprintf(line, sizeof(line), pFormat, args);
+    va_end(args);
+    if (length >= (int)sizeof(line))
+    {
+        length = sizeof(line) - 1;
+        line[length - 1] = '\n';
+    }
+    if (length > 0)
+    {
+        (void)write(gFd, line, (size_t)length);
+    }
+}
+
+static void trace_histogram_signal(int signum, siginfo_t *pInfo, void *pContext)
+{
+    gHistogramRequest = 1;
+    if ((gPreviousAction.sa_flags & SA_SIGINFO) != 0)
+    {
+        gPreviousAction.sa_sigaction(signum, pInfo, pContext);
+    }
+    else if ((gPreviousAction.sa_handler != SIG_DFL) && (gPreviousAction.sa_handler != SIG_IGN))
+    {
+        gPreviousAction.sa_handler(signum);
+    }
+}
+
+static void trace_histograms_open(void)
+{
+    struct sigaction action;
+
+    gpHistogramPath = getenv("MTA_HAL_TRACE_HISTOGRAMS");
+    if ((gpHistogramPath == NULL) || (gpHistogramPath[0] == '\0'))
+    {
+        gpHistogramPath = NULL;
+        return;
+    }
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = trace_histogram_signal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, &gPreviousAction);
+}
+
+static void trace_histograms_write(void)
+{
+    if (test_histogram_dump(gpHistogramPath, gApiNames, gHistograms, TRACE_API_COUNT) != 0)
+    {
+        fprintf(stderr, "mta_hal_trace: cannot write %s\n", gpHistogramPath);
+    }
+}
+
+/* Append pText to pLine, padded to width characters, on the left when width is negative; async-signal-safe */
+static int trace_format_text(char *pLine, int length, const char *pText, int width)
+{
+    int textLength = (int)strlen(pText);
+    int padding = ((width < 0) ? -width : width) - textLength;
+
+    while ((width > 0) && (padding-- > 0) && (length < (TRACE_LINE_SIZE - 1)))
+    {
+        pLine[length++] = ' ';
+    }
+    while ((*pText != '\0') && (length < (TRACE_LINE_SIZE - 1)))
+    {
+        pLine[length++] = *pText++;
+    }
+    while ((width < 0) && (padding-- > 0) && (length < (TRACE_LINE_SIZE - 1)))
+    {
+        pLine[length++] = ' ';
+    }
+    return length;
+}
+
+/* Append value / 10^decimals with the given decimals, right aligned to width; async-signal-safe */
+static int trace_format_number(char *pLine, int length, unsigned long long value, int decimals, int width)
+{
+    char number[TRACE_NUMBER_SIZE];
+    int position = sizeof(number) - 1;
+    int digits = 0;
+
+    number[position] = '\0';
+    do
+    {
+        if ((decimals > 0) && (digits == decimals))
+        {
+            number[--position] = '.';
+        }
+        number[--position] = (char)('0' + (value % 10ULL));
+        value /= 10ULL;
+        digits++;
+    } while ((value != 0ULL) || (digits <= decimals));
+    return trace_format_text(pLine, length, &number[position], width);
+}
+
+/* Write the summary of the calls so far, with write() and no allocation so that a signal handler may call it */
+static void trace_summary_write(int signum)
+{
+    char line[TRACE_LINE_SIZE];
+    const trace_stats_t *pStats;
+    uint64_t calls;
+    int length;
+    int api;
+
+    if (gFd < 0)
+    {
+        return;
+    }
+    length = trace_format_text(line, 0, "# summary pid ", 0);
+    length = trace_format_number(line, length, (unsigned long long)getpid(), 0, 0);
+    if (signum != 0)
+    {
+        length = trace_format_text(line, length, " signal ", 0);
+        length = trace_format_number(line, length, (unsigned long long)signum, 0, 0);
+    }
+    line[length++] = '\n';
+    (void)write(gFd, line, (size_t)length);
+
+    length = trace_format_text(line, 0, "# ", 0);
+    length = trace_format_text(line, length, "api", -46);
+    length = trace_format_text(line, length, "calls", 11);
+    length = trace_format_text(line, length, "errors", 11);
+    length = trace_format_text(line, length, "mean us", 15);
+    length = trace_format_text(line, length, "max us", 13);
+    line[length++] = '\n';
+    (void)write(gFd, line, (size_t)length);
+
+    for (api = 0; api < TRACE_API_COUNT; api++)
+    {
+        pStats = &gStats[api];
+        calls = pStats->calls;
+        if (calls == 0)
+        {
+            continue;
+        }
+        length = trace_format_text(line, 0, "# ", 0);
+        length = trace_format_text(line, length, gApiNames[api], -46);
+        length = trace_format_number(line, length, (unsigned long long)calls, 0, 11);
+        length = trace_format_number(line, length, (unsigned long long)pStats->errors, 0, 11);
+        length = trace_format_number(line, length, (unsigned long long)(pStats->totalNs / calls), 3, 15);
+        length = trace_format_number(line, length, (unsigned long long)pStats->maxNs, 3, 13);
+        line[length++] = '\n';
+        (void)write(gFd, line, (size_t)length);
+    }
+}
+
+static void trace_exit_signal(int signum, siginfo_t *pInfo, void *pContext)
+{
+    const struct sigaction *pPrevious = NULL;
+    size_t index;
+
+    trace_summary_write(signum);
+    for (index = 0; index < (sizeof(gExitSignals) / sizeof(gExitSignals[0])); index++)
+    {
+        if (gExitSignals[index] == signum)
+        {
+            pPrevious = &gPreviousExitActions[index];
+        }
+    }
+    if (pPrevious == NULL)
+    {
+        return;
+    }
+    if ((pPrevious->sa_flags & SA_SIGINFO) != 0)
+    {
+        pPrevious->sa_sigaction(signum, pInfo, pContext);
+    }
+    else if (pPrevious->sa_handler == SIG_DFL)
+    {
+        /* Deliver the signal again with the default action, which ends the process */
+        sigaction(signum, pPrevious, NULL);
+        raise(signum);
+    }
+    else if (pPrevious->sa_handler != SIG_IGN)
+    {
+        pPrevious->sa_handler(signum);
+    }
+}
+
+static void trace_summary_open(void)
+{
+    struct sigaction action;
+    const char *pValue;
+    size_t index;
+
+    pValue = getenv("MTA_HAL_TRACE_SUMMARY_SECONDS");
+    if (pValue != NULL)
+    {
+        gSummaryPeriodNs = strtoull(pValue, NULL, 10) * 1000000000ULL;
+        gNextSummaryNs = trace_now_ns() + gSummaryPeriodNs;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = trace_exit_signal;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    for (index = 0; index < (sizeof(gExitSignals) / sizeof(gExitSignals[0])); index++)
+    {
+        sigaction(gExitSignals[index], &action, &gPreviousExitActions[index]);
+    }
+}
+
+/* Write the periodic summary once the period has elapsed, by the first thread to see it */
+static void trace_summary_poll(uint64_t nowNs)
+{
+    uint64_t next = gNextSummaryNs;
+
+    if ((gSummaryPeriodNs == 0) || (nowNs < next))
+    {
+        return;
+    }
+    if (__sync_bool_compare_and_swap(&gNextSummaryNs, next, nowNs + gSummaryPeriodNs) != 0)
+    {
+        trace_summary_write(0);
+    }
+}
+
+__attribute__((constructor)) static void trace_open(void)
+{
+    char path[TRACE_PATH_SIZE];
+    const char *pValue;
+
+    trace_histograms_open();
+    trace_summary_open();
+
+    pValue = getenv("MTA_HAL_TRACE_CALLS");
+    gTraceCalls = ((pValue == NULL) || (strcmp(pValue, "0") != 0));
+
+    pValue = getenv("MTA_HAL_TRACE_FILE");
+    if ((pValue != NULL) && (strcmp(pValue, "-") == 0))
+    {
+        gFd = STDERR_FILENO;
+        return;
+    }
+    if ((pValue == NULL) || (pValue[0] == '\0'))
+    {
+        snprintf(path, sizeof(path), "/tmp/mta_hal_trace.%d.log", (int)getpid());
+        pValue = path;
+    }
+    gFd = open(pValue, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (gFd < 0)
+    {
+        fprintf(stderr, "mta_hal_trace: cannot open %s, tracing disabled\n", pValue);
+    }
+}
+
+__attribute__((destructor)) static void trace_summary(void)
+{
+    if (gpHistogramPath != NULL)
+    {
+        trace_histograms_write();
+    }
+    trace_summary_write(0);
+    if ((gFd >= 0) && (gFd != STDERR_FILENO))
+    {
+        close(gFd);
+        gFd = -1;
+    }
+}
+
+static void *trace_resolve(int api)
+{
+    void *pReal = __atomic_load_n(&gpReal[api], __ATOMIC_ACQUIRE);
+
+    if (pReal == NULL)
+    {
+        pReal = dlsym(RTLD_NEXT, gApiNames[api]);
+        if (pReal == NULL)
+        {
+            /* Cannot happen for a symbol the process links against, unless the executable defines it */
+            fprintf(stderr, "mta_hal_trace: %s not found after libmta_hal_trace.so\n", gApiNames[api]);
+            abort();
+        }
+        __atomic_store_n(&gpReal[api], pReal, __ATOMIC_RELEASE);
+    }
+    return pReal;
+}
+
+static void trace_enter(trace_call_t *pCall, int api)
+{
+    pCall->api = api;
+    pCall->length = 0;
+    pCall->args[0] = '\0';
+    tDepth++;
+    pCall->enterNs = trace_now_ns();
+}
+
+static void trace_arg(trace_call_t *pCall, const char *pName, trace_arg_kind_t kind, unsigned long long value)
+{
+    int space = (int)sizeof(pCall->args) - pCall->length;
+    int length;
+
+    if (gTraceCalls == false)
+    {
+        return;
+    }
+    if (space <= 1)
+    {
+        return;
+    }
+    switch (kind)
+    {
+        case TRACE_ARG_SIGNED:
+            length = snprintf(&pCall->args[pCall->length], (size_t)space, "%s%s=%lld", (pCall->length > 0) ? ", " : "", pName, (long long)(intptr_t)value);
+            break;
+        case TRACE_ARG_UNSIGNED:
+            length = snprintf(&pCall->args[pCall->length], (size_t)space, "%s%s=%llu", (pCall->length > 0) ? ", " : "", pName, value);
+            break;
+        default:
+            length = snprintf(&pCall->args[pCall->length], (size_t)space, "%s%s=%#llx", (pCall->length > 0) ? ", " : "", pName, value);
+            break;
+    }
+    pCall->length += (length < space) ? length : (space - 1);
+}
+
+static void trace_exit(trace_call_t *pCall, bool hasResult, bool isError, long long result)
+{
+    uint64_t nowNs = trace_now_ns();
+    uint64_t elapsedNs = nowNs - pCall->enterNs;
+    trace_stats_t *pStats = &gStats[pCall->api];
+    uint64_t max;
+
+    tDepth--;
+    __sync_fetch_and_add(&pStats->calls, 1);
+    __sync_fetch_and_add(&pStats->totalNs, elapsedNs);
+    if (isError == true)
+    {
+        __sync_fetch_and_add(&pStats->errors, 1);
+    }
+    max = pStats->maxNs;
+    while ((elapsedNs > max) && (__sync_bool_compare_and_swap(&pStats->maxNs, max, elapsedNs) == 0))
+    {
+        max = pStats->maxNs;
+    }
+    if (gpHistogramPath != NULL)
+    {
+        test_histogram_record(&gHistograms[pCall->api], elapsedNs);
+        if (gHistogramRequest != 0)
+        {
+            gHistogramRequest = 0;
+            trace_histograms_write();
+        }
+    }
+    trace_summary_poll(nowNs);
+    if (gTraceCalls == false)
+    {
+        return;
+    }
+    if (hasResult == true)
+    {
+        trace_write("%llu.%06llu %ld %d %s(%s) = %lld in %.3f us\n",
+                    (unsigned long long)(pCall->enterNs / 1000000000ULL), (unsigned long long)((pCall->enterNs / 1000ULL) % 1000000ULL),
+                    (long)syscall(SYS_gettid), tDepth, gApiNames[pCall->api], pCall->args, result, (double)elapsedNs / 1000.0);
+    }
+    else
+    {
+        trace_write("%llu.%06llu %ld %d %s(%s) in %.3f us\n",
+                    (unsigned long long)(pCall->enterNs / 1000000000ULL), (unsigned long long)((pCall->enterNs / 1000ULL) % 1000000ULL),
+                    (long)syscall(SYS_gettid), tDepth, gApiNames[pCall->api], pCall->args, (double)elapsedNs / 1000.0);
+    }
+}
+
+/* Argument recording, expanded once per argument of the "arguments" list of mta_hal_api_list.h */
+#define TRACE_ARG_KIND(a) _Generic((a), \
+    char: TRACE_ARG_SIGNED, signed char: TRACE_ARG_SIGNED, int: TRACE_ARG_SIGNED, long: TRACE_ARG_SIGNED, \
+    unsigned char: TRACE_ARG_UNSIGNED, unsigned int: TRACE_ARG_UNSIGNED, unsigned long: TRACE_ARG_UNSIGNED, \
+    default: TRACE_ARG_POINTER)
+#define TRACE_ARG(pCall, a) trace_arg(pCall, #a, TRACE_ARG_KIND(a), (unsigned long long)(uintptr_t)(a))
+#define TRACE_ARGS_0(pCall)
+#define TRACE_ARGS_1(pCall, a) TRACE_ARG(pCall, a);
+#define TRACE_ARGS_2(pCall, a, b) TRACE_ARG(pCall, a); TRACE_ARG(pCall, b);
+#define TRACE_ARGS_3(pCall, a, b, c) TRACE_ARG(pCall, a); TRACE_ARG(pCall, b); TRACE_ARG(pCall, c);
+/* The GNU comma elision of TRACE_ARGS_PREPEND drops the comma of an empty "()" list, selecting TRACE_ARGS_0 */
+#define TRACE_ARGS_PREPEND(...) , ##__VA_ARGS__
+#define TRACE_ARGS_SELECT(pCall, a, b, c, selected, ...) selected
+#define TRACE_ARGS_APPLY(...) TRACE_ARGS_SELECT(__VA_ARGS__, TRACE_ARGS_3, TRACE_ARGS_2, TRACE_ARGS_1, TRACE_ARGS_0)(__VA_ARGS__)
+#define TRACE_ARGS(pCall, arguments) TRACE_ARGS_APPLY(pCall TRACE_ARGS_PREPEND arguments)
+
+/* The symbol is resolved before the call is timed, the dlsym() of a first call is not HAL latency */
+#define MTA_HAL_API(returnType, name, parameters, arguments) \
+    returnType name parameters \
+    { \
+        typedef returnType (*real_fn_t) parameters; \
+        real_fn_t pReal = (real_fn_t)trace_resolve(TRACE_ID_##name); \
+        trace_call_t call; \
+        returnType result; \
+        trace_enter(&call, TRACE_ID_##name); \
+        result = pReal arguments; \
+        TRACE_ARGS(&call, arguments) \
+        trace_exit(&call, true, _Generic(result, int: (result != RETURN_OK), default: false), (long long)result); \
+        return result; \
+    }
+#define MTA_HAL_API_VOID(name, parameters, arguments) \
+    void name parameters \
+    { \
+        typedef void (*real_fn_t) parameters; \
+        real_fn_t pReal = (real_fn_t)trace_resolve(TRACE_ID_##name); \
+        trace_call_t call; \
+        trace_enter(&call, TRACE_ID_##name); \
+        pReal arguments; \
+        TRACE_ARGS(&call, arguments) \
+        trace_exit(&call, false, false, 0); \
+    }
+#include "mta_hal_api_list.h"